@@ -0,0 +1,26 @@
+# - Try to find libzstd
+#  ZSTD_FOUND - system has libzstd
+#  ZSTD_INCLUDE_DIRS - the zstd include directory
+#  ZSTD_LIBRARIES - link these to use libzstd
+find_package(PkgConfig)
+pkg_check_modules(PC_ZSTD QUIET libzstd)
+
+FIND_PATH(ZSTD_INCLUDE_DIRS
+  NAMES zstd.h
+  HINTS ${PC_ZSTD_INCLUDEDIR} ${PC_ZSTD_INCLUDE_DIRS}
+  PATHS "${ZSTD_ROOT_DIR}/include" "$ENV{ZSTD_ROOT_DIR}/include"
+)
+
+find_library(ZSTD_LIBRARIES
+  NAMES zstd libzstd
+  HINTS ${PC_ZSTD_LIBDIR} ${PC_ZSTD_LIBRARY_DIRS}
+  PATHS "${ZSTD_ROOT_DIR}/lib" "$ENV{ZSTD_ROOT_DIR}/lib"
+)
+
+include(FindPackageHandleStandardArgs)
+# handle the QUIETLY and REQUIRED arguments and set ZSTD_FOUND to TRUE
+# if all listed variables are TRUE
+find_package_handle_standard_args(ZSTD  DEFAULT_MSG
+                                  ZSTD_LIBRARIES ZSTD_INCLUDE_DIRS)
+
+mark_as_advanced(ZSTD_INCLUDE_DIRS ZSTD_LIBRARIES)
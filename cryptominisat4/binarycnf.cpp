@@ -0,0 +1,161 @@
+/*****************************************************************************
+CryptoMiniSat -- Copyright (c) 2009 Mate Soos
+
+File under MIT licence.
+******************************************************************************/
+
+#include "binarycnf.h"
+
+using namespace BinaryCnf;
+
+BinaryCnfWriter::~BinaryCnfWriter()
+{
+    if (out != NULL)
+        fclose(out);
+}
+
+bool BinaryCnfWriter::open(const std::string& fname)
+{
+    out = fopen(fname.c_str(), "wb");
+    if (out == NULL)
+        return false;
+
+    //Placeholder, close() writes the real header
+    unsigned char header[headerSize];
+    memset(header, 0, headerSize);
+    write(header, headerSize);
+    return !failed;
+}
+
+void BinaryCnfWriter::write(const void* data, const size_t len)
+{
+    if (fwrite(data, 1, len, out) != len)
+        failed = true;
+    bytesWritten += len;
+}
+
+static void put_le(unsigned char* at, const uint64_t x, const unsigned bytes)
+{
+    for(unsigned i = 0; i < bytes; i++) {
+        at[i] = (unsigned char)(x >> (8*i));
+    }
+}
+
+void BinaryCnfWriter::start_section(const char newTag)
+{
+    if (tag != newTag || payload.size() >= sectionLimit) {
+        flush_section();
+        tag = newTag;
+    }
+}
+
+void BinaryCnfWriter::flush_section()
+{
+    if (tag == 0)
+        return;
+
+    std::vector<unsigned char> head;
+    head.push_back(tag);
+    std::vector<unsigned char> count;
+    put_varint(count, entries);
+    put_varint(head, count.size() + payload.size());
+    head.insert(head.end(), count.begin(), count.end());
+
+    write(head.data(), head.size());
+    write(payload.data(), payload.size());
+    payload.clear();
+    entries = 0;
+    tag = 0;
+}
+
+void BinaryCnfWriter::saw_var(const Var var)
+{
+    if ((uint64_t)var + 1 > numVars)
+        numVars = (uint64_t)var + 1;
+}
+
+void BinaryCnfWriter::put_lits(const std::vector<Lit>& lits)
+{
+    uint32_t prev = 0;
+    for(size_t i = 0; i < lits.size(); i++) {
+        if (i == 0) {
+            put_varint(payload, lits[i].toInt());
+        } else {
+            put_delta(payload, prev, lits[i].toInt());
+        }
+        prev = lits[i].toInt();
+        saw_var(lits[i].var());
+    }
+}
+
+void BinaryCnfWriter::add_clause(const std::vector<Lit>& lits)
+{
+    start_section('C');
+    put_varint(payload, lits.size());
+    put_lits(lits);
+    entries++;
+    numClauses++;
+}
+
+void BinaryCnfWriter::add_xor_clause(const std::vector<Var>& vars, const bool rhs)
+{
+    start_section('X');
+    put_varint(payload, ((uint64_t)vars.size() << 1) | (uint64_t)rhs);
+    for(size_t i = 0; i < vars.size(); i++) {
+        if (i == 0) {
+            put_varint(payload, vars[i]);
+        } else {
+            put_delta(payload, vars[i-1], vars[i]);
+        }
+        saw_var(vars[i]);
+    }
+    entries++;
+    numXors++;
+}
+
+void BinaryCnfWriter::add_solve(const std::vector<Lit>& assumps)
+{
+    //One solve per section, so it stays in place between the clauses
+    flush_section();
+    start_section('S');
+    put_varint(payload, assumps.size());
+    put_lits(assumps);
+    entries++;
+    flush_section();
+}
+
+void BinaryCnfWriter::add_new_var()
+{
+    start_section('V');
+    entries++;
+}
+
+bool BinaryCnfWriter::close()
+{
+    if (out == NULL)
+        return false;
+
+    flush_section();
+    start_section('E');
+    flush_section();
+
+    unsigned char header[headerSize];
+    memcpy(header, magic, sizeof(magic));
+    put_le(header + 8, version, 4);
+    put_le(header + 12, 0, 4);
+    put_le(header + 16, numVars, 8);
+    put_le(header + 24, numClauses, 8);
+    put_le(header + 32, numXors, 8);
+
+    if (fseek(out, 0, SEEK_SET) != 0) {
+        failed = true;
+    } else {
+        if (fwrite(header, 1, headerSize, out) != headerSize)
+            failed = true;
+    }
+    if (fclose(out) != 0)
+        failed = true;
+    out = NULL;
+
+    return !failed;
+}
@@ -0,0 +1,153 @@
+/*****************************************************************************
+CryptoMiniSat -- Copyright (c) 2009 Mate Soos
+
+File under MIT licence.
+******************************************************************************/
+
+#ifndef BINARYCNF_H
+#define BINARYCNF_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <iostream>
+#include "cryptominisat4/solvertypesmini.h"
+
+using namespace CMSat;
+
+/**
+@brief Compact binary CNF container, written by cnf2bin
+
+The header is 40 bytes, all numbers little-endian:
+- 8 bytes magic "CMSATCNF"
+- uint32 version, uint32 reserved (zero)
+- uint64 number of variables, of clauses, and of XOR clauses
+
+It is followed by sections, in the order of the original file. Each is a
+tag byte, then the length of the rest of the section and the number of
+entries in it, both as LEB128 varints:
+- 'C' clauses: each is its size, then its literals
+- 'X' XOR clauses: each is (size << 1 | rhs), then its variables
+- 'S' a "c Solver::solve( .. )" comment: the size, then the assumptions
+- 'V' "c Solver::new_var()" comments, the entry count is the number of them
+- 'E' end of file, no entries
+
+A list of literals (or variables) is stored as its first element, then the
+zigzag-encoded difference of each element from the one before it. Readers
+skip sections they do not know.
+*/
+namespace BinaryCnf {
+    static const char magic[8] = {'C','M','S','A','T','C','N','F'};
+    static const uint32_t version = 1;
+    static const size_t headerSize = 40;
+
+    inline bool is_binary(const char* data, size_t len)
+    {
+        return len >= sizeof(magic) && memcmp(data, magic, sizeof(magic)) == 0;
+    }
+
+    inline void put_varint(std::vector<unsigned char>& out, uint64_t x)
+    {
+        while (x >= 0x80) {
+            out.push_back((unsigned char)(x | 0x80));
+            x >>= 7;
+        }
+        out.push_back((unsigned char)x);
+    }
+
+    inline void put_delta(std::vector<unsigned char>& out, uint32_t prev, uint32_t x)
+    {
+        const int64_t d = (int64_t)x - (int64_t)prev;
+        put_varint(out, ((uint64_t)d << 1) ^ (uint64_t)(d >> 63));
+    }
+
+    ///Returns FALSE on truncated or over-long input
+    inline bool get_varint(const unsigned char*& p, const unsigned char* end, uint64_t& x)
+    {
+        x = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            if (p == end)
+                return false;
+            const unsigned char b = *p++;
+            x |= (uint64_t)(b & 0x7f) << shift;
+            if (!(b & 0x80))
+                return true;
+        }
+        return false;
+    }
+
+    inline bool get_delta(
+        const unsigned char*& p
+        , const unsigned char* end
+        , uint32_t prev
+        , uint32_t& x
+    ) {
+        uint64_t z;
+        if (!get_varint(p, end, z))
+            return false;
+        const int64_t v = (int64_t)prev + (int64_t)((z >> 1) ^ (0 - (z & 1)));
+        if (v < 0 || v > 0xffffffffLL)
+            return false;
+        x = (uint32_t)v;
+        return true;
+    }
+
+    inline uint64_t get_u64(const unsigned char* p)
+    {
+        uint64_t x = 0;
+        for (int i = 7; i >= 0; i--)
+            x = (x << 8) | p[i];
+        return x;
+    }
+}
+
+/**
+@brief Writes a binary CNF file, see BinaryCnf
+
+Entries are collected into sections of about a megabyte. The header is
+written last, once the counts are known, so the output must be seekable.
+*/
+class BinaryCnfWriter
+{
+public:
+    BinaryCnfWriter() {}
+    ~BinaryCnfWriter();
+    BinaryCnfWriter(const BinaryCnfWriter&) = delete;
+    BinaryCnfWriter& operator=(const BinaryCnfWriter&) = delete;
+
+    bool open(const std::string& fname);
+    void add_clause(const std::vector<Lit>& lits);
+    void add_xor_clause(const std::vector<Var>& vars, bool rhs);
+    void add_solve(const std::vector<Lit>& assumps);
+    void add_new_var();
+    bool close(); ///<Returns FALSE if writing failed
+
+    uint64_t get_num_vars() const { return numVars; }
+    uint64_t get_num_clauses() const { return numClauses; }
+    uint64_t get_num_xors() const { return numXors; }
+    uint64_t get_bytes_written() const { return bytesWritten; }
+
+private:
+    static const size_t sectionLimit = 1048576;
+
+    void start_section(char tag);
+    void flush_section();
+    void write(const void* data, size_t len);
+    void put_lits(const std::vector<Lit>& lits);
+    void saw_var(Var var);
+
+    FILE* out = NULL;
+    bool failed = false;
+    char tag = 0;
+    uint64_t entries = 0;
+    std::vector<unsigned char> payload;
+
+    uint64_t numVars = 0;
+    uint64_t numClauses = 0;
+    uint64_t numXors = 0;
+    uint64_t bytesWritten = 0;
+};
+
+#endif //BINARYCNF_H
@@ -109,6 +109,18 @@ void CleaningStats::print(const size_t nbReduceDB) const
         , (double)remain.glue/(double)remain.num
     );
 
+    //--> TIERS
+    printStatsLine("c mid tier demoted"
+        , midDemoted
+        , (double)midDemoted/(double)nbReduceDB
+        , "cls/clean"
+    );
+    printStatsLine("c tiers core/mid/local"
+        , numCore
+        , numMid
+        , numLocal
+    );
+
     cout << "c ------ CLEANING STATS END ---------" << endl;
 }
 
@@ -147,4 +159,12 @@ void CleaningStats::printShort() const
     << " T " << std::fixed << std::setprecision(2)
     << cpu_time
     << endl;
+
+    cout
+    << "c [DBclean]"
+    << " tiers core " << numCore
+    << " mid " << numMid
+    << " local " << numLocal
+    << " mid demoted " << midDemoted
+    << endl;
 }
@@ -80,6 +80,19 @@ struct ResolutionTypes
     T redL = 0;
 };
 
+/**
+@brief Tiers of the long redundant clause database
+
+Only the local tier is cleaned by Solver::reduceDB(). Clauses are promoted when
+their glue gets low enough, and mid tier clauses that are not used in conflict
+analysis for a while are demoted to the local tier.
+*/
+enum class RedTier : unsigned char {
+    core      ///<Never cleaned
+    , mid     ///<Kept while it is used
+    , local   ///<Cleaned at every reduceDB
+};
+
 struct ClauseStats
 {
     ClauseStats() :
@@ -95,7 +108,9 @@ struct ClauseStats
         , clause_looked_at(0)
         #endif
         , used_for_uip_creation(0)
+        , last_touched(0)
         , locked(false)
+        , tier(RedTier::local)
     {}
 
     uint64_t numPropAndConfl(const uint64_t confl_multiplier) const
@@ -130,7 +145,9 @@ struct ClauseStats
     uint64_t clause_looked_at; ///<Number of times the clause has been deferenced during propagation
     #endif
     uint32_t used_for_uip_creation; ///Number of times the claue was using during 1st UIP conflict generation
+    uint64_t last_touched; ///<Conflict number at which it was last used during conflict analysis
     bool locked;
+    RedTier tier;
 
     ///Number of resolutions it took to make the clause when it was
     ///originally learnt. Only makes sense for redundant clauses
@@ -168,7 +185,9 @@ struct ClauseStats
         ret.clause_looked_at = first.clause_looked_at + second.clause_looked_at;
         #endif
         ret.used_for_uip_creation = first.used_for_uip_creation + second.used_for_uip_creation;
+        ret.last_touched = std::max(first.last_touched, second.last_touched);
         ret.locked = first.locked | second.locked;
+        ret.tier = std::min(first.tier, second.tier);
 
         return ret;
     }
@@ -197,6 +216,10 @@ Literals are allocated by an external allocator that allocates enough space
 for the class that it can hold the literals as well. I.e. it malloc()-s
     sizeof(Clause)+LENGHT*sizeof(Lit)
 to hold the clause.
+
+Only what propagation needs is stored here. The ClauseStats, which are only
+looked at when the clause propagates, is in conflict or is cleaned, are kept
+by the ClauseAllocator, see ClauseAllocator::getStats()
 */
 class Clause
 {
@@ -208,6 +231,7 @@ protected:
     uint16_t isAsymmed:1;
     uint16_t occurLinked:1;
     uint32_t mySize;
+    uint32_t statsId; ///<Index of this clause's ClauseStats in the ClauseAllocator
 
 
     Lit* getData()
@@ -222,15 +246,13 @@ protected:
 
 public:
     CL_ABST_TYPE abst;
-    ClauseStats stats;
 
     template<class V>
-    Clause(const V& ps, const uint32_t _introduced_at_conflict)
+    Clause(const V& ps, const uint32_t _statsId)
     {
         //assert(ps.size() > 2);
 
-        stats.introduced_at_conflict = _introduced_at_conflict;
-        stats.glue = std::min<uint32_t>(stats.glue, ps.size());
+        statsId = _statsId;
         isFreed = false;
         mySize = ps.size();
         isRed = false;
@@ -310,9 +332,8 @@ public:
         isRed = false;
     }
 
-    void makeRed(const uint32_t newGlue)
+    void makeRed()
     {
-        stats.glue = newGlue;
         isRed = true;
     }
 
@@ -369,11 +390,6 @@ public:
         return isFreed;
     }
 
-    void combineStats(const ClauseStats& other)
-    {
-        stats = ClauseStats::combineStats(stats, other);
-    }
-
     void setAsymmed(bool asymmed)
     {
         isAsymmed = asymmed;
@@ -384,6 +400,11 @@ public:
         return isAsymmed;
     }
 
+    uint32_t getStatsId() const
+    {
+        return statsId;
+    }
+
     bool getOccurLinked() const
     {
         return occurLinked;
@@ -394,7 +415,7 @@ public:
         occurLinked = toset;
     }
 
-    void print_extra_stats() const
+    void print_extra_stats(const ClauseStats& stats) const
     {
         cout
         << "Clause size " << std::setw(4) << size();
@@ -458,16 +479,16 @@ struct ClauseUsageStats
         return *this;
     }
 
-    void addStat(const Clause& cl)
+    void addStat(const ClauseStats& stats)
     {
         num++;
-        sumProp += cl.stats.propagations_made;
-        sumConfl += cl.stats.conflicts_made;
+        sumProp += stats.propagations_made;
+        sumConfl += stats.conflicts_made;
         #ifdef STATS_NEEDED
-        sumLitVisited += cl.stats.visited_literals;
-        sumLookedAt += cl.stats.clause_looked_at;
+        sumLitVisited += stats.visited_literals;
+        sumLookedAt += stats.clause_looked_at;
         #endif
-        sumUsedUIP += cl.stats.used_for_uip_creation;
+        sumUsedUIP += stats.used_for_uip_creation;
     }
     void print() const;
 };
@@ -513,20 +534,20 @@ struct CleaningStats
         ResolutionTypes<uint64_t> resol;
         double   act = 0.0;
 
-        void incorporate(const Clause* cl)
+        void incorporate(const Clause* cl, const ClauseStats& stats)
         {
             num ++;
             lits += cl->size();
-            glue += cl->stats.glue;
-            act += cl->stats.activity;
-            numConfl += cl->stats.conflicts_made;
+            glue += stats.glue;
+            act += stats.activity;
+            numConfl += stats.conflicts_made;
             #ifdef STATS_NEEDED
-            numLitVisited += cl->stats.visited_literals;
-            numLookedAt += cl->stats.clause_looked_at;
+            numLitVisited += stats.visited_literals;
+            numLookedAt += stats.clause_looked_at;
             #endif
-            numProp += cl->stats.propagations_made;
-            resol += cl->stats.resolutions;
-            used_for_uip_creation += cl->stats.used_for_uip_creation;
+            numProp += stats.propagations_made;
+            resol += stats.resolutions;
+            used_for_uip_creation += stats.used_for_uip_creation;
         }
 
 
@@ -542,6 +563,12 @@ struct CleaningStats
         , sizeBasedClean(0)
         , propConflBasedClean(0)
         , actBasedClean(0)
+
+        //Tiers
+        , midDemoted(0)
+        , numCore(0)
+        , numMid(0)
+        , numLocal(0)
     {}
 
     CleaningStats& operator+=(const CleaningStats& other)
@@ -559,6 +586,12 @@ struct CleaningStats
         propConflBasedClean += other.propConflBasedClean;
         actBasedClean += other.actBasedClean;
 
+        //Tiers -- sizes are a snapshot, the latest is kept
+        midDemoted += other.midDemoted;
+        numCore = other.numCore;
+        numMid = other.numMid;
+        numLocal = other.numLocal;
+
         //Clause Cleaning data
         preRemove += other.preRemove;
         removed += other.removed;
@@ -586,6 +619,12 @@ struct CleaningStats
     size_t propConflBasedClean;
     size_t actBasedClean;
 
+    //Tiers
+    uint64_t midDemoted;
+    uint64_t numCore;
+    uint64_t numMid;
+    uint64_t numLocal;
+
     //Clause Cleaning
     Data removed;
     Data remain;
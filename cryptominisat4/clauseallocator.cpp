@@ -30,11 +30,13 @@
 #include "searcher.h"
 #include "time_mem.h"
 #include "simplifier.h"
-#include "completedetachreattacher.h"
 #ifdef USE_VALGRIND
 #include "valgrind/valgrind.h"
 #include "valgrind/memcheck.h"
 #endif
+#ifdef USE_MMAP_CLAUSES
+#include <sys/mman.h>
+#endif
 
 using namespace CMSat;
 
@@ -51,15 +53,12 @@ using std::endl;
 
 #define MIN_LIST_SIZE (50000 * (sizeof(Clause) + 4*sizeof(Lit))/sizeof(uint32_t))
 #define ALLOC_GROW_MULT 2
-//We shift stuff around in Watched, so not all of 32 bits are useable.
-#define EFFECTIVELY_USEABLE_BITS 30
-#define MAXSIZE ((1 << (EFFECTIVELY_USEABLE_BITS))-1)
-
-ClauseAllocator::ClauseAllocator() :
-    dataStart(NULL)
-    , size(0)
-    , maxSize(0)
-    , currentlyUsedSize(0)
+//Offsets within an arena must fit below the arena bit
+#define MAXSIZE ((1 << (CL_ARENA_SHIFT))-1)
+//Reserved arenas are aligned to, and grow in multiples of, this
+#define HUGE_PAGE_SIZE (2ULL*1024ULL*1024ULL)
+
+ClauseAllocator::ClauseAllocator()
 {
     assert(MIN_LIST_SIZE < MAXSIZE);
 }
@@ -69,9 +68,124 @@ ClauseAllocator::ClauseAllocator() :
 */
 ClauseAllocator::~ClauseAllocator()
 {
+    for(Arena& arena: arenas) {
+        arena.free_data();
+    }
+}
+
+void ClauseAllocator::Arena::free_data()
+{
+    #ifdef USE_MMAP_CLAUSES
+    if (reserved) {
+        munmap(dataStart, MAXSIZE*sizeof(BASE_DATA_TYPE));
+        return;
+    }
+    #endif
     free(dataStart);
 }
 
+/**
+@brief Reserves (but does not commit) all the space the arena can ever use
+
+The range is aligned to a huge page, and is marked as eligible for transparent
+huge pages.
+
+@returns FALSE if the OS would not give the range, in which case realloc()
+is used to grow the arena
+*/
+bool ClauseAllocator::Arena::reserve()
+{
+    #ifdef USE_MMAP_CLAUSES
+    assert(dataStart == NULL);
+    const size_t bytes = MAXSIZE*sizeof(BASE_DATA_TYPE);
+    const size_t toReserve = bytes + HUGE_PAGE_SIZE;
+    void* mem = mmap(NULL, toReserve, PROT_NONE
+        , MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (mem == MAP_FAILED) {
+        return false;
+    }
+
+    //Give back the unaligned head and the tail
+    const uintptr_t start = (uintptr_t)mem;
+    const uintptr_t aligned = (start + HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(HUGE_PAGE_SIZE - 1);
+    if (aligned > start) {
+        munmap(mem, aligned - start);
+    }
+    if (start + toReserve > aligned + bytes) {
+        munmap((void*)(aligned + bytes), start + toReserve - (aligned + bytes));
+    }
+
+    #ifdef MADV_HUGEPAGE
+    madvise((void*)aligned, bytes, MADV_HUGEPAGE);
+    #endif
+
+    dataStart = (BASE_DATA_TYPE*)aligned;
+    reserved = true;
+    return true;
+    #else
+    return false;
+    #endif
+}
+
+void ClauseAllocator::Arena::grow(size_t newMaxSize)
+{
+    #ifdef USE_MMAP_CLAUSES
+    if (dataStart == NULL) {
+        reserve();
+    }
+
+    if (reserved) {
+        //Commit whole huge pages, but never above the reserved range
+        size_t bytes = newMaxSize*sizeof(BASE_DATA_TYPE);
+        bytes = (bytes + HUGE_PAGE_SIZE - 1) & ~(size_t)(HUGE_PAGE_SIZE - 1);
+        bytes = std::min<size_t>(bytes, MAXSIZE*sizeof(BASE_DATA_TYPE));
+        if (mprotect(dataStart, bytes, PROT_READ | PROT_WRITE) != 0) {
+            cout
+            << "ERROR: while committing clause space"
+            << endl;
+
+            throw std::bad_alloc();
+        }
+        maxSize = bytes/sizeof(BASE_DATA_TYPE);
+        return;
+    }
+    #endif
+
+    //Reallocate data
+    dataStart = (BASE_DATA_TYPE*)realloc(
+        dataStart
+        , newMaxSize*sizeof(BASE_DATA_TYPE)
+    );
+
+    //Realloc failed?
+    if (dataStart == NULL) {
+        cout
+        << "ERROR: while reallocating clause space"
+        << endl;
+
+        throw std::bad_alloc();
+    }
+
+    //Update maxSize to reflect the update
+    maxSize = newMaxSize;
+}
+
+///Gives the memory above the used part back to the OS, it stays committed
+void ClauseAllocator::Arena::release_unused()
+{
+    #if defined(USE_MMAP_CLAUSES) && defined(MADV_DONTNEED)
+    if (!reserved)
+        return;
+
+    size_t from = size*sizeof(BASE_DATA_TYPE);
+    from = (from + HUGE_PAGE_SIZE - 1) & ~(size_t)(HUGE_PAGE_SIZE - 1);
+    const size_t to = maxSize*sizeof(BASE_DATA_TYPE);
+    if (from < to) {
+        madvise((char*)dataStart + from, to - from, MADV_DONTNEED);
+    }
+    #endif
+}
+
 /**
 @brief Allocates space&initializes a clause
 */
@@ -79,12 +193,22 @@ template<class T>
 Clause* ClauseAllocator::Clause_new(
     const T& ps
     , const uint32_t conflictNum
+    , const bool red
     , const bool reconstruct
 )
 {
     assert(reconstruct || ps.size() > 3);
-    void* mem = allocEnough(ps.size(), reconstruct);
-    Clause* real= new (mem) Clause(ps, conflictNum);
+    void* mem = allocEnough(ps.size(), red, reconstruct);
+    const uint32_t statsId = newStatsId();
+    Clause* real= new (mem) Clause(ps, statsId);
+    if (red) {
+        real->makeRed();
+    }
+
+    ClauseStats& stats = clauseStats[statsId];
+    stats.introduced_at_conflict = conflictNum;
+    stats.last_touched = conflictNum;
+    stats.glue = std::min<uint32_t>(stats.glue, ps.size());
 
     return real;
 }
@@ -92,6 +216,7 @@ Clause* ClauseAllocator::Clause_new(
 template Clause* ClauseAllocator::Clause_new(
     const vector<Lit>& ps
     , uint32_t conflictNum
+    , bool red
     , bool reconstruct
 );
 
@@ -101,14 +226,34 @@ template Clause* ClauseAllocator::Clause_new(
 Clause* ClauseAllocator::Clause_new(Clause& c)
 {
     assert(c.size() > 3);
-    void* mem = allocEnough(c.size(), false);
+    void* mem = allocEnough(c.size(), c.red(), false);
     memcpy(mem, &c, sizeof(Clause)+sizeof(Lit)*c.size());
 
-    return (Clause*)mem;
+    //The copy gets its own stats
+    Clause* real = (Clause*)mem;
+    const uint32_t statsId = newStatsId();
+    clauseStats[statsId] = clauseStats[c.getStatsId()];
+    real->statsId = statsId;
+
+    return real;
+}
+
+uint32_t ClauseAllocator::newStatsId()
+{
+    if (!freeStatsIds.empty()) {
+        const uint32_t statsId = freeStatsIds.back();
+        freeStatsIds.pop_back();
+        clauseStats[statsId] = ClauseStats();
+        return statsId;
+    }
+
+    clauseStats.push_back(ClauseStats());
+    return clauseStats.size()-1;
 }
 
 void* ClauseAllocator::allocEnough(
     uint32_t clauseSize
+    , bool red
     , bool reconstruct //Are we reconstructing a solution?
 ) {
     assert(reconstruct
@@ -116,23 +261,25 @@ void* ClauseAllocator::allocEnough(
             && "Clause size cannot be 3 or less, those are stored implicitly"
         )
     );
+    Arena& arena = arenas[red];
 
     //Try to quickly find a place at the end of a dataStart
     uint32_t neededbytes = (sizeof(Clause) + sizeof(Lit)*clauseSize);
     uint32_t needed
         = neededbytes/sizeof(BASE_DATA_TYPE) + (bool)(neededbytes % sizeof(BASE_DATA_TYPE));
 
-    if (size + needed > maxSize) {
+    if (arena.size + needed > arena.maxSize) {
         //Grow by default, but don't go under or over the limits
-        size_t newMaxSize = maxSize * ALLOC_GROW_MULT;
+        size_t newMaxSize = arena.maxSize * ALLOC_GROW_MULT;
         newMaxSize = std::min<size_t>(newMaxSize, MAXSIZE);
         newMaxSize = std::max<size_t>(newMaxSize, MIN_LIST_SIZE);
 
         //Oops, not enough space anyway
-        if (newMaxSize < size + needed) {
+        if (newMaxSize < arena.size + needed) {
             cout
             << "ERROR: memory manager can't handle the load"
-            << " size: " << size
+            << " red: " << red
+            << " size: " << arena.size
             << " needed: " << needed
             << " newMaxSize: " << newMaxSize
             << endl;
@@ -140,30 +287,14 @@ void* ClauseAllocator::allocEnough(
             throw std::bad_alloc();
         }
 
-        //Reallocate data
-        dataStart = (BASE_DATA_TYPE*)realloc(
-            dataStart
-            , newMaxSize*sizeof(BASE_DATA_TYPE)
-        );
-
-        //Realloc failed?
-        if (dataStart == NULL) {
-            cout
-            << "ERROR: while reallocating clause space"
-            << endl;
-
-            throw std::bad_alloc();
-        }
-
-        //Update maxSize to reflect the update
-        maxSize = newMaxSize;
+        arena.grow(newMaxSize);
     }
 
     //Add clause to the set
-    Clause* pointer = (Clause*)(dataStart + size);
-    size += needed;
-    currentlyUsedSize += needed;
-    origClauseSizes.push_back(needed);
+    Clause* pointer = (Clause*)(arena.dataStart + arena.size);
+    arena.size += needed;
+    arena.currentlyUsedSize += needed;
+    arena.origClauseSizes.push_back(needed);
 
     return pointer;
 }
@@ -171,12 +302,20 @@ void* ClauseAllocator::allocEnough(
 /**
 @brief Given the pointer of the clause it finds a 32-bit offset for it
 
-Calculates the stack frame and the position of the pointer in the stack, and
-rerturns a 32-bit value that is a concatenation of these two
+Finds the arena the pointer is in, and returns the position of the pointer in
+the arena, with the arena's bit set for the redundant one
 */
 ClOffset ClauseAllocator::getOffset(const Clause* ptr) const
 {
-    return ((BASE_DATA_TYPE*)ptr - dataStart);
+    const BASE_DATA_TYPE* data = (const BASE_DATA_TYPE*)ptr;
+    const Arena& red = arenas[1];
+    if (data >= red.dataStart
+        && data < red.dataStart + red.maxSize
+    ) {
+        return (data - red.dataStart) | (1U << CL_ARENA_SHIFT);
+    }
+
+    return (data - arenas[0].dataStart);
 }
 
 /**
@@ -197,9 +336,10 @@ void ClauseAllocator::clauseFree(Clause* cl)
     assert(!cl->getFreed());
 
     cl->setFreed();
+    freeStatsIds.push_back(cl->getStatsId());
     size_t bytes_freed = (sizeof(Clause) + cl->size()*sizeof(Lit));
     size_t elems_freed = bytes_freed/sizeof(BASE_DATA_TYPE) + (bool)(bytes_freed % sizeof(BASE_DATA_TYPE));
-    currentlyUsedSize -= elems_freed;
+    arenas[getOffset(cl) >> CL_ARENA_SHIFT].currentlyUsedSize -= elems_freed;
 
     #ifdef VALGRIND_MAKE_MEM_UNDEFINED
     VALGRIND_MAKE_MEM_UNDEFINED(((char*)cl)+sizeof(Clause), cl->size()*sizeof(Lit));
@@ -212,46 +352,224 @@ void ClauseAllocator::clauseFree(ClOffset offset)
     clauseFree(cl);
 }
 
+///More than 30% of the arena is unused
+bool ClauseAllocator::Arena::worth_consolidating() const
+{
+    return !((double)currentlyUsedSize/(double)size > 0.7);
+}
+
 /**
-@brief If needed, compacts stacks, removing unused clauses
+@brief If needed, compacts the arenas, removing unused clauses
+
+Every arena that has too much unused space, or all of them if 'force', is
+compacted. The redundant arena is compacted anyway if 'force_red', which is
+what is done after every clause cleaning.
 
-Firstly, the algorithm determines if the number of useless slots is large or
-small compared to the problem size. If it is small, it does nothing. If it is
-large, then it allocates new stacks, copies the non-freed clauses to these new
-stacks, updates all pointers and offsets, and frees the original stacks.
+Clauses are put in the order given by conf.clauseOrder, which is their current
+order by default. Only the offsets pointing into the compacted arenas are
+updated, in place: the watchlists are not rebuilt, and longIrredCls and
+longRedCls keep their order.
 */
 void ClauseAllocator::consolidate(
     Solver* solver
     , const bool force
+    , const bool force_red
 ) {
     //double myTime = cpuTime();
 
-    //If re-allocation is not really neccessary, don't do it
-    //Neccesities:
-    //1) There is too much memory allocated. Re-allocation will save space
-    //   Avoiding segfault (max is 16 outerOffsets, more than 10 is near)
-    //2) There is too much empty, unused space (>30%)
-    if (!force
-        && ((double)currentlyUsedSize/(double)size > 0.7)
-    ) {
+    bool moved[2];
+    moved[0] = force || arenas[0].worth_consolidating();
+    moved[1] = force || force_red || arenas[1].worth_consolidating();
+    if (!moved[0] && !moved[1]) {
         if (solver->conf.verbosity >= 3) {
             cout << "c Not consolidating memory." << endl;
         }
         return;
     }
 
+    //New offsets, indexed by Clause::getStatsId(), since that survives the move
+    vector<ClOffset> newOffsets(clauseStats.size(), std::numeric_limits<ClOffset>::max());
+    vector<ClOffset> order[2];
+    size_t numClauses = 0;
+    for(size_t at = 0; at < 2; at++) {
+        if (moved[at]) {
+            order_clauses(solver, at, order[at]);
+            calc_new_offsets(at, order[at], newOffsets);
+            numClauses += order[at].size();
+        }
+    }
+
+    //Must be done while the clauses are still at their old place
+    update_offsets(solver, moved, newOffsets, numClauses);
+
+    for(size_t at = 0; at < 2; at++) {
+        if (!moved[at])
+            continue;
+
+        const size_t oldSize = arenas[at].size;
+        if (solver->conf.clauseOrder == clorder_alloc
+            || order[at].empty()
+        ) {
+            move_clauses(at);
+        } else {
+            copy_clauses_in_order(at, order[at]);
+        }
+        if (solver->conf.verbosity >= 3) {
+            cout << "c consolidated memory. "
+            << " arena: " << (at ? "red" : "irred")
+            << " Num cls:" << arenas[at].origClauseSizes.size()
+            << " old size:" << oldSize
+            << " new size:" << arenas[at].size
+            << endl;
+        }
+    }
+
+    //Compact the watchlists too when doing the full pass
+    if (moved[0]) {
+        solver->watches.consolidate();
+    }
+}
+
+///The non-freed clauses of the arena, in the order they are in memory
+void ClauseAllocator::live_clauses(
+    const size_t at
+    , vector<ClOffset>& offsets
+) const {
+    const Arena& arena = arenas[at];
+    size_t pos = 0;
+    for (const size_t sz: arena.origClauseSizes) {
+        const Clause* clause = (const Clause*)(arena.dataStart + pos);
+        if (!clause->freed()) {
+            offsets.push_back(pos | (at << CL_ARENA_SHIFT));
+        }
+        pos += sz;
+    }
+}
+
+/**
+@brief Decides the order of the non-freed clauses of the arena after compaction
+
+For clorder_watch, clauses are put in the order the watchlists reach them, so
+the clauses visited while propagating a literal are next to each other. For
+clorder_prop, the clauses that propagated the most are put first, so the hot
+ones share cache lines and pages.
+*/
+void ClauseAllocator::order_clauses(
+    Solver* solver
+    , const size_t at
+    , vector<ClOffset>& order
+) const {
+    switch(solver->conf.clauseOrder) {
+        case clorder_alloc:
+            live_clauses(at, order);
+            break;
+
+        case clorder_watch: {
+            vector<char> placed(clauseStats.size(), 0);
+            for (watch_array::const_iterator
+                it = solver->watches.begin(), end = solver->watches.end()
+                ; it != end
+                ; ++it
+            ) {
+                for(const Watched& w: *it) {
+                    if (!w.isClause()
+                        || (w.getOffset() >> CL_ARENA_SHIFT) != at
+                    ) {
+                        continue;
+                    }
+
+                    const uint32_t statsId = getPointer(w.getOffset())->getStatsId();
+                    if (!placed[statsId]) {
+                        placed[statsId] = 1;
+                        order.push_back(w.getOffset());
+                    }
+                }
+            }
+
+            //Clauses that are not attached go last
+            vector<ClOffset> all;
+            live_clauses(at, all);
+            for(const ClOffset offset: all) {
+                if (!placed[getPointer(offset)->getStatsId()]) {
+                    order.push_back(offset);
+                }
+            }
+            break;
+        }
+
+        case clorder_prop:
+            live_clauses(at, order);
+            std::stable_sort(order.begin(), order.end()
+                , [&] (const ClOffset a, const ClOffset b) -> bool {
+                    return getStats(*getPointer(a)).propagations_made
+                        > getStats(*getPointer(b)).propagations_made;
+                }
+            );
+            break;
+    }
+}
+
+///Calculates where the clauses will be when put in 'order'
+void ClauseAllocator::calc_new_offsets(
+    const size_t at
+    , const vector<ClOffset>& order
+    , vector<ClOffset>& newOffsets
+) const {
+    uint64_t newSize = 0;
+    for (const ClOffset offset: order) {
+        const Clause* clause = getPointer(offset);
+        assert(!clause->freed());
+
+        size_t bytesNeeded = sizeof(Clause) + clause->size()*sizeof(Lit);
+        size_t sizeNeeded = bytesNeeded/sizeof(BASE_DATA_TYPE) + (bool)(bytesNeeded % sizeof(BASE_DATA_TYPE));
+        newOffsets[clause->getStatsId()] = newSize | (at << CL_ARENA_SHIFT);
+        newSize += sizeNeeded;
+    }
+}
+
+/**
+@brief Copies the clauses in 'order' to new memory, then frees the old one
+
+Unlike move_clauses(), this needs the old and the new memory at the same time.
+*/
+void ClauseAllocator::copy_clauses_in_order(
+    const size_t at
+    , const vector<ClOffset>& order
+) {
+    Arena& arena = arenas[at];
+    Arena newArena;
+    newArena.grow(arena.maxSize);
+
+    for (const ClOffset offset: order) {
+        const Clause* clause = getPointer(offset);
+        size_t bytesNeeded = sizeof(Clause) + clause->size()*sizeof(Lit);
+        size_t sizeNeeded = bytesNeeded/sizeof(BASE_DATA_TYPE) + (bool)(bytesNeeded % sizeof(BASE_DATA_TYPE));
+        memcpy(newArena.dataStart + newArena.size, clause, sizeNeeded*sizeof(BASE_DATA_TYPE));
+
+        newArena.origClauseSizes.push_back(sizeNeeded);
+        newArena.size += sizeNeeded;
+    }
+    newArena.currentlyUsedSize = newArena.size;
+
+    arena.free_data();
+    arena = std::move(newArena);
+}
+
+void ClauseAllocator::move_clauses(const size_t at)
+{
+    Arena& arena = arenas[at];
+
     //Data for new struct
     vector<uint32_t> newOrigClauseSizes;
-    vector<ClOffset> newOffsets;
     uint64_t newSize = 0;
 
     //Pointers that will be moved along
-    BASE_DATA_TYPE* newDataStart = dataStart;
-    BASE_DATA_TYPE* tmpDataStart = dataStart;
+    BASE_DATA_TYPE* newDataStart = arena.dataStart;
+    BASE_DATA_TYPE* tmpDataStart = arena.dataStart;
 
     assert(sizeof(Clause) % sizeof(BASE_DATA_TYPE) == 0);
     assert(sizeof(BASE_DATA_TYPE) % sizeof(Lit) == 0);
-    for (const size_t sz: origClauseSizes) {
+    for (const size_t sz: arena.origClauseSizes) {
         Clause* clause = (Clause*)tmpDataStart;
         //Already freed, so skip entirely
         if (clause->freed()) {
@@ -268,9 +586,6 @@ void ClauseAllocator::consolidate(
         assert(sizeNeeded <= sz && "New clause size must not be bigger than orig clause size");
         memmove(newDataStart, tmpDataStart, sizeNeeded*sizeof(BASE_DATA_TYPE));
 
-        //Record position
-        newOffsets.push_back(newSize);
-
         //Record sizes
         newOrigClauseSizes.push_back(sizeNeeded);
         newSize += sizeNeeded;
@@ -280,44 +595,51 @@ void ClauseAllocator::consolidate(
         tmpDataStart += sz;
     }
 
-    if (solver->conf.verbosity >= 3) {
-        cout << "c consolidated memory. "
-        << " Num cls:" << newOrigClauseSizes.size()
-        << " old size:" << size
-        << " new size:" << newSize
-        << endl;
-    }
+    //Update sizes
+    arena.size = newSize;
+    arena.currentlyUsedSize = newSize;
+    newOrigClauseSizes.swap(arena.origClauseSizes);
+    arena.release_unused();
+}
 
-    //Update offsets & pointers(?) now, when everything is in memory still
-    updateAllOffsetsAndPointers(solver, newOffsets);
+inline ClOffset ClauseAllocator::new_offset(
+    const ClOffset offset
+    , const bool moved[2]
+    , const vector<ClOffset>& newOffsets
+) const {
+    if (!moved[offset >> CL_ARENA_SHIFT])
+        return offset;
 
-    //Update sizes
-    size = newSize;
-    currentlyUsedSize = newSize;
-    newOrigClauseSizes.swap(origClauseSizes);
+    const Clause* cl = getPointer(offset);
+    assert(!cl->freed());
+    const ClOffset newOffset = newOffsets[cl->getStatsId()];
+    assert(newOffset != std::numeric_limits<ClOffset>::max());
+
+    return newOffset;
 }
 
-void ClauseAllocator::updateAllOffsetsAndPointers(
+void ClauseAllocator::update_offsets(
     Solver* solver
-    , const vector<ClOffset>& offsets
+    , const bool moved[2]
+    , const vector<ClOffset>& newOffsets
+    , const size_t numClauses
 ) {
     //Must be at toplevel, otherwise propBy reset will not work
-    //and also, detachReattacher will fail
     assert(solver->decisionLevel() == 0);
 
     //We are at decision level 0, so we can reset all PropBy-s
-    for (auto& vdata: solver->varData) {
-        vdata.reason = PropBy();
+    for (PropBy& reason: solver->varReason) {
+        reason = PropBy();
     }
 
-    //Detach long clauses
-    CompleteDetachReatacher detachReattach(solver);
-    detachReattach.detachNonBinsNonTris();
-
     //Make sure all non-freed clauses were accessible from solver
-    const size_t origNumClauses =
-        solver->longIrredCls.size() + solver->longRedCls.size();
-    if (origNumClauses != offsets.size()) {
+    size_t origNumClauses = 0;
+    for(const vector<ClOffset>* cls: {&solver->longIrredCls, &solver->longRedCls}) {
+        for(const ClOffset offset: *cls) {
+            origNumClauses += moved[offset >> CL_ARENA_SHIFT];
+        }
+    }
+    if (origNumClauses != numClauses) {
         cout
         << "ERROR: Not all non-freed clauses are accessible from Solver"
         << endl
@@ -325,39 +647,49 @@ void ClauseAllocator::updateAllOffsetsAndPointers(
         << endl
         << " no. clauses accessible from solver: " << origNumClauses
         << endl
-        << " no. clauses non-freed: " << offsets.size()
+        << " no. clauses non-freed: " << numClauses
         << endl;
 
-        assert(origNumClauses == offsets.size());
+        assert(origNumClauses == numClauses);
         std::exit(-1);
     }
 
-    //Clear clauses
-    solver->longIrredCls.clear();
-    solver->longRedCls.clear();
-
-    //Add back to the solver the correct red & irred clauses
-    for(auto offset: offsets) {
-        Clause* cl = getPointer(offset);
-        assert(!cl->getFreed());
-
-        //Put it in the right bucket
-        if (cl->red()) {
-            solver->longRedCls.push_back(offset);
-        } else {
-            solver->longIrredCls.push_back(offset);
+    //Update the watches
+    for (watch_array::iterator
+        it = solver->watches.begin(), end = solver->watches.end()
+        ; it != end
+        ; ++it
+    ) {
+        watch_subarray ws = *it;
+        for(watch_subarray::iterator
+            w = ws.begin(), wend = ws.end()
+            ; w != wend
+            ; w++
+        ) {
+            if (w->isClause()) {
+                w->setNormOffset(new_offset(w->getOffset(), moved, newOffsets));
+            }
         }
     }
 
-    //Finally, reattach long clauses
-    detachReattach.reattachLongs();
+    //Update the clause lists
+    for(vector<ClOffset>* cls: {&solver->longIrredCls, &solver->longRedCls}) {
+        for(ClOffset& offset: *cls) {
+            offset = new_offset(offset, moved, newOffsets);
+        }
+    }
 }
 
 size_t ClauseAllocator::memUsed() const
 {
     uint64_t mem = 0;
-    mem += maxSize*sizeof(BASE_DATA_TYPE);
-    mem += origClauseSizes.capacity()*sizeof(uint32_t);
+    for(const Arena& arena: arenas) {
+        //Committed but never touched pages of a reserved arena take no memory
+        mem += (arena.reserved ? arena.size : arena.maxSize)*sizeof(BASE_DATA_TYPE);
+        mem += arena.origClauseSizes.capacity()*sizeof(uint32_t);
+    }
+    mem += clauseStats.capacity()*sizeof(ClauseStats);
+    mem += freeStatsIds.capacity()*sizeof(uint32_t);
 
     return mem;
 }
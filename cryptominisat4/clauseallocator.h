@@ -31,9 +31,14 @@
 #include <vector>
 
 #include "watched.h"
+#include "clause.h"
 
 #define BASE_DATA_TYPE uint64_t
 
+//Bit 30 of the offset picks the arena, so each can address 2^30 units
+#define CL_ARENA_SHIFT 30
+#define CL_ARENA_OFFSET_MASK ((1U << CL_ARENA_SHIFT)-1)
+
 namespace CMSat {
 
 class Clause;
@@ -51,6 +56,16 @@ needed. When instructed, it consolidates the unused space (i.e. clauses free()-e
 Essentially, it is a stack-like allocator for clauses. It is useful to have
 this, because this way, we can address clauses according to their number,
 which is 32-bit, instead of their address, which might be 64-bit
+
+Where the OS allows, each arena reserves the largest range it can address up
+front and only commits memory to it as it grows, so growing never copies the
+clauses and never needs the old and the new memory at the same time.
+
+Irredundant and redundant clauses are allocated in two separate arenas. The
+irredundant one rarely has much freed space in it, so it is only compacted
+when it is worth it, while the redundant one is compacted after every clause
+cleaning. The arena is decided when the clause is created, so a clause that
+later changes its redundancy stays in its original arena.
 */
 class ClauseAllocator {
     public:
@@ -60,6 +75,7 @@ class ClauseAllocator {
         template<class T> Clause* Clause_new(
             const T& ps
             , uint32_t conflictNum
+            , bool red = false
             , bool recostruct = false
         );
         Clause* Clause_new(Clause& c);
@@ -69,51 +85,110 @@ class ClauseAllocator {
         /**
         @brief Returns the pointer of a clause given its offset
 
-        Takes the "dataStart" of the correct stack, and adds the offset,
+        Takes the "dataStart" of the correct arena, and adds the offset,
         returning the thus created pointer. Used a LOT in propagation, thus this
         is very important to be fast (therefore, it is an inlined method)
         */
         inline Clause* getPointer(const uint32_t offset) const
         {
-            return (Clause*)(dataStart + offset);
+            return (Clause*)(
+                arenas[offset >> CL_ARENA_SHIFT].dataStart
+                + (offset & CL_ARENA_OFFSET_MASK)
+            );
         }
 
         void clauseFree(Clause* c); ///Frees memory and associated clause number
         void clauseFree(ClOffset offset);
 
+        ///The statistics of the clause, kept apart so that propagation does not need to load them
+        ClauseStats& getStats(const Clause& cl)
+        {
+            return clauseStats[cl.getStatsId()];
+        }
+
+        const ClauseStats& getStats(const Clause& cl) const
+        {
+            return clauseStats[cl.getStatsId()];
+        }
+
         void consolidate(
             Solver* solver
             , const bool force = false
+            , const bool force_red = false
         );
 
         size_t memUsed() const;
 
     private:
-        void updateAllOffsetsAndPointers(
+        struct Arena
+        {
+            BASE_DATA_TYPE* dataStart = NULL; ///<Stack starts at this position
+            size_t size = 0; ///<The number of BASE_DATA_TYPE datapieces currently used in the stack
+            /**
+            @brief Clauses in the stack had this size when they were allocated
+            This my NOT be their current size: the clauses may be shrinked during
+            the running of the solver. Therefore, it is imperative that their orignal
+            size is saved. This way, we can later move clauses around.
+            */
+            vector<uint32_t> origClauseSizes;
+            size_t maxSize = 0; ///<The number of BASE_DATA_TYPE datapieces allocated
+            /**
+            @brief The estimated used size of the stack
+            This is incremented by clauseSize each time a clause is allocated, and
+            decremetented by clauseSize each time a clause is deallocated. The
+            problem is, that clauses can shrink, and thus this value will be an
+            overestimation almost all the time
+            */
+            size_t currentlyUsedSize = 0;
+            bool reserved = false; ///<dataStart is a reserved range, it never moves
+
+            bool worth_consolidating() const;
+            void grow(size_t newMaxSize);
+            bool reserve();
+            void release_unused();
+            void free_data();
+        };
+        Arena arenas[2]; ///<Irredundant, then redundant clauses
+
+        void live_clauses(const size_t at, vector<ClOffset>& offsets) const;
+        void order_clauses(
+            Solver* solver
+            , const size_t at
+            , vector<ClOffset>& order
+        ) const;
+        void calc_new_offsets(
+            const size_t at
+            , const vector<ClOffset>& order
+            , vector<ClOffset>& newOffsets
+        ) const;
+        void move_clauses(const size_t at);
+        void copy_clauses_in_order(
+            const size_t at
+            , const vector<ClOffset>& order
+        );
+        void update_offsets(
             Solver* solver
-            , const vector<ClOffset>& offsets
+            , const bool moved[2]
+            , const vector<ClOffset>& newOffsets
+            , size_t numClauses
         );
+        ClOffset new_offset(
+            const ClOffset offset
+            , const bool moved[2]
+            , const vector<ClOffset>& newOffsets
+        ) const;
 
-        BASE_DATA_TYPE* dataStart; ///<Stacks start at these positions
-        size_t size; ///<The number of BASE_DATA_TYPE datapieces currently used in each stack
         /**
-        @brief Clauses in the stack had this size when they were allocated
-        This my NOT be their current size: the clauses may be shrinked during
-        the running of the solver. Therefore, it is imperative that their orignal
-        size is saved. This way, we can later move clauses around.
-        */
-        vector<uint32_t> origClauseSizes;
-        size_t maxSize; ///<The number of BASE_DATA_TYPE datapieces allocated
-        /**
-        @brief The estimated used size of the stack
-        This is incremented by clauseSize each time a clause is allocated, and
-        decremetented by clauseSize each time a clause is deallocated. The
-        problem is, that clauses can shrink, and thus this value will be an
-        overestimation almost all the time
+        @brief Cold part of the clauses, indexed by Clause::getStatsId()
+
+        Indices stay the same when the clauses are moved by consolidate(), and
+        are reused once their clause is freed
         */
-        size_t currentlyUsedSize;
+        vector<ClauseStats> clauseStats;
+        vector<uint32_t> freeStatsIds;
+        uint32_t newStatsId();
 
-        void* allocEnough(const uint32_t size, const bool reconstruct);
+        void* allocEnough(const uint32_t size, const bool red, const bool reconstruct);
 };
 
 } //end namespace
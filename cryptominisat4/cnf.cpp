@@ -41,7 +41,9 @@ void CNF::new_var(const bool bva, const Var orig_outer)
         varData[nVars()-1].is_bva = bva;
         if (bva) {
             num_bva_vars ++;
+            outer_to_without_bva_map.push_back(var_Undef);
         } else {
+            outer_to_without_bva_map.push_back(outer_to_with_bva_map.size());
             outer_to_with_bva_map.push_back(nVarsOuter() - 1);
         }
     } else {
@@ -67,6 +69,8 @@ void CNF::new_var(const bool bva, const Var orig_outer)
 void CNF::swapVars(const Var which)
 {
     std::swap(assigns[nVars()-1], assigns[which]);
+    std::swap(varLevel[nVars()-1], varLevel[which]);
+    std::swap(varReason[nVars()-1], varReason[which]);
     std::swap(varData[nVars()-1], varData[which]);
 
     #ifdef STATS_NEEDED
@@ -77,6 +81,8 @@ void CNF::swapVars(const Var which)
 void CNF::enlarge_nonminimial_datastructs()
 {
     assigns.push_back(l_Undef);
+    varLevel.push_back(std::numeric_limits<uint32_t>::max());
+    varReason.push_back(PropBy());
     varData.push_back(VarData());
     #ifdef STATS_NEEDED
     varDataLT.push_back(VarData());
@@ -95,7 +101,7 @@ void CNF::enlarge_minimal_datastructs()
 
 void CNF::saveVarMem()
 {
-    //never resize varData --> contains info about what is replaced/etc.
+    //never resize varData, varLevel and varReason --> contains info about what is replaced/etc.
     //never resize assigns --> contains 0-level assigns
     //never resize interToOuterMain, outerToInterMain
 
@@ -279,6 +285,8 @@ size_t CNF::get_renumber_mem() const
     size_t mem = 0;
     mem += interToOuterMain.capacity()*sizeof(Var);
     mem += outerToInterMain.capacity()*sizeof(Var);
+    mem += outer_to_with_bva_map.capacity()*sizeof(Var);
+    mem += outer_to_without_bva_map.capacity()*sizeof(Var);
     return mem;
 }
 
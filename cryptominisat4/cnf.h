@@ -11,6 +11,7 @@
 #include "drup.h"
 #include "clauseallocator.h"
 #include "varupdatehelper.h"
+#include "findnonfalse.h"
 
 namespace CMSat {
 using namespace CMSat;
@@ -59,7 +60,9 @@ public:
     //If FALSE, state of CNF is UNSAT
     bool ok = true;
     watch_array watches;  ///< 'watches[lit]' is a list of constraints watching 'lit'
-    vector<lbool> assigns;
+    vector<lbool, GatherPaddedAllocator<lbool> > assigns;
+    vector<uint32_t> varLevel; ///<Decision level at which the var was assigned
+    vector<PropBy> varReason; ///<Reason the var got propagated. NULL means decision/toplevel
     vector<VarData> varData;
     #ifdef STATS_NEEDED
     vector<VarData> varDataLT;
@@ -151,6 +154,12 @@ public:
         return Lit(outer_to_with_bva_map.at(lit.var()), lit.sign());
     }
 
+    ///Returns var_Undef if the variable is a BVA variable
+    Var map_outer_to_without_bva(const Var outer) const
+    {
+        return outer_to_without_bva_map[outer];
+    }
+
 protected:
     vector<Var> build_outer_to_without_bva_map() const;
     virtual void new_var(bool bva, Var orig_outer);
@@ -183,6 +192,7 @@ private:
     vector<Var> interToOuterMain;
     size_t num_bva_vars = 0;
     vector<Var> outer_to_with_bva_map;
+    vector<Var> outer_to_without_bva_map;
 };
 
 template<class Function>
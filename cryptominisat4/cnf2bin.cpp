@@ -0,0 +1,236 @@
+/*****************************************************************************
+CryptoMiniSat -- Copyright (c) 2009 Mate Soos
+
+File under MIT licence.
+******************************************************************************/
+
+/**
+@brief Converts DIMACS to the binary CNF format, see BinaryCnf
+
+The binary file loads much faster, which pays off when the same instance is
+solved many times. XORs and the "c Solver::solve(" and "c Solver::new_var()"
+comments used by --debuglib are kept, everything else in comments is lost.
+*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <unistd.h>
+#include "inputreader.h"
+#include "streambuffer.h"
+#include "binarycnf.h"
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+class DimacsConverter
+{
+public:
+    DimacsConverter(BinaryCnfWriter& _writer) :
+        writer(_writer)
+    {}
+
+    void convert(StreamBuffer& in);
+
+private:
+    void skipWhitespace(StreamBuffer& in);
+    void skipLine(StreamBuffer& in);
+    int64_t parseInt(StreamBuffer& in);
+    void readLits(StreamBuffer& in);
+    void parseComment(StreamBuffer& in);
+
+    BinaryCnfWriter& writer;
+    size_t lineNum = 0;
+    vector<Lit> lits;
+    vector<Var> vars;
+};
+
+void DimacsConverter::skipWhitespace(StreamBuffer& in)
+{
+    while ((*in >= 9 && *in <= 13 && *in != 10) || *in == 32)
+        ++in;
+}
+
+void DimacsConverter::skipLine(StreamBuffer& in)
+{
+    for (;;) {
+        if (*in == EOF)
+            return;
+        if (*in == '\n') {
+            ++in;
+            lineNum++;
+            return;
+        }
+        ++in;
+    }
+}
+
+int64_t DimacsConverter::parseInt(StreamBuffer& in)
+{
+    skipWhitespace(in);
+    bool neg = false;
+    if (*in == '-') {
+        neg = true;
+        ++in;
+    } else if (*in == '+') {
+        ++in;
+    }
+
+    if (*in < '0' || *in > '9') {
+        cout
+        << "PARSE ERROR! Unexpected char: '" << (char)*in << "'"
+        << " at line " << lineNum+1
+        << " while reading a number"
+        << endl;
+        std::exit(3);
+    }
+
+    uint64_t val = 0;
+    while (*in >= '0' && *in <= '9') {
+        //Saturates, anything this large is rejected anyway
+        if (val < (1ULL<<40)) {
+            val = val*10 + (*in - '0');
+        }
+        ++in;
+    }
+    return neg ? -(int64_t)val : (int64_t)val;
+}
+
+void DimacsConverter::readLits(StreamBuffer& in)
+{
+    lits.clear();
+    for (;;) {
+        const int64_t parsed_lit = parseInt(in);
+        if (parsed_lit == 0)
+            break;
+
+        const uint64_t var = std::abs(parsed_lit)-1;
+        if (var >= (1ULL<<28)) {
+            cout
+            << "ERROR! Variable requested is far too large: "
+            << var << endl
+            << "--> At line " << lineNum+1
+            << endl;
+            std::exit(-1);
+        }
+        lits.push_back(Lit(var, parsed_lit < 0));
+    }
+}
+
+void DimacsConverter::parseComment(StreamBuffer& in)
+{
+    skipWhitespace(in);
+    string str;
+    while (*in != ' ' && *in != '\n' && *in != EOF) {
+        str += *in;
+        ++in;
+    }
+
+    if (str.substr(0, 13) == "Solver::solve") {
+        lits.clear();
+        skipWhitespace(in);
+        while (*in != ')') {
+            const int64_t lit = parseInt(in);
+            lits.push_back(Lit(std::abs(lit)-1, lit < 0));
+            skipWhitespace(in);
+        }
+        writer.add_solve(lits);
+    } else if (str == "Solver::new_var()") {
+        writer.add_new_var();
+    }
+    skipLine(in);
+}
+
+void DimacsConverter::convert(StreamBuffer& in)
+{
+    for (;;) {
+        skipWhitespace(in);
+        switch (*in) {
+        case EOF:
+            return;
+        case 'p':
+        case '\n':
+            skipLine(in);
+            break;
+        case 'c':
+            ++in;
+            parseComment(in);
+            break;
+        case 'x': {
+            ++in;
+            readLits(in);
+            skipLine(in);
+            if (lits.empty())
+                break;
+
+            bool rhs = true;
+            vars.clear();
+            for(const Lit lit: lits) {
+                vars.push_back(lit.var());
+                rhs ^= lit.sign();
+            }
+            writer.add_xor_clause(vars, rhs);
+            break;
+        }
+        default:
+            readLits(in);
+            skipLine(in);
+            writer.add_clause(lits);
+            break;
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 3) {
+        cout
+        << "USAGE: " << argv[0] << " <input-file> <output-file>" << endl
+        << " Converts a DIMACS file to binary CNF, which cryptominisat4"
+        << " loads much faster." << endl
+        << " Use '-' as input to read standard input. Input may be"
+        << " compressed if the format was found during compilation."
+        << endl;
+        std::exit(argc == 2 && (string(argv[1]) == "-h" || string(argv[1]) == "--help") ? 0 : 1);
+    }
+
+    InputReader reader;
+    if (string(argv[1]) == "-") {
+        reader.open_fd(STDIN_FILENO);
+    } else if (!reader.open(argv[1])) {
+        cout << "ERROR! Could not open file '" << argv[1] << "' for reading" << endl;
+        std::exit(1);
+    }
+
+    BinaryCnfWriter writer;
+    if (!writer.open(argv[2])) {
+        cout << "ERROR! Could not open file '" << argv[2] << "' for writing" << endl;
+        std::exit(1);
+    }
+
+    StreamBuffer in(&reader);
+    if (BinaryCnf::is_binary(in.cur(), in.avail())) {
+        cout << "ERROR! Input is already binary CNF" << endl;
+        std::exit(1);
+    }
+    DimacsConverter converter(writer);
+    converter.convert(in);
+
+    if (!writer.close()) {
+        cout << "ERROR! Could not write file '" << argv[2] << "'" << endl;
+        std::exit(1);
+    }
+
+    cout
+    << "c Wrote " << argv[2] << ": "
+    << writer.get_num_vars() << " vars, "
+    << writer.get_num_clauses() << " clauses, "
+    << writer.get_num_xors() << " xor clauses, "
+    << writer.get_bytes_written() << " bytes"
+    << endl;
+
+    return 0;
+}
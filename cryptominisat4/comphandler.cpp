@@ -30,6 +30,10 @@
 #include <iostream>
 #include <assert.h>
 #include <iomanip>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <atomic>
 #include "cryptominisat.h"
 
 using namespace CMSat;
@@ -133,17 +137,47 @@ bool CompHandler::handle()
     std::sort(sizes.begin(), sizes.end(), sort_pred());
     assert(sizes.size() > 1);
 
+    unsigned num_threads = solver->conf.compNumThreads;
+    if (num_threads == 0) {
+        num_threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    num_threads = std::min<size_t>(num_threads, sizes.size()-1);
+
+    //The largest component stays in this solver, the rest get their own
+    vector<CompToSolve> todo;
+    for (uint32_t it = 0; it < sizes.size()-1; it++) {
+        CompToSolve comp;
+        comp.comp_at = it;
+        comp.comp = sizes[it].first;
+        comp.vars = reverseTable[comp.comp];
+        comp.newSolver = NULL;
+        comp.status = l_Undef;
+        comp.skipped = false;
+        todo.push_back(comp);
+    }
+
+    //Start with the largest, so the long ones don't end up running last
+    std::reverse(todo.begin(), todo.end());
+    solve_comps(todo, num_comps, num_threads);
+
+    bool all_solved = true;
     size_t num_comps_solved = 0;
     size_t vars_solved = 0;
-    for (uint32_t it = 0; it < sizes.size()-1; it++) {
-        const uint32_t comp = sizes[it].first;
-        vector<Var>& vars = reverseTable[comp];
-        const bool cont = solve_component(it, comp, vars, num_comps);
-        if (!cont) {
-            break;
+    for(const CompToSolve& comp: todo) {
+        if (comp.skipped)
+            continue;
+
+        if (comp.status == l_True) {
+            num_comps_solved++;
+            vars_solved += comp.vars.size();
+        } else {
+            all_solved = false;
         }
-        num_comps_solved++;
-        vars_solved += vars.size();
+    }
+
+    if (solver->okay() && !all_solved) {
+        //Out of time
+        readdRemovedClauses();
     }
 
     if (!solver->okay())
@@ -155,6 +189,7 @@ bool CompHandler::handle()
         << "c [comp] Coming back to original instance, solved "
         << num_comps_solved << " component(s), "
         << vars_solved << " vars"
+        << " threads: " << num_threads
         << " T: "
         << std::setprecision(2) << std::fixed
         << cpuTime() - myTime
@@ -170,83 +205,147 @@ bool CompHandler::handle()
     return true;
 }
 
-bool CompHandler::solve_component(
-    const uint32_t comp_at
-    , const uint32_t comp
-    , const vector<Var>& vars_orig
+bool CompHandler::move_comp_to_new_solver(
+    CompToSolve& todo
     , const size_t num_comps
+    , const bool parallel
 ) {
-    for(const Var var: vars_orig) {
+    for(const Var var: todo.vars) {
         assert(solver->value(var) == l_Undef);
     }
 
-    if (vars_orig.size() > 100ULL*1000ULL) {
+    if (todo.vars.size() > 100ULL*1000ULL) {
         //There too many variables -- don't create a sub-solver
         //I'm afraid that we will memory-out
 
-        return true;
+        return false;
     }
 
     //Components with assumptions should not be removed
-    if (assumpsInsideComponent(vars_orig))
-        return true;
-
-    vector<Var> vars(vars_orig);
+    if (assumpsInsideComponent(todo.vars))
+        return false;
 
     //Sort and renumber
-    std::sort(vars.begin(), vars.end());
-    /*for(Var var: vars) {
+    std::sort(todo.vars.begin(), todo.vars.end());
+    /*for(Var var: todo.vars) {
         cout << "var in component: " << solver->map_inter_to_outer(var) + 1 << endl;
     }*/
-    createRenumbering(vars);
+    createRenumbering(todo.vars);
 
     //Print what we are going to do
     if (solver->conf.verbosity >= 1 && num_comps < 20) {
         cout
-        << "c [comp] Solving component " << comp_at
-        << " num vars: " << vars.size()
-        << " ======================================="
+        << "c [comp] Moving component " << todo.comp_at
+        << " num vars: " << todo.vars.size()
+        << " to its own solver"
         << endl;
     }
 
     //Set up new solver
-    SolverConf conf = configureNewSolver(vars.size());
-    SATSolver newSolver(conf);
-    moveVariablesBetweenSolvers(&newSolver, vars, comp);
+    SolverConf conf = configureNewSolver(todo.vars.size(), parallel);
+    todo.newSolver = new SATSolver(conf);
+    moveVariablesBetweenSolvers(todo.newSolver, todo.vars, todo.comp);
 
     //Move clauses over
-    moveClausesImplicit(&newSolver, comp, vars);
-    moveClausesLong(solver->longIrredCls, &newSolver, comp);
-    moveClausesLong(solver->longRedCls, &newSolver, comp);
+    moveClausesImplicit(todo.newSolver, todo.comp, todo.vars);
+    moveClausesLong(solver->longIrredCls, todo.newSolver, todo.comp);
+    moveClausesLong(solver->longRedCls, todo.newSolver, todo.comp);
 
-    const lbool status = newSolver.solve();
-    //Out of time
-    if (status == l_Undef) {
-        readdRemovedClauses();
-        return false;
-    }
+    return true;
+}
 
-    if (status == l_False) {
-        solver->ok = false;
-        if (solver->conf.verbosity >= 2) {
-            cout
-            << "c [comp] The component is UNSAT -> problem is UNSAT"
-            << endl;
+/**
+@brief Solves the components on a pool of threads, in the order given
+
+Each worker builds the sub-solver of its component, solves it, saves the
+solution and frees it, so only as many sub-solvers exist at a time as there
+are threads. Building and saving change the main solver, so they are done
+under a lock, only solving runs in parallel.
+
+Stops early if a component is UNSAT (then the whole problem is) or runs out of
+time (then everything is added back anyway).
+*/
+void CompHandler::solve_comps(
+    vector<CompToSolve>& todo
+    , const size_t num_comps
+    , const unsigned num_threads
+) {
+    std::atomic<size_t> next(0);
+    bool must_stop = false;
+    std::mutex main_mutex;
+    auto worker = [&]() {
+        size_t at;
+        while((at = next++) < todo.size()) {
+            CompToSolve& comp = todo[at];
+            {
+                std::lock_guard<std::mutex> lock(main_mutex);
+                if (must_stop)
+                    return;
+
+                if (!move_comp_to_new_solver(comp, num_comps, num_threads > 1)) {
+                    comp.skipped = true;
+                    continue;
+                }
+            }
+
+            comp.status = comp.newSolver->solve();
+
+            std::lock_guard<std::mutex> lock(main_mutex);
+            if (comp.status == l_True) {
+                if (solver->okay())
+                    save_comp_solution(comp, num_comps);
+            } else {
+                if (comp.status == l_False) {
+                    solver->ok = false;
+                    if (solver->conf.verbosity >= 2) {
+                        cout
+                        << "c [comp] The component is UNSAT -> problem is UNSAT"
+                        << endl;
+                    }
+                }
+
+                //Tell the others not to bother
+                must_stop = true;
+                for(CompToSolve& other: todo) {
+                    if (other.newSolver != NULL && &other != &comp) {
+                        other.newSolver->interrupt_asap();
+                    }
+                }
+            }
+            delete comp.newSolver;
+            comp.newSolver = NULL;
         }
-        return false;
+    };
+
+    if (num_threads <= 1) {
+        worker();
+        return;
     }
 
-    check_solution_is_unassigned_in_main_solver(&newSolver, vars);
-    save_solution_to_savedstate(&newSolver, vars, comp);
-    move_decision_level_zero_vars_here(&newSolver);
+    vector<std::thread> threads;
+    for(unsigned i = 0; i < num_threads; i++) {
+        threads.push_back(std::thread(worker));
+    }
+    for(std::thread& thread: threads) {
+        thread.join();
+    }
+}
+
+void CompHandler::save_comp_solution(
+    CompToSolve& todo
+    , const size_t num_comps
+) {
+    createRenumbering(todo.vars);
+    check_solution_is_unassigned_in_main_solver(todo.newSolver, todo.vars);
+    save_solution_to_savedstate(todo.newSolver, todo.vars, todo.comp);
+    move_decision_level_zero_vars_here(todo.newSolver);
 
     if (solver->conf.verbosity >= 1 && num_comps < 20) {
         cout
-        << "c [comp] component " << comp_at
-        << " ======================================="
+        << "c [comp] component " << todo.comp_at
+        << " solved"
         << endl;
     }
-    return true;
 }
 
 void CompHandler::check_local_vardata_sanity()
@@ -259,7 +358,7 @@ void CompHandler::check_local_vardata_sanity()
         if (savedState[outerVar] != l_Undef) {
             assert(solver->varData[var].is_decision == false);
             assert(solver->varData[var].removed == Removed::decomposed);
-            assert(solver->value(var) == l_Undef || solver->varData[var].level == 0);
+            assert(solver->value(var) == l_Undef || solver->varLevel[var] == 0);
         }
     }
 }
@@ -316,6 +415,7 @@ void CompHandler::move_decision_level_zero_vars_here(
 
 SolverConf CompHandler::configureNewSolver(
     const size_t numVars
+    , const bool parallel
 ) const {
     SolverConf conf(solver->conf);
     conf.origSeed = solver->mtrand.randInt();
@@ -334,6 +434,11 @@ SolverConf CompHandler::configureNewSolver(
         conf.verbosity = 0;
     }
 
+    //Output of solvers running at the same time would be interleaved
+    if (parallel) {
+        conf.verbosity = std::min(conf.verbosity, 0);
+    }
+
     //Don't recurse
     conf.doCompHandler = false;
 
@@ -436,8 +541,8 @@ void CompHandler::moveClausesLong(
 
         //Add 'tmp' to the new solver
         if (cl.red()) {
-            cl.stats.introduced_at_conflict = 0;
-            //newSolver->addRedClause(tmp, cl.stats);
+            solver->clAllocator.getStats(cl).introduced_at_conflict = 0;
+            //newSolver->addRedClause(tmp, solver->clAllocator.getStats(cl));
         } else {
             saveClause(cl);
             newSolver->add_clause(tmp);
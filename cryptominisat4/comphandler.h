@@ -89,15 +89,35 @@ class CompHandler
             , const vector<Var>& vars
         );
         void check_local_vardata_sanity();
-        bool solve_component(
-            const uint32_t comp_at
-            , const uint32_t comp
-            , const vector<Var>& vars
+
+        ///A component that has been moved to its own sub-solver
+        struct CompToSolve
+        {
+            uint32_t comp_at;
+            uint32_t comp;
+            vector<Var> vars;
+            SATSolver* newSolver; ///<Only set while the component is solved
+            lbool status;
+            bool skipped; ///<Too large or has assumptions, stays in the main solver
+        };
+        bool move_comp_to_new_solver(
+            CompToSolve& todo
+            , const size_t num_comps
+            , const bool parallel
+        );
+        void solve_comps(
+            vector<CompToSolve>& todo
+            , const size_t num_comps
+            , const unsigned num_threads
+        );
+        void save_comp_solution(
+            CompToSolve& todo
             , const size_t num_comps
         );
 
         SolverConf configureNewSolver(
             const size_t numVars
+            , const bool parallel
         ) const;
 
         void moveVariablesBetweenSolvers(
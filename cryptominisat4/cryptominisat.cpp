@@ -22,63 +22,590 @@
 #include "cryptominisat.h"
 #include "solver.h"
 #include "drup.h"
+#include "shareddata.h"
 #include <stdexcept>
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <algorithm>
 
 using namespace CMSat;
 
+namespace CMSat {
+    struct CMSatPrivateData {
+        vector<Solver*> solvers;
+
+        //Which solver's result is to be reported
+        unsigned which_solved = 0;
+
+        //Learnt clause exchange, NULL if not sharing
+        SharedData* shared_data = NULL;
+
+        //Final conflict of the last cube-and-conquer solve() that was UNSAT
+        bool conflict_from_cubes = false;
+        vector<Lit> cube_conflict;
+    };
+}
+
 SATSolver::SATSolver(const SolverConf conf)
 {
-    solver = (void*)(new ::CMSat::Solver(conf));
+    data = new CMSatPrivateData;
+    data->solvers.push_back(new ::CMSat::Solver(conf));
 }
 
 SATSolver::~SATSolver()
 {
-    delete ((CMSat::Solver*)solver);
+    for(Solver* s: data->solvers) {
+        delete s;
+    }
+    delete data->shared_data;
+    delete data;
+}
+
+/**
+@brief Diversifies the configuration of the portfolio's solver instances
+
+Thread 0 always runs with the configuration given by the user. The others
+get a different random seed and a different mix of restart, polarity and
+clause-cleaning strategies so that they do not all explore the same part of
+the search space.
+*/
+static void update_config(SolverConf& conf, const unsigned thread_num)
+{
+    conf.origSeed += thread_num;
+    conf.doSQL = 0;
+    conf.verbosity = 0;
+
+    //The portfolio already keeps the cores busy
+    conf.compNumThreads = 1;
+    switch(thread_num % 8) {
+        case 1:
+            conf.restartType = restart_type_geom;
+            conf.clauseCleaningType = clean_glue_based;
+            break;
+
+        case 2:
+            conf.restartType = restart_type_glue;
+            conf.polarity_mode = polarmode_neg;
+            conf.clauseCleaningType = clean_size_based;
+            break;
+
+        case 3:
+            conf.restartType = restart_type_glue_agility;
+            conf.clauseCleaningType = clean_sum_activity_based;
+            conf.random_var_freq = 0.01;
+            break;
+
+        case 4:
+            conf.restartType = restart_type_geom;
+            conf.polarity_mode = polarmode_pos;
+            conf.clauseCleaningType = clean_sum_confl_depth_based;
+            break;
+
+        case 5:
+            conf.restartType = restart_type_agility;
+            conf.doVarElim = false;
+            conf.clauseCleaningType = clean_glue_based;
+            break;
+
+        case 6:
+            conf.restartType = restart_type_glue;
+            conf.propBinFirst = true;
+            conf.doLHBR = true;
+            conf.random_var_freq = 0.005;
+            break;
+
+        case 7:
+            conf.restartType = restart_type_geom;
+            conf.polarity_mode = polarmode_rnd;
+            conf.increaseClean = 1.2;
+            break;
+
+        default:
+            break;
+    }
+}
+
+void SATSolver::set_num_threads(const unsigned num)
+{
+    if (num == 0) {
+        throw std::runtime_error("ERROR: Number of threads must be at least 1");
+    }
+
+    if (data->solvers.size() > 1
+        || data->solvers[0]->nVarsOutside() > 0
+    ) {
+        throw std::runtime_error(
+            "ERROR: set_num_threads() must be called at most once"
+            ", and before any variables are added");
+    }
+
+    if (data->solvers[0]->drup->enabled()) {
+        throw std::runtime_error("ERROR: DRUP cannot be used with more than one thread");
+    }
+
+    const SolverConf origConf = data->solvers[0]->getConf();
+
+    //The memory budget is for all threads together
+    const unsigned long long memShare = origConf.maxMemMB == 0 ? 0
+        : std::max<unsigned long long>(origConf.maxMemMB/num, 1);
+    data->solvers[0]->conf.maxMemMB = memShare;
+    if (num > 1) {
+        //update_config() does the same for the other threads
+        data->solvers[0]->conf.compNumThreads = 1;
+    }
+    for(unsigned i = 1; i < num; i++) {
+        SolverConf conf = origConf;
+        update_config(conf, i);
+        conf.maxMemMB = memShare;
+        data->solvers.push_back(new ::CMSat::Solver(conf));
+    }
+
+    if (num > 1 && origConf.doShareClauses) {
+        data->shared_data = new SharedData(num, origConf.shareRingSize);
+        for(unsigned i = 0; i < num; i++) {
+            data->solvers[i]->set_shared_data(data->shared_data, i);
+        }
+    }
 }
 
 bool SATSolver::add_clause(const vector< Lit >& lits)
 {
-    return ((CMSat::Solver*)solver)->add_clause_outer(lits);
+    bool ret = true;
+    for(Solver* s: data->solvers) {
+        ret &= s->add_clause_outer(lits);
+    }
+    return ret;
+}
+
+bool SATSolver::add_clauses(const vector< Lit >& lits)
+{
+    bool ret = true;
+    for(Solver* s: data->solvers) {
+        ret &= s->add_clauses_outer(lits);
+    }
+    return ret;
 }
 
 bool SATSolver::add_xor_clause(const std::vector<unsigned>& vars, bool rhs)
 {
-    return ((CMSat::Solver*)solver)->add_xor_clause_outer(vars, rhs);
+    bool ret = true;
+    for(Solver* s: data->solvers) {
+        ret &= s->add_xor_clause_outer(vars, rhs);
+    }
+    return ret;
+}
+
+struct DataForThread
+{
+    DataForThread(CMSatPrivateData* data, const vector<Lit>* _assumptions) :
+        solvers(data->solvers)
+        , assumptions(_assumptions)
+        , which_solved(&(data->which_solved))
+        , ret(l_Undef)
+    {}
+
+    vector<Solver*>& solvers;
+    const vector<Lit>* assumptions;
+    std::mutex update_mutex;
+    unsigned* which_solved;
+    lbool ret;
+};
+
+static void one_thread(DataForThread& data_for_thread, const unsigned tid)
+{
+    const lbool ret = data_for_thread.solvers[tid]->solve_with_assumptions(
+        data_for_thread.assumptions
+    );
+
+    std::lock_guard<std::mutex> lock(data_for_thread.update_mutex);
+    if (ret != l_Undef && data_for_thread.ret == l_Undef) {
+        //First to finish wins, the rest are told to stop
+        data_for_thread.ret = ret;
+        *data_for_thread.which_solved = tid;
+        for(size_t i = 0; i < data_for_thread.solvers.size(); i++) {
+            if (i != tid) {
+                data_for_thread.solvers[i]->setNeedToInterrupt();
+            }
+        }
+    }
+}
+
+/**
+@brief Cubes waiting to be solved, plus the parts of the cubes already refuted
+
+Every worker has its own queue. It takes work from the back of its own queue
+and, once that is empty, steals from the front of the others' queues. Cubes
+close to each other in the split tree are close to each other in the
+queues, so the owner keeps working on similar cubes while thieves take
+far-away ones.
+*/
+struct CubePool
+{
+    CubePool(const vector<vector<Lit> >& cubes, const size_t num_workers) :
+        queues(num_workers)
+        , queue_mutex(num_workers)
+    {
+        //Consecutive blocks, so that each worker starts out on its own subtree
+        for(size_t i = 0; i < cubes.size(); i++) {
+            queues[i*num_workers/cubes.size()].push_back(cubes[i]);
+        }
+    }
+
+    bool get(const unsigned tid, vector<Lit>& cube)
+    {
+        for(size_t i = 0; i < queues.size(); i++) {
+            const size_t at = (tid + i) % queues.size();
+            std::lock_guard<std::mutex> lock(queue_mutex[at]);
+            if (queues[at].empty())
+                continue;
+
+            if (at == tid) {
+                cube = queues[at].back();
+                queues[at].pop_back();
+            } else {
+                cube = queues[at].front();
+                queues[at].pop_front();
+            }
+            return true;
+        }
+
+        return false;
+    }
+
+    ///A cube is covered if it contains every literal of some refuted core
+    bool covered(const vector<Lit>& cube)
+    {
+        std::lock_guard<std::mutex> lock(core_mutex);
+        for(const vector<Lit>& core: cores) {
+            bool all_in = true;
+            for(const Lit lit: core) {
+                if (std::find(cube.begin(), cube.end(), lit) == cube.end()) {
+                    all_in = false;
+                    break;
+                }
+            }
+            if (all_in)
+                return true;
+        }
+
+        return false;
+    }
+
+    void add_core(const vector<Lit>& core)
+    {
+        std::lock_guard<std::mutex> lock(core_mutex);
+        cores.push_back(core);
+    }
+
+    vector<std::deque<vector<Lit> > > queues;
+    vector<std::mutex> queue_mutex;
+    std::mutex core_mutex;
+    vector<vector<Lit> > cores;
+};
+
+struct DataForCubeThread
+{
+    DataForCubeThread(
+        CMSatPrivateData* data
+        , const vector<Lit>* _assumptions
+        , const vector<vector<Lit> >& cubes
+    ) :
+        solvers(data->solvers)
+        , assumptions(_assumptions)
+        , which_solved(&(data->which_solved))
+        , conflict(&(data->cube_conflict))
+        , pool(cubes, data->solvers.size())
+    {}
+
+    vector<Solver*>& solvers;
+    const vector<Lit>* assumptions;
+    std::mutex update_mutex;
+    unsigned* which_solved;
+    vector<Lit>* conflict;
+    CubePool pool;
+    bool finished = false;
+    lbool ret = l_False;
+
+    //Must hold update_mutex
+    void finish(const lbool _ret, const unsigned tid)
+    {
+        finished = true;
+        ret = _ret;
+        *which_solved = tid;
+
+        //When out of time, the others will also stop on their own
+        if (ret == l_Undef)
+            return;
+
+        for(size_t i = 0; i < solvers.size(); i++) {
+            if (i != tid) {
+                solvers[i]->setNeedToInterrupt();
+            }
+        }
+    }
+};
+
+/**
+@brief Splits the final conflict of a refuted cube
+
+The literals of the cube that took part in the refutation are put into 'core',
+the rest (coming from the user's assumptions) into 'rest'. Returns FALSE if
+some literal of the conflict could not be attributed to either.
+*/
+static bool split_cube_conflict(
+    const Solver* solver
+    , const vector<Lit>* assumptions
+    , const vector<Lit>& cube
+    , vector<Lit>& core
+    , vector<Lit>& rest
+) {
+    const vector<Lit>& conflict = solver->get_final_conflict();
+    for(const Lit lit: cube) {
+        const Lit confl_lit = solver->map_assumption_to_conflict(lit);
+        if (std::find(conflict.begin(), conflict.end(), confl_lit) != conflict.end()) {
+            core.push_back(lit);
+        }
+    }
+
+    for(const Lit confl_lit: conflict) {
+        bool found = false;
+        if (assumptions) {
+            for(const Lit lit: *assumptions) {
+                if (solver->map_assumption_to_conflict(lit) == confl_lit) {
+                    found = true;
+                    break;
+                }
+            }
+        }
+        if (found) {
+            rest.push_back(confl_lit);
+            continue;
+        }
+
+        for(const Lit lit: cube) {
+            if (solver->map_assumption_to_conflict(lit) == confl_lit) {
+                found = true;
+                break;
+            }
+        }
+        if (!found)
+            return false;
+    }
+
+    return true;
+}
+
+///Adds all of the user's assumptions to 'conflict', in its numbering
+static void add_assumptions_to_conflict(
+    const Solver* solver
+    , const vector<Lit>* assumptions
+    , vector<Lit>& conflict
+) {
+    if (!assumptions)
+        return;
+
+    for(const Lit lit: *assumptions) {
+        if (lit.var() >= solver->nVarsOutside())
+            continue;
+
+        const Lit confl_lit = solver->map_assumption_to_conflict(lit);
+        if (std::find(conflict.begin(), conflict.end(), confl_lit) == conflict.end()) {
+            conflict.push_back(confl_lit);
+        }
+    }
+}
+
+static void one_cube_thread(DataForCubeThread& data_for_thread, const unsigned tid)
+{
+    Solver* solver = data_for_thread.solvers[tid];
+    vector<Lit> cube;
+    vector<Lit> assumps;
+    vector<Lit> core;
+    vector<Lit> rest;
+    while(data_for_thread.pool.get(tid, cube)) {
+        {
+            std::lock_guard<std::mutex> lock(data_for_thread.update_mutex);
+            if (data_for_thread.finished)
+                return;
+        }
+        if (data_for_thread.pool.covered(cube))
+            continue;
+
+        assumps.clear();
+        if (data_for_thread.assumptions) {
+            assumps = *data_for_thread.assumptions;
+        }
+        assumps.insert(assumps.end(), cube.begin(), cube.end());
+        const lbool ret = solver->solve_with_assumptions(&assumps);
+
+        std::lock_guard<std::mutex> lock(data_for_thread.update_mutex);
+        if (data_for_thread.finished)
+            return;
+
+        if (ret != l_False) {
+            //Either a solution, or we ran out of time -- no point in going on
+            data_for_thread.finish(ret, tid);
+            return;
+        }
+
+        core.clear();
+        rest.clear();
+        if (!split_cube_conflict(solver, data_for_thread.assumptions, cube, core, rest)) {
+            //Could not attribute the conflict, only this cube is refuted. The
+            //cube's literals must not reach the user, the assumptions they
+            //were found under stand in for them.
+            core = cube;
+            rest.clear();
+            bool had_cube_lit = false;
+            for(const Lit confl_lit: solver->get_final_conflict()) {
+                bool in_cube = false;
+                for(const Lit lit: cube) {
+                    if (solver->map_assumption_to_conflict(lit) == confl_lit) {
+                        in_cube = true;
+                        break;
+                    }
+                }
+                if (in_cube) {
+                    had_cube_lit = true;
+                } else {
+                    rest.push_back(confl_lit);
+                }
+            }
+            if (had_cube_lit) {
+                add_assumptions_to_conflict(solver, data_for_thread.assumptions, rest);
+            }
+        }
+
+        vector<Lit>& conflict = *data_for_thread.conflict;
+        if (core.empty()) {
+            //Refuted without relying on the cube: UNSAT under the assumptions
+            conflict = rest;
+            data_for_thread.finish(l_False, tid);
+            return;
+        }
+        for(const Lit lit: rest) {
+            if (std::find(conflict.begin(), conflict.end(), lit) == conflict.end()) {
+                conflict.push_back(lit);
+            }
+        }
+        data_for_thread.pool.add_core(core);
+    }
+}
+
+lbool SATSolver::solve_cubes(vector< Lit >* assumptions)
+{
+    const SolverConf& conf = data->solvers[0]->getConf();
+    unsigned depth = conf.cubeDepth;
+    if (depth == 0) {
+        //Enough cubes for stealing to even out the differences between them
+        while((1U << depth) < data->solvers.size()) {
+            depth++;
+        }
+        depth += 4;
+    }
+    bool usedAssumptions = false;
+    const vector<vector<Lit> > cubes = data->solvers[0]->generate_cubes(
+        assumptions, depth, usedAssumptions);
+
+    data->conflict_from_cubes = true;
+    data->cube_conflict.clear();
+    if (usedAssumptions) {
+        //Branches dropped under the assumptions are refuted by all of them
+        add_assumptions_to_conflict(data->solvers[0], assumptions, data->cube_conflict);
+    }
+    DataForCubeThread data_for_thread(data, assumptions, cubes);
+    vector<std::thread> threads;
+    for(unsigned i = 0; i < data->solvers.size(); i++) {
+        threads.push_back(std::thread(one_cube_thread, std::ref(data_for_thread), i));
+    }
+    for(std::thread& thread: threads) {
+        thread.join();
+    }
+
+    if (data_for_thread.ret != l_Undef) {
+        for(Solver* s: data->solvers) {
+            s->unsetNeedToInterrupt();
+        }
+    }
+
+    return data_for_thread.ret;
 }
 
 lbool SATSolver::solve(vector< Lit >* assumptions)
 {
-    return ((CMSat::Solver*)solver)->solve_with_assumptions(assumptions);
+    data->conflict_from_cubes = false;
+    if (data->solvers.size() == 1) {
+        data->which_solved = 0;
+        return data->solvers[0]->solve_with_assumptions(assumptions);
+    }
+
+    if (data->solvers[0]->getConf().doCubeAndConquer) {
+        return solve_cubes(assumptions);
+    }
+
+    DataForThread data_for_thread(data, assumptions);
+    vector<std::thread> threads;
+    for(unsigned i = 0; i < data->solvers.size(); i++) {
+        threads.push_back(std::thread(one_thread, std::ref(data_for_thread), i));
+    }
+    for(std::thread& thread: threads) {
+        thread.join();
+    }
+
+    //Interrupts were only issued by the winner, so the losers can be
+    //reused for the next solve() call
+    if (data_for_thread.ret != l_Undef) {
+        for(Solver* s: data->solvers) {
+            s->unsetNeedToInterrupt();
+        }
+    }
+
+    return data_for_thread.ret;
 }
 
 const vector< lbool >& SATSolver::get_model() const
 {
-    return (vector<lbool>&)((CMSat::Solver*)solver)->get_model();
+    return data->solvers[data->which_solved]->get_model();
 }
 
 const std::vector<Lit>& SATSolver::get_conflict() const
 {
-    return (vector<Lit>&)(((CMSat::Solver*)solver)->get_final_conflict());
+    if (data->conflict_from_cubes) {
+        return data->cube_conflict;
+    }
+    return data->solvers[data->which_solved]->get_final_conflict();
 }
 
 uint32_t SATSolver::nVars() const
 {
-    return ((CMSat::Solver*)solver)->nVarsOutside();
+    return data->solvers[0]->nVarsOutside();
 }
 
 void SATSolver::new_var()
 {
-    ((CMSat::Solver*)solver)->new_external_var();
+    for(Solver* s: data->solvers) {
+        s->new_external_var();
+    }
+}
+
+void SATSolver::new_vars(const size_t n)
+{
+    for(Solver* s: data->solvers) {
+        s->new_external_vars(n);
+    }
 }
 
 void SATSolver::add_sql_tag(const std::string& tagname, const std::string& tag)
 {
-    ((CMSat::Solver*)solver)->add_sql_tag(tagname, tag);
+    for(Solver* s: data->solvers) {
+        s->add_sql_tag(tagname, tag);
+    }
 }
 
 SolverConf SATSolver::get_conf() const
 {
-    return ((CMSat::Solver*)solver)->getConf();
+    return data->solvers[0]->getConf();
 }
 
 const char* SATSolver::get_version()
@@ -88,43 +615,54 @@ const char* SATSolver::get_version()
 
 void SATSolver::print_stats() const
 {
-    ((CMSat::Solver*)solver)->printStats();
+    if (data->solvers.size() > 1) {
+        cout << "c Statistics of thread " << data->which_solved << endl;
+    }
+    data->solvers[data->which_solved]->printStats();
 }
 
 void SATSolver::set_drup(std::ostream* os)
 {
+    if (data->solvers.size() > 1) {
+        throw std::runtime_error("ERROR: DRUP cannot be used with more than one thread");
+    }
+
     CMSat::DrupFile* drup = new CMSat::DrupFile();
     drup->setFile(os);
-    ((CMSat::Solver*)solver)->drup = drup;
+    data->solvers[0]->drup = drup;
 }
 
 void SATSolver::interrupt_asap()
 {
-    ((CMSat::Solver*)solver)->setNeedToInterrupt();
+    for(Solver* s: data->solvers) {
+        s->setNeedToInterrupt();
+    }
 }
 
 void SATSolver::open_file_and_dump_irred_clauses(std::string fname) const
 {
-    ((CMSat::Solver*)solver)->open_file_and_dump_irred_clauses(fname);
+    data->solvers[data->which_solved]->open_file_and_dump_irred_clauses(fname);
 }
 
 void SATSolver::open_file_and_dump_red_clauses(std::string fname) const
 {
-    ((CMSat::Solver*)solver)->open_file_and_dump_red_clauses(fname);
+    data->solvers[data->which_solved]->open_file_and_dump_red_clauses(fname);
 }
 
 void SATSolver::add_in_partial_solving_stats()
 {
-    ((CMSat::Solver*)solver)->add_in_partial_solving_stats();
+    for(Solver* s: data->solvers) {
+        s->add_in_partial_solving_stats();
+    }
 }
 
 std::vector<Lit> SATSolver::get_zero_assigned_lits() const
 {
-    return ((CMSat::Solver*)solver)->get_zero_assigned_lits();
+    return data->solvers[data->which_solved]->get_zero_assigned_lits();
 }
 
 
 unsigned long SATSolver::get_sql_id() const
 {
-    return ((CMSat::Solver*)solver)->get_sql_id();
+    return data->solvers[0]->get_sql_id();
 }
@@ -13,15 +13,20 @@
 #include "cryptominisat4/solvertypesmini.h"
 
 namespace CMSat {
+    struct CMSatPrivateData;
+
     class SATSolver
     {
     public:
         SATSolver(SolverConf conf = SolverConf());
         ~SATSolver();
+        void set_num_threads(unsigned n); //must be called before adding vars
         unsigned nVars() const;
         bool add_clause(const std::vector<Lit>& lits);
+        bool add_clauses(const std::vector<Lit>& lits); //clauses separated by lit_Undef
         bool add_xor_clause(const std::vector<unsigned>& vars, bool rhs);
         void new_var();
+        void new_vars(const size_t n);
         lbool solve(std::vector<Lit>* assumptions = 0);
         const std::vector<lbool>& get_model() const;
         const std::vector<Lit>& get_conflict() const;
@@ -38,7 +43,8 @@ namespace CMSat {
         void add_in_partial_solving_stats();
         std::vector<Lit> get_zero_assigned_lits() const;
     private:
-        void* solver;
+        lbool solve_cubes(std::vector<Lit>* assumptions);
+        CMSatPrivateData* data;
     };
 }
 
@@ -0,0 +1,253 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.0 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+#include "cubegenerator.h"
+#include "solver.h"
+#include "varreplacer.h"
+#include "time_mem.h"
+#include <algorithm>
+#include <iomanip>
+
+using namespace CMSat;
+using std::cout;
+using std::endl;
+
+CubeGenerator::CubeGenerator(Solver* _solver) :
+    solver(_solver)
+    , bogoPropsLimit(0)
+{}
+
+vector<vector<Lit> > CubeGenerator::generate(
+    const vector<Lit>* assumptions
+    , const unsigned depth
+    , bool& usedAssumptions
+) {
+    assert(solver->decisionLevel() == 0);
+    const double myTime = cpuTime();
+    runStats = Stats();
+    cubes.clear();
+    cube.clear();
+
+    if (solver->okay()) {
+        solver->ok = solver->propagate().isNULL();
+    }
+
+    if (solver->okay() && set_assumptions(assumptions)) {
+        bogoPropsLimit = solver->propStats.bogoProps
+            + solver->conf.cubeTimeLimitM*1000ULL*1000ULL;
+        pick_candidates();
+        split(depth);
+    }
+    solver->cancelUntil(0);
+    usedAssumptions = assumptions != NULL
+        && !assumptions->empty()
+        && (runStats.numRefuted > 0 || runStats.numFailed > 0);
+
+    if (cubes.empty()) {
+        cubes.push_back(vector<Lit>());
+    }
+    runStats.numCubes = cubes.size();
+    runStats.cpu_time = cpuTime() - myTime;
+    if (solver->conf.verbosity >= 1) {
+        runStats.print();
+    }
+
+    return cubes;
+}
+
+bool CubeGenerator::set_assumptions(const vector<Lit>* assumptions)
+{
+    if (!assumptions)
+        return true;
+
+    for(const Lit outside: *assumptions) {
+        if (outside.var() >= solver->nVarsOutside())
+            continue;
+
+        Lit lit = solver->map_to_with_bva(outside);
+        lit = solver->varReplacer->getLitReplacedWithOuter(lit);
+        lit = solver->map_outer_to_inter(lit);
+        if (lit.var() >= solver->nVars()
+            || solver->varData[lit.var()].removed != Removed::none
+            || solver->value(lit) == l_True
+        ) {
+            continue;
+        }
+
+        if (solver->value(lit) == l_False
+            || !propagate_lit(lit)
+        ) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void CubeGenerator::pick_candidates()
+{
+    //Cheap pre-selection based on how many watches the two sides have
+    vector<std::pair<uint64_t, Var> > scored;
+    for(Var var = 0; var < solver->nVars(); var++) {
+        if (solver->value(var) != l_Undef
+            || solver->varData[var].removed != Removed::none
+            || solver->varData[var].is_bva
+        ) {
+            continue;
+        }
+
+        const uint64_t pos = solver->watches[Lit(var, false).toInt()].size();
+        const uint64_t neg = solver->watches[Lit(var, true).toInt()].size();
+        scored.push_back(std::make_pair((pos+1)*(neg+1), var));
+    }
+
+    const size_t num = std::min<size_t>(scored.size(), solver->conf.cubeCandidates);
+    std::partial_sort(
+        scored.begin()
+        , scored.begin() + num
+        , scored.end()
+        , std::greater<std::pair<uint64_t, Var> >()
+    );
+
+    candidates.clear();
+    for(size_t i = 0; i < num; i++) {
+        candidates.push_back(scored[i].second);
+    }
+}
+
+bool CubeGenerator::propagate_lit(const Lit lit)
+{
+    assert(solver->value(lit) == l_Undef);
+    solver->newDecisionLevel();
+    solver->enqueue(lit);
+    return solver->propagate().isNULL();
+}
+
+///Returns the number of literals set, or -1 if 'lit' failed
+int64_t CubeGenerator::lookahead(const Lit lit)
+{
+    runStats.numLookaheads++;
+    const uint32_t level = solver->decisionLevel();
+    const size_t origTrailSize = solver->trail.size();
+    const bool ok = propagate_lit(lit);
+    const int64_t num = solver->trail.size() - origTrailSize;
+    solver->cancelUntil(level);
+
+    return ok ? num : -1;
+}
+
+void CubeGenerator::add_current_cube()
+{
+    vector<Lit> outside;
+    for(const Lit lit: cube) {
+        const Var outer = solver->map_inter_to_outer(lit.var());
+        const Var var = solver->map_outer_to_without_bva(outer);
+        assert(var != var_Undef);
+        outside.push_back(Lit(var, lit.sign()));
+    }
+    cubes.push_back(outside);
+}
+
+void CubeGenerator::split(const unsigned depth)
+{
+    const uint32_t level = solver->decisionLevel();
+    const size_t origCubeSize = cube.size();
+
+    Lit best = lit_Undef;
+    if (depth > 0
+        && solver->propStats.bogoProps < bogoPropsLimit
+    ) {
+        uint64_t bestScore = 0;
+        for(const Var var: candidates) {
+            if (solver->value(var) != l_Undef)
+                continue;
+
+            const int64_t pos = lookahead(Lit(var, false));
+            const int64_t neg = lookahead(Lit(var, true));
+            if (pos < 0 && neg < 0) {
+                //Both sides fail, this cube is refuted
+                runStats.numRefuted++;
+                solver->cancelUntil(level);
+                cube.resize(origCubeSize);
+                return;
+            }
+
+            if (pos < 0 || neg < 0) {
+                //Failed literal, the other side is implied under the cube
+                runStats.numFailed++;
+                const Lit implied = Lit(var, pos < 0);
+                cube.push_back(implied);
+                if (!propagate_lit(implied)) {
+                    runStats.numRefuted++;
+                    solver->cancelUntil(level);
+                    cube.resize(origCubeSize);
+                    return;
+                }
+                continue;
+            }
+
+            const uint64_t score = (uint64_t)(pos+1)*(uint64_t)(neg+1);
+            if (score > bestScore) {
+                bestScore = score;
+                best = Lit(var, neg > pos);
+            }
+        }
+    } else if (depth > 0) {
+        runStats.timedOut = true;
+    }
+
+    //Failed literals found after picking it may have set it
+    if (best != lit_Undef && solver->value(best) != l_Undef) {
+        best = lit_Undef;
+    }
+
+    if (best == lit_Undef) {
+        add_current_cube();
+    } else {
+        for(const Lit lit: {best, ~best}) {
+            const uint32_t branchLevel = solver->decisionLevel();
+            cube.push_back(lit);
+            if (propagate_lit(lit)) {
+                split(depth-1);
+            } else {
+                runStats.numRefuted++;
+            }
+            solver->cancelUntil(branchLevel);
+            cube.pop_back();
+        }
+    }
+
+    solver->cancelUntil(level);
+    cube.resize(origCubeSize);
+}
+
+void CubeGenerator::Stats::print() const
+{
+    cout
+    << "c [cube]"
+    << " cubes: " << numCubes
+    << " refuted: " << numRefuted
+    << " failed-lits: " << numFailed
+    << " lookaheads: " << numLookaheads
+    << " T-out: " << (timedOut ? "Y" : "N")
+    << " T: " << std::fixed << std::setprecision(2) << cpu_time
+    << endl;
+}
@@ -0,0 +1,104 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.0 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+#ifndef __CUBEGENERATOR_H__
+#define __CUBEGENERATOR_H__
+
+#include <vector>
+#include "solvertypes.h"
+
+namespace CMSat {
+
+using std::vector;
+
+class Solver;
+
+/**
+@brief Splits the problem into cubes using lookahead
+
+Every variable among the candidates is propagated both ways, and the one whose
+two sides propagate the most (product of the two) is branched on. Failed
+literals found during the lookahead are added to the cube they were found in,
+and branches where both sides fail are dropped.
+
+The cubes are returned in the numbering seen by the library user, so that they
+can be handed to any solver of the portfolio as assumptions.
+*/
+class CubeGenerator
+{
+    public:
+        CubeGenerator(Solver* solver);
+
+        /**
+        @brief Generates at most 2^depth cubes under the given assumptions
+
+        Never returns an empty set: if everything is refuted during lookahead,
+        a single empty cube is returned and the refutation is left to the
+        search.
+
+        'usedAssumptions' is set if some branch was dropped, or some failed
+        literal added to the cubes, while the assumptions were set. Then the
+        cubes only cover the problem under the assumptions, so a conflict
+        found through them must contain all of them.
+        */
+        vector<vector<Lit> > generate(
+            const vector<Lit>* assumptions
+            , unsigned depth
+            , bool& usedAssumptions
+        );
+
+        struct Stats
+        {
+            void print() const;
+
+            double cpu_time = 0;
+            uint64_t numLookaheads = 0;
+            uint64_t numFailed = 0;
+            uint64_t numCubes = 0;
+            uint64_t numRefuted = 0;
+            bool timedOut = false;
+        };
+        const Stats& getStats() const;
+
+    private:
+        Solver* solver;
+        bool set_assumptions(const vector<Lit>* assumptions);
+        void pick_candidates();
+        void split(unsigned depth);
+        bool propagate_lit(const Lit lit);
+        int64_t lookahead(const Lit lit);
+        void add_current_cube();
+
+        vector<Var> candidates;
+        vector<Lit> cube; ///<Current cube, in the internal numbering
+        vector<vector<Lit> > cubes;
+        uint64_t bogoPropsLimit;
+        Stats runStats;
+};
+
+inline const CubeGenerator::Stats& CubeGenerator::getStats() const
+{
+    return runStats;
+}
+
+} //end namespace
+
+#endif //__CUBEGENERATOR_H__
@@ -6,14 +6,24 @@ File under MIT licence
 ******************************************************************************/
 
 #include "dimacsparser.h"
+#include "binarycnf.h"
 #include <sstream>
 #include <iostream>
 #include <iomanip>
 #include <vector>
 #include <fstream>
 #include <complex>
+#include <deque>
+#include <future>
+#include <thread>
+#include <string.h>
 #include "assert.h"
 
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) \
+    && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define DIMACS_SWAR
+#endif
+
 using std::vector;
 using std::cout;
 using std::endl;
@@ -61,10 +71,96 @@ std::string DimacsParser::untilEnd(StreamBuffer& in)
     return ret;
 }
 
-int32_t DimacsParser::parseInt(StreamBuffer& in, uint32_t& lenParsed)
+#ifdef DIMACS_SWAR
+static const uint64_t dimacs_pow10[9] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000
+};
+
+//Number of leading digits in the 8 chars of "chunk" (first char in the
+//lowest byte). A byte is a digit iff its high nibble is 3 both before and
+//after adding 6. A carry out of a byte can only corrupt bytes after a
+//non-digit, which we never look at.
+static inline uint32_t num_leading_digits(const uint64_t chunk)
+{
+    const uint64_t hi = 0xF0F0F0F0F0F0F0F0ULL;
+    const uint64_t threes = 0x3030303030303030ULL;
+    const uint64_t nondigit = ((chunk & hi) ^ threes)
+        | (((chunk + 0x0606060606060606ULL) & hi) ^ threes);
+
+    if (nondigit == 0)
+        return 8;
+    return __builtin_ctzll(nondigit) / 8;
+}
+
+//Value of the first "n" (1..8) digits of "chunk"
+static inline uint64_t digits_value(uint64_t chunk, const uint32_t n)
+{
+    chunk <<= 8*(8-n);
+    chunk = ((chunk & 0x0F0F0F0F0F0F0F0FULL) * 2561) >> 8;
+    chunk = ((chunk & 0x00FF00FF00FF00FFULL) * 6553601) >> 16;
+    return ((chunk & 0x0000FFFF0000FFFFULL) * 42949672960001ULL) >> 32;
+}
+
+/**
+@brief Reads literals straight from the buffer, 8 digits at a time
+
+Stops, leaving the rest to the character-by-character path, when fewer than
+32 bytes are left, or at anything that is not a plain literal of at most 16
+digits. Returns true if the terminating 0 was read.
+*/
+bool DimacsParser::readClauseFast(StreamBuffer& in)
+{
+    const char* p = in.cur();
+    const char* const end = p + in.avail() - 32;
+    bool done = false;
+    while (p < end) {
+        while (*p == ' ' && p < end)
+            p++;
+        if (p >= end)
+            break;
+
+        const char* const start = p;
+        const bool neg = (*p == '-');
+        p += neg;
+
+        uint64_t chunk;
+        memcpy(&chunk, p, 8);
+        uint32_t n = num_leading_digits(chunk);
+        if (n == 0) {
+            p = start;
+            break;
+        }
+        uint64_t val = digits_value(chunk, n);
+        p += n;
+        if (n == 8) {
+            memcpy(&chunk, p, 8);
+            n = num_leading_digits(chunk);
+            if (n == 8) {
+                p = start;
+                break;
+            }
+            if (n > 0) {
+                val = val*dimacs_pow10[n] + digits_value(chunk, n);
+                p += n;
+            }
+        }
+
+        if (val == 0) {
+            done = true;
+            break;
+        }
+        addLit(neg ? -(int64_t)val : (int64_t)val);
+    }
+    in.advance(p - in.cur());
+
+    return done;
+}
+#endif //DIMACS_SWAR
+
+int64_t DimacsParser::parseInt(StreamBuffer& in, uint32_t& lenParsed)
 {
     lenParsed = 0;
-    int32_t val = 0;
+    uint64_t val = 0;
     bool    neg = false;
     skipWhitespace(in);
     if (*in == '-') {
@@ -87,7 +183,7 @@ int32_t DimacsParser::parseInt(StreamBuffer& in, uint32_t& lenParsed)
         val = val*10 + (*in - '0'),
               ++in;
     }
-    return neg ? -val : val;
+    return neg ? -(int64_t)val : (int64_t)val;
 }
 
 std::string DimacsParser::stringify(uint32_t x)
@@ -106,34 +202,46 @@ void DimacsParser::parseString(StreamBuffer& in, std::string& str)
 {
     str.clear();
     skipWhitespace(in);
-    while (*in != ' ' && *in != '\n') {
+    while (*in != ' ' && *in != '\n' && *in != EOF) {
         str += *in;
         ++in;
     }
 }
 
+void DimacsParser::addLit(const int64_t parsed_lit)
+{
+    const uint64_t var = std::abs(parsed_lit)-1;
+    if (var >= (1ULL<<28)) {
+        cout
+        << "ERROR! Variable requested is far too large: "
+        << var << endl
+        << "--> At line " << lineNum+1
+        << endl;
+        std::exit(-1);
+    }
+
+    if (var >= numVarsKnown) {
+        while (var >= solver->nVars()) {
+            solver->new_var();
+        }
+        numVarsKnown = solver->nVars();
+    }
+    lits.push_back(Lit(var, parsed_lit < 0));
+}
+
 void DimacsParser::readClause(StreamBuffer& in)
 {
-    int32_t parsed_lit;
-    uint32_t var;
+    int64_t parsed_lit;
     uint32_t len;
     for (;;) {
+        #ifdef DIMACS_SWAR
+        if (in.avail() > 32 && readClauseFast(in))
+            break;
+        #endif
+
         parsed_lit = parseInt(in, len);
         if (parsed_lit == 0) break;
-        var = abs(parsed_lit)-1;
-        if (var >= (1ULL<<28)) {
-            cout
-            << "ERROR! Variable requested is far too large: "
-            << var << endl
-            << "--> At line " << lineNum+1
-            << endl;
-            std::exit(-1);
-        }
-
-        while (var >= solver->nVars()) {
-            solver->new_var();
-        }
-        lits.push_back( (parsed_lit > 0) ? Lit(var, false) : Lit(var, true) );
+        addLit(parsed_lit);
     }
 }
 
@@ -178,7 +286,15 @@ void DimacsParser::parseSolveComment(StreamBuffer& in)
         assumps.push_back(Lit(std::abs(lit)-1, lit < 0));
         skipWhitespace(in);
     }
+    solve_debuglib_part(assumps);
+}
 
+/**
+@brief Solves under the assumptions, and writes the result to the next
+debugLibPart file
+*/
+void DimacsParser::solve_debuglib_part(vector<Lit>& assumps)
+{
     if (solver->get_conf().verbosity >= 2) {
         cout
         << "c -----------> Solver::solve() called (number: "
@@ -250,13 +366,33 @@ void DimacsParser::parseComments(StreamBuffer& in, const std::string str)
     skipLine(in);
 }
 
+/**
+@brief Clauses are handed to the solver in batches
+
+This saves a call and a couple of vector copies per clause in each solver.
+The batch must be flushed before anything else is done to the solver.
+*/
 void DimacsParser::parse_and_add_clause(StreamBuffer& in)
 {
     lits.clear();
     readClause(in);
     skipLine(in);
-    solver->add_clause(lits);
+    clause_batch.insert(clause_batch.end(), lits.begin(), lits.end());
+    clause_batch.push_back(lit_Undef);
     norm_clauses_added++;
+
+    if (clause_batch.size() >= (1U << 16)) {
+        flush_clauses();
+    }
+}
+
+void DimacsParser::flush_clauses()
+{
+    if (clause_batch.empty())
+        return;
+
+    solver->add_clauses(clause_batch);
+    clause_batch.clear();
 }
 
 void DimacsParser::parse_and_add_xor_clause(StreamBuffer& in)
@@ -287,17 +423,20 @@ void DimacsParser::parse_DIMACS_main(StreamBuffer& in)
         skipWhitespace(in);
         switch (*in) {
         case EOF:
+            flush_clauses();
             return;
         case 'p':
             printHeader(in);
             skipLine(in);
             break;
         case 'c':
+            flush_clauses();
             ++in;
             parseString(in, str);
             parseComments(in, str);
             break;
         case 'x':
+            flush_clauses();
             ++in;
             parse_and_add_xor_clause(in);
             break;
@@ -315,14 +454,29 @@ void DimacsParser::parse_DIMACS_main(StreamBuffer& in)
     }
 }
 
-template <class T> void DimacsParser::parse_DIMACS(T input_stream)
+void DimacsParser::parse_DIMACS(InputReader* input)
 {
     debugLibPart = 1;
     const uint32_t origNumVars = solver->nVars();
 
-    StreamBuffer in(input_stream);
+    StreamBuffer in(input);
+    if (BinaryCnf::is_binary(in.cur(), in.avail())) {
+        //Piped or compressed binary file, it is decoded from memory
+        std::vector<char> data;
+        while (in.avail() > 0) {
+            data.insert(data.end(), in.cur(), in.cur() + in.avail());
+            in.advance(in.avail());
+        }
+        parse_binary(data.data(), data.size());
+        return;
+    }
+
     parse_DIMACS_main(in);
+    print_parse_stats(origNumVars);
+}
 
+void DimacsParser::print_parse_stats(const uint32_t origNumVars) const
+{
     if (solver->get_conf().verbosity >= 1) {
         cout
         << "c -- clauses added: " << norm_clauses_added << endl
@@ -332,8 +486,420 @@ template <class T> void DimacsParser::parse_DIMACS(T input_stream)
     }
 }
 
-#ifdef USE_ZLIB
-template void DimacsParser::parse_DIMACS(gzFile input_stream);
-#else
-template void DimacsParser::parse_DIMACS(FILE* input_stream);
-#endif
+namespace {
+
+static inline bool is_dimacs_space(const char c)
+{
+    return (c >= 9 && c <= 13 && c != 10) || c == 32;
+}
+
+/**
+@brief A piece of the input, tokenised by a worker thread
+
+Plain clause lines become literals, each clause ended by lit_Undef. Every
+other line (comments, XORs, the header, empty or malformed lines) becomes
+an event, that the main thread parses with the sequential code, in order.
+*/
+struct ParsedChunk
+{
+    struct Event
+    {
+        const char* line;
+        size_t line_len; ///<Including the line end
+        size_t line_num; ///<Lines in the chunk before this one
+        size_t lits_at; ///<Literals of the clauses before this event
+        uint32_t num_vars; ///<Variables needed by the clauses before this event
+    };
+
+    vector<Lit> lits;
+    vector<Event> events;
+    uint32_t num_vars = 0; ///<Variables needed by the clauses after the last event
+    size_t num_lines = 0;
+    size_t num_clauses = 0;
+};
+
+/**
+@brief Parses a literal at "p". Returns false if there is none, or it's odd
+
+Numbers that need special care (too long, too large, '+' signs next to
+anything strange) are left to the sequential parser.
+*/
+static inline bool tokenise_int(
+    const char*& p
+    , const char* const file_end
+    , int64_t& ret
+) {
+    const char* at = p;
+    const bool neg = (*at == '-');
+    at += (*at == '-' || *at == '+');
+
+    uint64_t val = 0;
+    #ifdef DIMACS_SWAR
+    if (file_end - at >= 16) {
+        uint64_t chunk;
+        memcpy(&chunk, at, 8);
+        uint32_t n = num_leading_digits(chunk);
+        if (n == 0)
+            return false;
+        val = digits_value(chunk, n);
+        at += n;
+        if (n == 8) {
+            memcpy(&chunk, at, 8);
+            n = num_leading_digits(chunk);
+            if (n == 8)
+                return false;
+            if (n > 0) {
+                val = val*dimacs_pow10[n] + digits_value(chunk, n);
+                at += n;
+            }
+        }
+    } else
+    #endif
+    {
+        const char* const start = at;
+        while (at < file_end && *at >= '0' && *at <= '9' && at - start < 16) {
+            val = val*10 + (*at - '0');
+            at++;
+        }
+        if (at == start || (at < file_end && *at >= '0' && *at <= '9'))
+            return false;
+    }
+
+    if (val > (1ULL<<28))
+        return false;
+
+    p = at;
+    ret = neg ? -(int64_t)val : (int64_t)val;
+    return true;
+}
+
+/**
+@brief Tokenises the lines in [begin, end). Runs on a worker thread
+
+Touches nothing but "out", in particular it never calls the solver.
+*/
+static void tokenise_chunk(
+    const char* const begin
+    , const char* const end
+    , const char* const file_end
+    , ParsedChunk& out
+) {
+    const char* p = begin;
+    uint32_t num_vars = 0;
+    while (p < end) {
+        const char* const line = p;
+        const size_t lits_at = out.lits.size();
+        bool plain = false;
+
+        while (p < end && is_dimacs_space(*p))
+            p++;
+
+        int64_t val;
+        while (p < end && *p != '\n' && tokenise_int(p, file_end, val)) {
+            if (val == 0) {
+                while (p < end && is_dimacs_space(*p))
+                    p++;
+                plain = (p == end || *p == '\n');
+                break;
+            }
+            const uint32_t var = std::abs(val)-1;
+            num_vars = std::max(num_vars, var+1);
+            out.lits.push_back(Lit(var, val < 0));
+            if (p < end && !is_dimacs_space(*p) && *p != '-')
+                break;
+            while (p < end && is_dimacs_space(*p))
+                p++;
+        }
+
+        while (p < end && *p != '\n')
+            p++;
+        if (p < end)
+            p++;
+
+        if (plain) {
+            out.lits.push_back(lit_Undef);
+            out.num_clauses++;
+        } else {
+            out.lits.resize(lits_at);
+            ParsedChunk::Event ev;
+            ev.line = line;
+            ev.line_len = p - line;
+            ev.line_num = out.num_lines;
+            ev.lits_at = lits_at;
+            ev.num_vars = num_vars;
+            out.events.push_back(ev);
+            num_vars = 0;
+        }
+        out.num_lines++;
+    }
+    out.num_vars = num_vars;
+}
+
+}
+
+void DimacsParser::add_tokenised(
+    const vector<Lit>& tokens
+    , const size_t from
+    , const size_t to
+    , const uint32_t num_vars
+) {
+    if (from == to)
+        return;
+
+    if (num_vars > numVarsKnown) {
+        while (solver->nVars() < num_vars) {
+            solver->new_var();
+        }
+        numVarsKnown = solver->nVars();
+    }
+
+    if (from == 0 && to == tokens.size()) {
+        solver->add_clauses(tokens);
+    } else {
+        clause_batch.assign(tokens.begin() + from, tokens.begin() + to);
+        flush_clauses();
+    }
+}
+
+/**
+@brief Splits the file at line ends and tokenises the pieces in parallel
+
+The pieces are handed to the solver by this thread, in file order, while
+the workers are busy with the next ones. Lines the workers leave alone are
+parsed here with the sequential code, so the result is the same as that
+of parse_DIMACS(), solve comments and XORs included.
+*/
+void DimacsParser::parse_DIMACS_parallel(
+    const char* const data
+    , const size_t len
+    , unsigned numThreads
+    , const size_t chunkSize
+) {
+    if (numThreads == 0) {
+        numThreads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    debugLibPart = 1;
+    const uint32_t origNumVars = solver->nVars();
+    if (numThreads <= 1 || len < 2*chunkSize) {
+        StreamBuffer in(data, len);
+        parse_DIMACS_main(in);
+        print_parse_stats(origNumVars);
+        return;
+    }
+
+    const char* const file_end = data + len;
+    const char* next = data;
+    std::deque<std::future<ParsedChunk> > inFlight;
+    size_t line_at = 0;
+
+    for (;;) {
+        //Keep every worker busy, and a couple of pieces ready
+        while (inFlight.size() < 2*numThreads && next < file_end) {
+            const char* const begin = next;
+            const char* end = std::min(begin + chunkSize, file_end);
+            const void* nl = memchr(end, '\n', file_end - end);
+            end = (nl == NULL) ? file_end : (const char*)nl + 1;
+            next = end;
+
+            inFlight.push_back(std::async(std::launch::async,
+                [begin, end, file_end]() {
+                    ParsedChunk chunk;
+                    tokenise_chunk(begin, end, file_end, chunk);
+                    return chunk;
+                }
+            ));
+        }
+        if (inFlight.empty())
+            break;
+
+        const ParsedChunk chunk = inFlight.front().get();
+        inFlight.pop_front();
+
+        size_t at = 0;
+        for (const ParsedChunk::Event& ev: chunk.events) {
+            add_tokenised(chunk.lits, at, ev.lits_at, ev.num_vars);
+            at = ev.lits_at;
+
+            lineNum = line_at + ev.line_num;
+            StreamBuffer in(ev.line, ev.line_len);
+            parse_DIMACS_main(in);
+        }
+        add_tokenised(chunk.lits, at, chunk.lits.size(), chunk.num_vars);
+        norm_clauses_added += chunk.num_clauses;
+        line_at += chunk.num_lines;
+    }
+
+    print_parse_stats(origNumVars);
+}
+
+void DimacsParser::binary_error(const char* what) const
+{
+    cout << "PARSE ERROR! Binary CNF file " << what << endl;
+    std::exit(3);
+}
+
+void DimacsParser::ensure_vars(const uint64_t maxVar)
+{
+    if (maxVar >= (1ULL<<28)) {
+        cout
+        << "ERROR! Variable requested is far too large: "
+        << maxVar << endl;
+        std::exit(-1);
+    }
+
+    if (maxVar >= solver->nVars()) {
+        solver->new_vars(maxVar + 1 - solver->nVars());
+    }
+}
+
+/**
+@brief Loads a file written by cnf2bin, see BinaryCnf
+
+Each clause section is decoded into one batch, the variables it needs are
+created in one go, and the batch is handed over with a single call. Vars
+are created section by section rather than all up front, so that new_var
+and solve comments see the same solver as with the DIMACS original.
+*/
+void DimacsParser::parse_binary(const char* const data, const size_t len)
+{
+    using namespace BinaryCnf;
+
+    debugLibPart = 1;
+    const uint32_t origNumVars = solver->nVars();
+
+    const unsigned char* p = (const unsigned char*)data;
+    const unsigned char* const end = p + len;
+    if (len < headerSize || !is_binary(data, len)) {
+        binary_error("has no valid header");
+    }
+    const uint32_t fileVersion = get_u64(p + 8) & 0xffffffffU;
+    if (fileVersion != version) {
+        cout
+        << "PARSE ERROR! Binary CNF file is version " << fileVersion
+        << ", only version " << version << " is supported"
+        << endl;
+        std::exit(3);
+    }
+    const uint64_t headerVars = get_u64(p + 16);
+    if (solver->get_conf().verbosity >= 1) {
+        cout << "c -- header says num vars:   " << std::setw(12) << headerVars << endl;
+        cout << "c -- header says num clauses:" << std::setw(12) << get_u64(p + 24) << endl;
+        cout << "c -- header says num xors:   " << std::setw(12) << get_u64(p + 32) << endl;
+    }
+    p += headerSize;
+
+    vector<unsigned> vars;
+    bool done = false;
+    while (!done) {
+        if (p == end)
+            binary_error("is truncated");
+        const char tag = *p++;
+        uint64_t sectionLen;
+        if (!get_varint(p, end, sectionLen) || sectionLen > (uint64_t)(end - p))
+            binary_error("is truncated");
+        const unsigned char* const sectionEnd = p + sectionLen;
+        uint64_t num;
+        if (!get_varint(p, sectionEnd, num))
+            binary_error("is corrupt");
+
+        uint64_t maxVar = 0;
+        uint64_t size;
+        uint32_t prev = 0;
+        switch (tag) {
+        case 'C':
+        case 'S':
+            clause_batch.clear();
+            for(uint64_t i = 0; i < num; i++) {
+                if (!get_varint(p, sectionEnd, size) || size > sectionLen)
+                    binary_error("is corrupt");
+                for(uint64_t at = 0; at < size; at++) {
+                    uint64_t x;
+                    bool ok;
+                    if (at == 0) {
+                        ok = get_varint(p, sectionEnd, x) && x <= 0xffffffffULL;
+                    } else {
+                        ok = get_delta(p, sectionEnd, prev, prev);
+                        x = prev;
+                    }
+                    if (!ok || (x >> 1) >= headerVars)
+                        binary_error("is corrupt");
+                    prev = x;
+                    maxVar = std::max<uint64_t>(maxVar, x >> 1);
+                    clause_batch.push_back(Lit::toLit(x));
+                }
+                clause_batch.push_back(lit_Undef);
+            }
+            if (p != sectionEnd || (tag == 'S' && num != 1))
+                binary_error("is corrupt");
+
+            if (tag == 'C') {
+                if (clause_batch.size() > num)
+                    ensure_vars(maxVar);
+                flush_clauses();
+                norm_clauses_added += num;
+            } else {
+                //The assumptions, without the lit_Undef
+                lits.assign(clause_batch.begin(), clause_batch.end() - 1);
+                clause_batch.clear();
+                if (debugLib) {
+                    solve_debuglib_part(lits);
+                }
+            }
+            break;
+
+        case 'X':
+            for(uint64_t i = 0; i < num; i++) {
+                if (!get_varint(p, sectionEnd, size))
+                    binary_error("is corrupt");
+                const bool rhs = size & 1;
+                size >>= 1;
+                if (size > sectionLen)
+                    binary_error("is corrupt");
+                vars.clear();
+                maxVar = 0;
+                for(uint64_t at = 0; at < size; at++) {
+                    uint64_t x;
+                    bool ok;
+                    if (at == 0) {
+                        ok = get_varint(p, sectionEnd, x) && x <= 0xffffffffULL;
+                    } else {
+                        ok = get_delta(p, sectionEnd, prev, prev);
+                        x = prev;
+                    }
+                    if (!ok || x >= headerVars)
+                        binary_error("is corrupt");
+                    prev = x;
+                    maxVar = std::max<uint64_t>(maxVar, x);
+                    vars.push_back(x);
+                }
+                if (vars.empty())
+                    continue;
+                ensure_vars(maxVar);
+                solver->add_xor_clause(vars, rhs);
+                xor_clauses_added++;
+            }
+            if (p != sectionEnd)
+                binary_error("is corrupt");
+            break;
+
+        case 'V':
+            if (debugLib) {
+                for(uint64_t i = 0; i < num; i++) {
+                    solver->new_var();
+                }
+            }
+            break;
+
+        case 'E':
+            done = true;
+            break;
+
+        default:
+            //Written by a newer version, not needed to solve
+            break;
+        }
+        p = sectionEnd;
+    }
+
+    print_parse_stats(origNumVars);
+}
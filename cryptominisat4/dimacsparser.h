@@ -12,10 +12,6 @@ File under MIT licence.
 #include "streambuffer.h"
 #include "cryptominisat.h"
 
-#ifdef USE_ZLIB
-#include <zlib.h>
-#endif
-
 using namespace CMSat;
 
 class DimacsParser
@@ -23,16 +19,25 @@ class DimacsParser
     public:
         DimacsParser(SATSolver* solver, const bool debugLib);
 
-        template <class T> void parse_DIMACS(T input_stream);
+        void parse_DIMACS(InputReader* input);
+        void parse_DIMACS_parallel(
+            const char* data
+            , size_t len
+            , unsigned numThreads
+            , size_t chunkSize = 16ULL*1024ULL*1024ULL ///<Tests lower it to get many pieces out of a small file
+        );
+        void parse_binary(const char* data, size_t len);
 
     private:
         void parse_DIMACS_main(StreamBuffer& in);
         void skipWhitespace(StreamBuffer& in);
         void skipLine(StreamBuffer& in);
         std::string untilEnd(StreamBuffer& in);
-        int32_t parseInt(StreamBuffer& in, uint32_t& len);
+        int64_t parseInt(StreamBuffer& in, uint32_t& len);
         void parseString(StreamBuffer& in, std::string& str);
         void readClause(StreamBuffer& in);
+        bool readClauseFast(StreamBuffer& in);
+        void addLit(const int64_t parsed_lit);
         void parse_and_add_clause(StreamBuffer& in);
         void parse_and_add_xor_clause(StreamBuffer& in);
         bool match(StreamBuffer& in, const char* str);
@@ -40,6 +45,17 @@ class DimacsParser
         void parseComments(StreamBuffer& in, const std::string str);
         std::string stringify(uint32_t x);
         void parseSolveComment(StreamBuffer& in);
+        void solve_debuglib_part(std::vector<Lit>& assumps);
+        void binary_error(const char* what) const;
+        void ensure_vars(uint64_t maxVar);
+        void flush_clauses();
+        void add_tokenised(
+            const std::vector<Lit>& tokens
+            , size_t from
+            , size_t to
+            , uint32_t num_vars
+        );
+        void print_parse_stats(uint32_t origNumVars) const;
 
 
         SATSolver* solver;
@@ -50,8 +66,10 @@ class DimacsParser
 
         uint32_t debugLibPart; ///<printing partial solutions to debugLibPart1..N.output when "debugLib" is set to TRUE
         std::vector<Lit> lits; ///<To reduce temporary creation overhead
+        std::vector<Lit> clause_batch; ///<Clauses not yet handed over, separated by lit_Undef
         size_t norm_clauses_added = 0;
         size_t xor_clauses_added = 0;
+        uint32_t numVarsKnown = 0; ///<Lower bound on solver->nVars(), saves a call per literal
 };
 
 #endif //DIMACSPARSER_H
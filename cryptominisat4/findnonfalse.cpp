@@ -0,0 +1,80 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.0 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+#include "findnonfalse.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FINDNONFALSE_AVX2
+#include <immintrin.h>
+#endif
+
+using namespace CMSat;
+
+#ifdef FINDNONFALSE_AVX2
+static_assert(sizeof(Lit) == sizeof(uint32_t), "The AVX2 kernel loads literals as 32-bit words");
+static_assert(sizeof(lbool) == 1, "The AVX2 kernel expects one byte per assignment");
+
+/**
+@brief Checks 8 literals at a time
+
+The assignments are fetched with a single gather. l_True is 1, l_False is -1
+and the sign of the literal flips the value, so a literal is false iff its
+variable's byte is 2*sign-1.
+*/
+__attribute__((target("avx2")))
+static Lit* find_non_false_avx2(Lit* k, Lit* end, const lbool* assigns)
+{
+    const __m256i one = _mm256_set1_epi32(1);
+    for(; end - k >= 8; k += 8) {
+        const __m256i lits = _mm256_loadu_si256((const __m256i*)k);
+        const __m256i vars = _mm256_srli_epi32(lits, 1);
+        const __m256i signs = _mm256_and_si256(lits, one);
+
+        __m256i vals = _mm256_i32gather_epi32((const int*)assigns, vars, 1);
+        vals = _mm256_srai_epi32(_mm256_slli_epi32(vals, 24), 24);
+
+        const __m256i falseVal = _mm256_sub_epi32(_mm256_add_epi32(signs, signs), one);
+        const __m256i isFalse = _mm256_cmpeq_epi32(vals, falseVal);
+        const unsigned mask = _mm256_movemask_ps(_mm256_castsi256_ps(isFalse));
+        if (mask != 0xFF) {
+            return k + __builtin_ctz(~mask);
+        }
+    }
+
+    return find_non_false_scalar(k, end, assigns);
+}
+#endif //FINDNONFALSE_AVX2
+
+static Lit* find_non_false_scalar_noinline(Lit* k, Lit* end, const lbool* assigns)
+{
+    return find_non_false_scalar(k, end, assigns);
+}
+
+NonFalseFinder CMSat::get_non_false_finder(const bool allow_simd)
+{
+    #ifdef FINDNONFALSE_AVX2
+    if (allow_simd && __builtin_cpu_supports("avx2")) {
+        return find_non_false_avx2;
+    }
+    #endif
+
+    return find_non_false_scalar_noinline;
+}
@@ -0,0 +1,84 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.0 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+#ifndef __FINDNONFALSE_H__
+#define __FINDNONFALSE_H__
+
+#include "solvertypes.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace CMSat {
+
+/**
+@brief Allocator for 'assigns' that leaves a few bytes of slack at the end
+
+The vectorised search below loads 32 bits from &assigns[var] and only looks
+at the lowest byte, so up to 3 bytes past the last variable are read.
+*/
+template<class T>
+struct GatherPaddedAllocator : public std::allocator<T>
+{
+    template<class U> struct rebind
+    {
+        typedef GatherPaddedAllocator<U> other;
+    };
+
+    GatherPaddedAllocator() {}
+
+    template<class U>
+    GatherPaddedAllocator(const GatherPaddedAllocator<U>&) {}
+
+    T* allocate(std::size_t n, const void* = 0)
+    {
+        return (T*)::operator new(n*sizeof(T) + sizeof(uint32_t));
+    }
+
+    void deallocate(T* p, std::size_t)
+    {
+        ::operator delete(p);
+    }
+};
+
+typedef Lit* (*NonFalseFinder)(Lit* k, Lit* end, const lbool* assigns);
+
+///Returns the first literal in [k, end) that is not false, or 'end'
+inline Lit* find_non_false_scalar(Lit* k, Lit* end, const lbool* assigns)
+{
+    for(; k != end; k++) {
+        if ((assigns[k->var()] ^ k->sign()) != l_False)
+            return k;
+    }
+
+    return end;
+}
+
+/**
+@brief Returns the fastest implementation the CPU we are running on supports
+
+If 'allow_simd' is FALSE, the scalar version is returned.
+*/
+NonFalseFinder get_non_false_finder(bool allow_simd);
+
+} //end namespace
+
+#endif //__FINDNONFALSE_H__
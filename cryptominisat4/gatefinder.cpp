@@ -263,7 +263,7 @@ void GateFinder::or_gates_in_sweep_mode(const Lit lit)
     }
 
     if (solver->conf.doCache && solver->conf.otfHyperbin) {
-        const vector<LitExtra>& cache = solver->implCache[lit.toInt()].lits;
+        const TransCache& cache = solver->implCache[lit.toInt()];
         *simplifier->limit_to_decrease -= cache.size();
         for(const LitExtra l: cache) {
              if (l.getOnlyIrredBin()) {
@@ -388,7 +388,7 @@ bool GateFinder::shortenWithOrGate(const OrGate& gate)
 
         //Future clause's stat
         const bool red = cl.red();
-        const ClauseStats stats = cl.stats;
+        const ClauseStats stats = solver->clAllocator.getStats(cl);
 
         //Free the old clause and allocate new one
         (*solver->drup) << deldelay << cl << fin;
@@ -797,7 +797,10 @@ void GateFinder::treatAndGateClause(
     //Calculate learnt & glue
     const Clause& other_cl = *solver->clAllocator.getPointer(other_cl_offset);
     const bool red = other_cl.red() && this_cl.red();
-    ClauseStats stats = ClauseStats::combineStats(this_cl.stats, other_cl.stats);
+    ClauseStats stats = ClauseStats::combineStats(
+        solver->clAllocator.getStats(this_cl)
+        , solver->clAllocator.getStats(other_cl)
+    );
 
     if (solver->conf.verbosity >= 6) {
         cout << "gate new clause:" << lits << endl;
@@ -0,0 +1,417 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.0 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+#include "gaussian.h"
+#include "solver.h"
+#include "clauseallocator.h"
+#include "time_mem.h"
+
+#include <limits>
+#include <numeric>
+#include <iomanip>
+using namespace CMSat;
+using std::cout;
+using std::endl;
+
+static const uint32_t col_none = std::numeric_limits<uint32_t>::max();
+
+Gaussian::Gaussian(
+    Solver* _solver
+    , const vector<Xor>& _xors
+    , const uint32_t _matrix_no
+) :
+    solver(_solver)
+    , matrix_no(_matrix_no)
+    , xors(_xors)
+{
+    for(const Xor& x: xors) {
+        col_to_var.insert(col_to_var.end(), x.vars.begin(), x.vars.end());
+    }
+    std::sort(col_to_var.begin(), col_to_var.end());
+    col_to_var.erase(
+        std::unique(col_to_var.begin(), col_to_var.end())
+        , col_to_var.end()
+    );
+}
+
+bool Gaussian::init()
+{
+    assert(solver->decisionLevel() == 0);
+    const double myTime = cpuTime();
+
+    const uint32_t numCols = col_to_var.size();
+    vector<uint32_t> var_to_col(solver->nVars(), col_none);
+    for(uint32_t col = 0; col < numCols; col++) {
+        var_to_col[col_to_var[col]] = col;
+    }
+    mat.resize(xors.size(), numCols);
+    for(uint32_t row = 0; row < xors.size(); row++) {
+        for(const Var var: xors[row].vars) {
+            assert(solver->value(var) == l_Undef);
+            mat.flip(row, var_to_col[var]);
+        }
+        if (xors[row].rhs) {
+            mat.flipRhs(row);
+        }
+    }
+
+    //Reduced row echelon form
+    uint32_t numPivots = 0;
+    basic.clear();
+    for(uint32_t col = 0; col < numCols && numPivots < mat.getNumRows(); col++) {
+        uint32_t row = numPivots;
+        while(row < mat.getNumRows() && !mat.get(row, col)) {
+            row++;
+        }
+        if (row == mat.getNumRows())
+            continue;
+
+        mat.swapRows(row, numPivots);
+        for(uint32_t row2 = 0; row2 < mat.getNumRows(); row2++) {
+            if (row2 != numPivots && mat.get(row2, col)) {
+                mat.addRow(row2, numPivots);
+            }
+        }
+        basic.push_back(col);
+        numPivots++;
+    }
+
+    //The rest are empty, 0 = 1 means UNSAT
+    for(uint32_t row = numPivots; row < mat.getNumRows(); row++) {
+        if (mat.getRhs(row)) {
+            stats.initTime += cpuTime() - myTime;
+            return false;
+        }
+    }
+
+    //Rows of a single variable are units. No other row has that variable
+    uint32_t kept = 0;
+    for(uint32_t row = 0; row < numPivots; row++) {
+        uint32_t numSet = 0;
+        mat.forEachSet(row, [&](uint32_t) {numSet++;});
+        if (numSet == 1) {
+            const Lit lit = Lit(col_to_var[basic[row]], !mat.getRhs(row));
+            assert(solver->value(lit) == l_Undef);
+            solver->enqueue(lit);
+            continue;
+        }
+
+        mat.swapRows(kept, row);
+        basic[kept] = basic[row];
+        kept++;
+    }
+    mat.shrink(kept);
+    basic.resize(kept);
+
+    watch.assign(2*kept, col_none);
+    for(uint32_t row = 0; row < kept; row++) {
+        uint32_t other = col_none;
+        mat.forEachSet(row, [&](uint32_t col) {
+            if (other == col_none && col != basic[row])
+                other = col;
+        });
+        set_watches(row, basic[row], other);
+    }
+
+    stats.numMatrixes = 1;
+    stats.numRows = kept;
+    stats.numCols = numCols;
+    stats.initTime += cpuTime() - myTime;
+    if (solver->conf.verbosity >= 2) {
+        cout
+        << "c [gauss] matrix " << matrix_no
+        << " xors: " << xors.size()
+        << " rows: " << kept
+        << " cols: " << numCols
+        << " T: " << std::setprecision(2) << std::fixed << (cpuTime() - myTime)
+        << endl;
+    }
+
+    return true;
+}
+
+bool Gaussian::find_truths(const uint32_t row, const Var var, PropBy& confl)
+{
+    //Stale entry, the row has moved its watch since
+    if (col_to_var[watch[2*row]] != var
+        && col_to_var[watch[2*row+1]] != var
+    ) {
+        return false;
+    }
+
+    if (check_row(row, confl)) {
+        recheck(confl);
+    }
+
+    return col_to_var[watch[2*row]] == var
+        || col_to_var[watch[2*row+1]] == var;
+}
+
+bool Gaussian::recheck(PropBy& confl)
+{
+    while(!to_recheck.empty()) {
+        const uint32_t row = to_recheck.back();
+        to_recheck.pop_back();
+        if (!check_row(row, confl))
+            return false;
+    }
+
+    return true;
+}
+
+/**
+@brief Propagates or finds a conflict with the row, or moves its watches
+
+@returns FALSE if the row is falsified
+*/
+bool Gaussian::check_row(const uint32_t row, PropBy& confl)
+{
+    const uint32_t b = basic[row];
+    bool basicUndef = false;
+    uint32_t numUndef = 0;
+    uint32_t undef[2] = {col_none, col_none};
+    uint32_t top[2] = {col_none, col_none}; ///<Assigned columns of the highest levels
+    uint32_t topLevel[2] = {0, 0};
+    bool parity = mat.getRhs(row);
+    mat.forEachSet(row, [&](uint32_t col) {
+        const Var var = col_to_var[col];
+        const lbool val = solver->value(var);
+        if (val == l_Undef) {
+            basicUndef |= (col == b);
+            if (numUndef < 2)
+                undef[numUndef] = col;
+            numUndef++;
+            return;
+        }
+
+        parity ^= (val == l_True);
+        const uint32_t level = solver->varLevel[var];
+        if (top[0] == col_none || level > topLevel[0]) {
+            top[1] = top[0];
+            topLevel[1] = topLevel[0];
+            top[0] = col;
+            topLevel[0] = level;
+        } else if (top[1] == col_none || level > topLevel[1]) {
+            top[1] = col;
+            topLevel[1] = level;
+        }
+    });
+
+    if (numUndef >= 2) {
+        uint32_t other;
+        if (basicUndef) {
+            other = (undef[0] == b) ? undef[1] : undef[0];
+        } else {
+            pivot(row, undef[0]);
+            other = undef[1];
+        }
+        set_watches(row, basic[row], other);
+
+        return true;
+    }
+
+    //A single variable in the row is a fact, the CNF takes care of it
+    if (top[0] == col_none || (numUndef == 0 && top[1] == col_none))
+        return true;
+
+    if (numUndef == 1) {
+        set_watches(row, undef[0], top[0]);
+        const Lit lit = Lit(col_to_var[undef[0]], !parity);
+        row_to_clause(row, lit);
+        solver->enqueue(lit, make_reason());
+        stats.props++;
+
+        return true;
+    }
+
+    set_watches(row, top[0], top[1]);
+    if (!parity)
+        return true;
+
+    row_to_clause(row, lit_Undef);
+    confl = make_conflict();
+    stats.confls++;
+
+    return false;
+}
+
+///Makes 'col' the basic column of 'row', and takes it out of every other row
+void Gaussian::pivot(const uint32_t row, const uint32_t col)
+{
+    for(uint32_t row2 = 0; row2 < mat.getNumRows(); row2++) {
+        if (row2 != row && mat.get(row2, col)) {
+            mat.addRow(row2, row);
+            to_recheck.push_back(row2);
+        }
+    }
+    basic[row] = col;
+    stats.pivots++;
+}
+
+void Gaussian::set_watches(const uint32_t row, const uint32_t col1, const uint32_t col2)
+{
+    uint32_t* w = &watch[2*row];
+    const bool had1 = (col1 == w[0] || col1 == w[1]);
+    const bool had2 = (col2 == w[0] || col2 == w[1]);
+    w[0] = col1;
+    w[1] = col2;
+
+    //Entries of the old watches are left behind, they are dropped when visited
+    if (!had1) {
+        solver->gwatches[col_to_var[col1]].push_back(GaussWatched(row, matrix_no));
+    }
+    if (!had2) {
+        solver->gwatches[col_to_var[col2]].push_back(GaussWatched(row, matrix_no));
+    }
+}
+
+///The row as a clause: 'first' if given, then the other variables as they are falsified
+void Gaussian::row_to_clause(const uint32_t row, const Lit first)
+{
+    tmp_clause.clear();
+    if (first != lit_Undef) {
+        tmp_clause.push_back(first);
+    }
+    mat.forEachSet(row, [&](uint32_t col) {
+        const Var var = col_to_var[col];
+        if (first != lit_Undef && var == first.var())
+            return;
+
+        tmp_clause.push_back(Lit(var, solver->value(var) == l_True));
+    });
+}
+
+PropBy Gaussian::make_reason()
+{
+    //Level 0 facts need no reason
+    if (solver->decisionLevel() == 0)
+        return PropBy();
+
+    return solver->make_xor_reason(tmp_clause);
+}
+
+PropBy Gaussian::make_conflict()
+{
+    return solver->make_xor_conflict(tmp_clause);
+}
+
+vector<vector<Xor> > Gaussian::cut_into_blocks(
+    const vector<Xor>& xors
+    , const size_t nVars
+) {
+    //Union-find over the XORs, joined through their variables
+    vector<uint32_t> parent(xors.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&](uint32_t x) {
+        while(parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    };
+
+    vector<uint32_t> varToXor(nVars, col_none);
+    for(uint32_t i = 0; i < xors.size(); i++) {
+        for(const Var var: xors[i].vars) {
+            if (varToXor[var] == col_none) {
+                varToXor[var] = i;
+            } else {
+                parent[find(i)] = find(varToXor[var]);
+            }
+        }
+    }
+
+    vector<vector<Xor> > blocks;
+    vector<uint32_t> rootToBlock(xors.size(), col_none);
+    for(uint32_t i = 0; i < xors.size(); i++) {
+        const uint32_t root = find(i);
+        if (rootToBlock[root] == col_none) {
+            rootToBlock[root] = blocks.size();
+            blocks.push_back(vector<Xor>());
+        }
+        blocks[rootToBlock[root]].push_back(xors[i]);
+    }
+
+    return blocks;
+}
+
+size_t Gaussian::memUsed() const
+{
+    size_t mem = mat.memUsed();
+    mem += col_to_var.capacity()*sizeof(Var);
+    mem += basic.capacity()*sizeof(uint32_t);
+    mem += watch.capacity()*sizeof(uint32_t);
+    mem += to_recheck.capacity()*sizeof(uint32_t);
+    mem += tmp_clause.capacity()*sizeof(Lit);
+    for(const Xor& x: xors) {
+        mem += x.vars.capacity()*sizeof(Var);
+    }
+
+    return mem;
+}
+
+Gaussian::Stats& Gaussian::Stats::operator+=(const Stats& other)
+{
+    numMatrixes += other.numMatrixes;
+    numRows += other.numRows;
+    numCols += other.numCols;
+    props += other.props;
+    confls += other.confls;
+    pivots += other.pivots;
+    initTime += other.initTime;
+
+    return *this;
+}
+
+void Gaussian::Stats::print() const
+{
+    cout << "c -------- GAUSS STATS --------" << endl;
+    printStatsLine("c init time"
+        , initTime
+        , initTime/(double)numMatrixes
+        , "per matrix"
+    );
+
+    printStatsLine("c matrixes"
+        , numMatrixes
+    );
+
+    printStatsLine("c avg rows"
+        , (double)numRows/(double)numMatrixes
+        , (double)numCols/(double)numMatrixes
+        , "avg cols"
+    );
+
+    printStatsLine("c propagations"
+        , props
+    );
+
+    printStatsLine("c conflicts"
+        , confls
+    );
+
+    printStatsLine("c pivots"
+        , pivots
+        , (double)pivots/(double)(props+confls)
+        , "per prop&confl"
+    );
+    cout << "c -------- GAUSS STATS END --------" << endl;
+}
@@ -0,0 +1,134 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.0 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+#ifndef GAUSSIAN_H
+#define GAUSSIAN_H
+
+#include <vector>
+#include <cstdint>
+#include "solvertypes.h"
+#include "propby.h"
+#include "packedmatrix.h"
+#include "xor.h"
+
+namespace CMSat {
+
+using std::vector;
+
+class Solver;
+
+///Entry of Searcher::gwatches[var]: 'row' of matrix 'matrix' watches 'var'
+struct GaussWatched
+{
+    GaussWatched(const uint32_t _row, const uint32_t _matrix) :
+        row(_row)
+        , matrix(_matrix)
+    {}
+
+    uint32_t row;
+    uint32_t matrix;
+};
+
+/**
+@brief Gauss-Jordan elimination on one block of XORs, during search
+
+The matrix is kept in reduced row echelon form: every row has a basic column
+that no other row has. While the basic variables are all unassigned, no sum
+of rows can have fewer unassigned variables than a single row, so looking at
+the rows one by one finds everything the XORs imply.
+
+Every row watches two of its variables, the basic one whenever it can. When
+the basic variable gets assigned, another unassigned variable of the row is
+made basic by adding the row to every other row that has it. When a row has
+a single unassigned variable left it is propagated, when it has none and the
+parity is wrong it is a conflict. Since every row stays a sum of the original
+XORs whatever the assignment, nothing has to be undone on backtracking.
+
+Reasons and conflicts are given as clauses over the variables of the row at
+the time. Binary and tertiary ones are passed implicitly, longer ones are
+allocated outside the clause lists and freed by the Searcher once unused.
+*/
+class Gaussian
+{
+public:
+    Gaussian(Solver* solver, const vector<Xor>& xors, uint32_t matrix_no);
+
+    ///Eliminates and sets up the watches. Only at level 0, FALSE if UNSAT
+    bool init();
+
+    ///The watched 'var' of 'row' has been assigned. FALSE if the watch must be dropped
+    bool find_truths(uint32_t row, Var var, PropBy& confl);
+
+    ///Looks at the rows changed by eliminations that have not been looked at yet
+    bool recheck(PropBy& confl);
+
+    ///Cuts the XORs into blocks that have no variables in common
+    static vector<vector<Xor> > cut_into_blocks(
+        const vector<Xor>& xors
+        , size_t nVars
+    );
+
+    struct Stats
+    {
+        Stats& operator+=(const Stats& other);
+        void print() const;
+
+        uint64_t numMatrixes = 0;
+        uint64_t numRows = 0;
+        uint64_t numCols = 0;
+        uint64_t props = 0;
+        uint64_t confls = 0;
+        uint64_t pivots = 0;
+        double initTime = 0;
+    };
+    const Stats& getStats() const;
+    size_t memUsed() const;
+
+private:
+    Solver* solver;
+    const uint32_t matrix_no;
+    vector<Xor> xors;
+
+    PackedMatrix mat;
+    vector<Var> col_to_var;
+    vector<uint32_t> basic; ///<Basic column of each row
+    vector<uint32_t> watch; ///<Two watched columns of each row, 2*row and 2*row+1
+    vector<uint32_t> to_recheck;
+
+    bool check_row(uint32_t row, PropBy& confl);
+    void pivot(uint32_t row, uint32_t col);
+    void set_watches(uint32_t row, uint32_t col1, uint32_t col2);
+    void row_to_clause(uint32_t row, Lit first);
+    PropBy make_reason();
+    PropBy make_conflict();
+
+    vector<Lit> tmp_clause;
+    Stats stats;
+};
+
+inline const Gaussian::Stats& Gaussian::getStats() const
+{
+    return stats;
+}
+
+} //end namespace
+
+#endif //GAUSSIAN_H
@@ -31,7 +31,7 @@ Lit HyperEngine::propagateFullBFS(const uint64_t timeout)
     if (trail.size() - trail_lim.back() == 1) {
         //Set up root node
         Lit root = trail[qhead];
-        varData[root.var()].reason = PropBy(~lit_Undef, false, false, false);
+        varReason[root.var()] = PropBy(~lit_Undef, false, false, false);
     }
 
     uint32_t nlBinQHead = qhead;
@@ -433,7 +433,7 @@ Lit HyperEngine::propagateFullDFS(
     if (trail.size() - trail_lim.back() == 1) {
         //Set up root node
         Lit root = trail[qhead];
-        varData[root.var()].reason = PropBy(~lit_Undef, false, false, false);
+        varReason[root.var()] = PropBy(~lit_Undef, false, false, false);
     }
 
     //Set up stacks
@@ -562,8 +562,8 @@ void HyperEngine::addHyperBin(const Lit p)
     }
 
     enqueueComplex(p, deepestAncestor, true);
-    varData[p.var()].reason.setHyperbin(true);
-    varData[p.var()].reason.setHyperbinNotAdded(hyperBinNotAdded);
+    varReason[p.var()].setHyperbin(true);
+    varReason[p.var()].setHyperbinNotAdded(hyperBinNotAdded);
 }
 
 /**
@@ -577,7 +577,7 @@ Lit HyperEngine::removeWhich(
     , bool thisStepRed
 ) {
     propStats.otfHyperTime += 1;
-    const PropBy& data = varData[conflict.var()].reason;
+    const PropBy& data = varReason[conflict.var()];
 
     bool onlyIrred = !data.isRedStep();
     Lit lookingForAncestor = data.getAncestor();
@@ -701,7 +701,7 @@ bool HyperEngine::isAncestorOf(
 
         #ifdef VERBOSE_DEBUG_FULLPROP
         cout << "Current acestor: " << thisAncestor
-        << " redundant step? " << varData[thisAncestor.var()].reason.isRedStep()
+        << " redundant step? " << varReason[thisAncestor.var()].isRedStep()
         << endl;
         #endif
 
@@ -720,7 +720,7 @@ bool HyperEngine::isAncestorOf(
             return true;
         }
 
-        const PropBy& data = varData[thisAncestor.var()].reason;
+        const PropBy& data = varReason[thisAncestor.var()];
         if ((onlyIrred && data.isRedStep())
             || data.getHyperbinNotAdded()
         ) {
@@ -748,8 +748,8 @@ void HyperEngine::addHyperBin(const Lit lit1, const Lit lit2, const Lit lit3)
     print_trail();
     cout << "Enqueing " << lit1
     << " with ancestor 3-long clause: " << lit1 << " , "
-    << lit2 << " (lev:" << varData[lit2.var()].level << ") "
-    << lit3 << " (lev:" << varData[lit3.var()].level << ") "
+    << lit2 << " (lev:" << varLevel[lit2.var()] << ") "
+    << lit3 << " (lev:" << varLevel[lit3.var()] << ") "
     << endl;
     #endif
 
@@ -757,11 +757,11 @@ void HyperEngine::addHyperBin(const Lit lit1, const Lit lit2, const Lit lit3)
     assert(value(lit3) == l_False);
 
     currAncestors.clear();
-    if (varData[lit2.var()].level != 0) {
+    if (varLevel[lit2.var()] != 0) {
         currAncestors.push_back(~lit2);
     }
 
-    if (varData[lit3.var()].level != 0)
+    if (varLevel[lit3.var()] != 0)
         currAncestors.push_back(~lit3);
 
     addHyperBin(lit1);
@@ -786,7 +786,7 @@ void HyperEngine::addHyperBin(const Lit p, const Clause& cl)
     ) {
         if (*it != p) {
             assert(value(*it) == l_False);
-            if (varData[it->var()].level != 0)
+            if (varLevel[it->var()] != 0)
                 currAncestors.push_back(~*it);
         }
     }
@@ -806,17 +806,17 @@ Lit HyperEngine::analyzeFail(const PropBy propBy)
     switch(propBy.getType()) {
         case tertiary_t : {
             const Lit lit = ~propBy.lit3();
-            if (varData[lit.var()].level != 0)
+            if (varLevel[lit.var()] != 0)
                 currAncestors.push_back(lit);
             //intentionally falling through here
             //i.e. there is no 'break' here for a reason
         }
         case binary_t: {
             const Lit lit = ~propBy.lit2();
-            if (varData[lit.var()].level != 0)
+            if (varLevel[lit.var()] != 0)
                 currAncestors.push_back(lit);
 
-            if (varData[failBinLit.var()].level != 0)
+            if (varLevel[failBinLit.var()] != 0)
                 currAncestors.push_back(~failBinLit);
 
             break;
@@ -826,12 +826,14 @@ Lit HyperEngine::analyzeFail(const PropBy propBy)
             const uint32_t offset = propBy.getClause();
             const Clause& cl = *clAllocator.getPointer(offset);
             for(size_t i = 0; i < cl.size(); i++) {
-                if (varData[cl[i].var()].level != 0)
+                if (varLevel[cl[i].var()] != 0)
                     currAncestors.push_back(~cl[i]);
             }
             break;
         }
 
+        //Hyper-binary resolution is not done with native XORs
+        case xor_t:
         case null_clause_t:
             assert(false);
             break;
@@ -893,7 +895,7 @@ Lit HyperEngine::deepestCommonAcestor()
             }
 
             //Update ancestor to its own ancestor, i.e. step up this 'thread'
-            *it = varData[it->var()].reason.getAncestor();
+            *it = varReason[it->var()].getAncestor();
         }
     }
     #ifdef VERBOSE_DEBUG_FULLPROP
@@ -915,22 +917,22 @@ void HyperEngine::remove_bin_clause(Lit lit)
 {
     //The binary clause we should remove
     const BinaryClause clauseToRemove(
-        ~varData[lit.var()].reason.getAncestor()
+        ~varReason[lit.var()].getAncestor()
         , lit
-        , varData[lit.var()].reason.isRedStep()
+        , varReason[lit.var()].isRedStep()
     );
 
     //We now remove the clause
     //If it's hyper-bin, then we remove the to-be-added hyper-binary clause
     //However, if the hyper-bin was never added because only 1 literal was unbound at level 0 (i.e. through
     //clause cleaning, the clause would have been 2-long), then we don't do anything.
-    if (!varData[lit.var()].reason.getHyperbin()) {
+    if (!varReason[lit.var()].getHyperbin()) {
         #ifdef VERBOSE_DEBUG_FULLPROP
         cout << "Normal removing clause " << clauseToRemove << endl;
         #endif
         propStats.otfHyperTime += 2;
         uselessBin.insert(clauseToRemove);
-    } else if (!varData[lit.var()].reason.getHyperbinNotAdded()) {
+    } else if (!varReason[lit.var()].getHyperbinNotAdded()) {
         #ifdef VERBOSE_DEBUG_FULLPROP
         cout << "Removing hyper-bin clause " << clauseToRemove << endl;
         #endif
@@ -984,7 +986,7 @@ PropResult HyperEngine::propBin(
         confl = PropBy(~p);
         return PROP_FAIL;
 
-    } else if (varData[lit.var()].level != 0) {
+    } else if (varLevel[lit.var()] != 0) {
         //Propaged already
         assert(val == l_True);
 
@@ -995,14 +997,14 @@ PropResult HyperEngine::propBin(
 
         //Remove this one
         if (remove == p) {
-            Lit origAnc = varData[lit.var()].reason.getAncestor();
+            Lit origAnc = varReason[lit.var()].getAncestor();
             assert(origAnc != lit_Undef);
 
             remove_bin_clause(lit);
 
             //Update data indicating what lead to lit
-            varData[lit.var()].reason = PropBy(~p, k->red(), false, false);
-            assert(varData[p.var()].level != 0);
+            varReason[lit.var()] = PropBy(~p, k->red(), false, false);
+            assert(varLevel[p.var()] != 0);
             varData[lit.var()].depth = varData[p.var()].depth + 1;
             //NOTE: we don't update the levels of other literals... :S
 
@@ -1039,7 +1041,7 @@ PropResult HyperEngine::propNormalClauseComplex(
     const ClOffset offset = i->getOffset();
     Clause& c = *clAllocator.getPointer(offset);
 
-    PropResult ret = prop_normal_helper(c, offset, j, p);
+    PropResult ret = prop_normal_helper<true>(c, offset, j, p);
     if (ret != PROP_TODO)
         return ret;
 
@@ -1050,8 +1052,8 @@ PropResult HyperEngine::propNormalClauseComplex(
     }
 
     //Update stats
-    c.stats.propagations_made++;
-    c.stats.sum_of_branch_depth_propagation += decisionLevel() + 1;
+    clAllocator.getStats(c).propagations_made++;
+    clAllocator.getStats(c).sum_of_branch_depth_propagation += decisionLevel() + 1;
     #ifdef STATS_NEEDED
     if (c.red())
         propStats.propsLongRed++;
@@ -1141,7 +1143,7 @@ void HyperEngine::enqueueComplex(
 ) {
     enqueue(p, PropBy(~ancestor, redStep, false, false));
 
-    assert(varData[ancestor.var()].level != 0);
+    assert(varLevel[ancestor.var()] != 0);
 
     varData[p.var()].depth = varData[ancestor.var()].depth + 1;
     #if defined(DEBUG_DEPTH) or defined(VERBOSE_DEBUG_FULLPROP)
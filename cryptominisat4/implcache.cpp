@@ -48,14 +48,10 @@ void ImplCache::makeAllRed()
 size_t ImplCache::memUsed() const
 {
     size_t numBytes = 0;
-    for(vector<TransCache>::const_iterator
-        it = implCache.begin(), end = implCache.end()
-        ; it != end
-        ; it++
-    ) {
-        numBytes += it->lits.capacity()*sizeof(LitExtra);
+    for(const TransCache& trans: implCache) {
+        numBytes += trans.memUsed();
     }
-    numBytes += implCache.capacity()*sizeof(vector<TransCache>);
+    numBytes += implCache.capacity()*sizeof(TransCache);
 
     return numBytes;
 }
@@ -84,8 +80,8 @@ void ImplCache::printStatsSort(const Solver* solver) const
 
         if (solver->varData[lit.var()].is_decision) {
             activeLits++;
-            totalElems += implCache[i].lits.size();
-            numHasElems += !implCache[i].lits.empty();
+            totalElems += implCache[i].size();
+            numHasElems += !implCache[i].empty();
         }
     }
 
@@ -120,7 +116,7 @@ bool ImplCache::clean(Solver* solver, bool* setSomething)
         if (solver->varData[var].removed == Removed::replaced) {
             for(int i = 0; i < 2; i++) {
                 const Lit litOrig = Lit(var, i);
-                if (implCache[litOrig.toInt()].lits.empty())
+                if (implCache[litOrig.toInt()].empty())
                     continue;
 
                 const Lit lit = solver->varReplacer->getLitReplacedWith(litOrig);
@@ -129,7 +125,7 @@ bool ImplCache::clean(Solver* solver, bool* setSomething)
                 //implCache is not even large enough, etc.
                 if (solver->varData[lit.var()].removed == Removed::none) {
                     bool taut = implCache.at(lit.toInt()).merge(
-                        implCache[litOrig.toInt()].lits
+                        implCache[litOrig.toInt()]
                         , lit_Undef //nothing to add
                         , false //replaced, so 'irred'
                         , lit.var() //exclude the literal itself
@@ -150,18 +146,17 @@ bool ImplCache::clean(Solver* solver, bool* setSomething)
             || solver->varData[var].removed == Removed::replaced
             || solver->varData[var].removed == Removed::decomposed
         ) {
-            vector<LitExtra> tmp1;
-            numFreed += implCache[Lit(var, false).toInt()].lits.capacity();
-            implCache[Lit(var, false).toInt()].lits.swap(tmp1);
+            numFreed += implCache[Lit(var, false).toInt()].memUsed();
+            implCache[Lit(var, false).toInt()].free();
 
-            vector<LitExtra> tmp2;
-            numFreed += implCache[Lit(var, true).toInt()].lits.capacity();
-            implCache[Lit(var, true).toInt()].lits.swap(tmp2);
+            numFreed += implCache[Lit(var, true).toInt()].memUsed();
+            implCache[Lit(var, true).toInt()].free();
         }
     }
 
     vector<uint16_t>& inside = solver->seen;
     vector<uint16_t>& irred = solver->seen2;
+    vector<LitExtra> lits;
     size_t wsLit = 0;
     for(vector<TransCache>::iterator
         trans = implCache.begin(), transEnd = implCache.end()
@@ -169,14 +164,14 @@ bool ImplCache::clean(Solver* solver, bool* setSomething)
         ; trans++, wsLit++
     ) {
         //Stats
-        size_t origSize = trans->lits.size();
-        size_t newSize = 0;
+        size_t origSize = trans->size();
+        if (origSize == 0)
+            continue;
 
         //Update to replaced vars, remove vars already set or eliminated
         Lit vertLit = Lit::toLit(wsLit);
-        vector<LitExtra>::iterator it = trans->lits.begin();
-        vector<LitExtra>::iterator it2 = it;
-        for (vector<LitExtra>::iterator end = trans->lits.end(); it != end; it++) {
+        lits.clear();
+        for (TransCache::const_iterator it = trans->begin(), end = trans->end(); it != end; ++it) {
             Lit lit = it->getLit();
             assert(lit.var() != vertLit.var());
 
@@ -214,16 +209,14 @@ bool ImplCache::clean(Solver* solver, bool* setSomething)
             }
 
             inside[lit.toInt()] = true;
-            *it2++ = LitExtra(lit, it->getOnlyIrredBin());
-            newSize++;
+            lits.push_back(LitExtra(lit, it->getOnlyIrredBin()));
         }
-        trans->lits.resize(newSize);
 
         //Now that we have gone through the list, go through once more to:
         //1) set irred right (above we might have it set later)
         //2) clear 'inside'
         //3) clear 'irred'
-        for (vector<LitExtra>::iterator it = trans->lits.begin(), end = trans->lits.end(); it != end; it++) {
+        for (vector<LitExtra>::iterator it = lits.begin(), end = lits.end(); it != end; it++) {
             Lit lit = it->getLit();
 
             //Clear 'inside'
@@ -238,7 +231,8 @@ bool ImplCache::clean(Solver* solver, bool* setSomething)
             assert(solver->varData[it->getLit().var()].removed == Removed::none);
             assert(solver->value(it->getLit()) == l_Undef);
         }
-        numCleaned += origSize-trans->lits.size();
+        trans->set(lits);
+        numCleaned += origSize-trans->size();
     }
 
     size_t origTrailDepth = solver->trail.size();
@@ -400,17 +394,17 @@ void ImplCache::tryVar(
 
     Lit lit = Lit(var, false);
 
-    const vector<LitExtra>& cache1 = implCache[lit.toInt()].lits;
+    const TransCache& cache1 = implCache[lit.toInt()];
     assert(solver->watches.size() > (lit.toInt()));
     watch_subarray_const ws1 = solver->watches[lit.toInt()];
-    const vector<LitExtra>& cache2 = implCache[(~lit).toInt()].lits;
+    const TransCache& cache2 = implCache[(~lit).toInt()];
     watch_subarray_const ws2 = solver->watches[(~lit).toInt()];
 
     //Fill 'seen' and 'val' from cache
-    for (vector<LitExtra>::const_iterator
+    for (TransCache::const_iterator
         it = cache1.begin(), end = cache1.end()
         ; it != end
-        ; it++
+        ; ++it
     ) {
         const Var var2 = it->getLit().var();
 
@@ -448,10 +442,10 @@ void ImplCache::tryVar(
 
     //Try to see if we propagate the same or opposite from the other end
     //Using cache
-    for (vector<LitExtra>::const_iterator
+    for (TransCache::const_iterator
         it = cache2.begin(), end = cache2.end()
         ; it != end
-        ; it++
+        ; ++it
     ) {
         assert(it->getLit().var() != var);
         const Var var2 = it->getLit().var();
@@ -486,7 +480,7 @@ void ImplCache::tryVar(
     }
 
     //Clear 'seen' and 'val'
-    for (vector<LitExtra>::const_iterator it = cache1.begin(), end = cache1.end(); it != end; it++) {
+    for (TransCache::const_iterator it = cache1.begin(), end = cache1.end(); it != end; ++it) {
         seen[it->getLit().var()] = false;
         val[it->getLit().var()] = false;
     }
@@ -500,29 +494,140 @@ void ImplCache::tryVar(
     }
 }
 
+void TransCache::alloc(const size_t newBytes)
+{
+    assert(newBytes <= std::numeric_limits<uint32_t>::max());
+    uint8_t* newData = NULL;
+    if (newBytes > 0) {
+        newData = (uint8_t*)malloc(newBytes);
+        if (newData == NULL) {
+            throw std::bad_alloc();
+        }
+    }
+
+    std::free(data);
+    data = newData;
+    bytes = newBytes;
+}
+
+size_t TransCache::varint_len(uint64_t val)
+{
+    size_t len = 1;
+    while(val >= 0x80) {
+        val >>= 7;
+        len++;
+    }
+
+    return len;
+}
+
+void TransCache::write_varint(uint8_t*& out, uint64_t val)
+{
+    while(val >= 0x80) {
+        *out++ = (uint8_t)(val | 0x80);
+        val >>= 7;
+    }
+    *out++ = (uint8_t)val;
+}
+
+inline uint64_t TransCache::entry(uint32_t& prev, const LitExtra lit)
+{
+    assert(lit.getLit().toInt() >= prev);
+    const uint64_t delta = lit.getLit().toInt() - prev;
+    prev = lit.getLit().toInt();
+
+    return (delta << 1) | (uint64_t)lit.getOnlyIrredBin();
+}
+
+static bool lit_extra_by_lit(const LitExtra a, const LitExtra b)
+{
+    return a.getLit() < b.getLit();
+}
+
+void TransCache::set(vector<LitExtra>& lits)
+{
+    std::sort(lits.begin(), lits.end(), lit_extra_by_lit);
+
+    size_t newBytes = 0;
+    uint32_t prev = 0;
+    for(const LitExtra lit: lits) {
+        newBytes += varint_len(entry(prev, lit));
+    }
+
+    alloc(newBytes);
+    uint8_t* out = data;
+    prev = 0;
+    for(const LitExtra lit: lits) {
+        write_varint(out, entry(prev, lit));
+    }
+    assert(out == data + bytes);
+    num = lits.size();
+}
+
+///Adds literals that are not yet in, in one merging pass
+void TransCache::add_sorted(vector<LitExtra>& toAdd)
+{
+    if (toAdd.empty())
+        return;
+
+    std::sort(toAdd.begin(), toAdd.end(), lit_extra_by_lit);
+
+    //Size of the merged list
+    size_t newBytes = 0;
+    uint32_t prev = 0;
+    vector<LitExtra>::const_iterator add = toAdd.begin();
+    for(const LitExtra lit: *this) {
+        for(; add != toAdd.end() && add->getLit() < lit.getLit(); add++) {
+            newBytes += varint_len(entry(prev, *add));
+        }
+        assert(add == toAdd.end() || add->getLit() != lit.getLit());
+        newBytes += varint_len(entry(prev, lit));
+    }
+    for(; add != toAdd.end(); add++) {
+        newBytes += varint_len(entry(prev, *add));
+    }
+
+    //Write it into a new buffer
+    TransCache old;
+    swap(old);
+    alloc(newBytes);
+    uint8_t* out = data;
+    prev = 0;
+    add = toAdd.begin();
+    for(const LitExtra lit: old) {
+        for(; add != toAdd.end() && add->getLit() < lit.getLit(); add++) {
+            write_varint(out, entry(prev, *add));
+        }
+        write_varint(out, entry(prev, lit));
+    }
+    for(; add != toAdd.end(); add++) {
+        write_varint(out, entry(prev, *add));
+    }
+    assert(out == data + bytes);
+    num = old.num + toAdd.size();
+}
+
 bool TransCache::merge(
-    const vector<LitExtra>& otherLits //Lits to add
+    const TransCache& other //Lits to add
     , const Lit extraLit //Add this, too to the list of lits
     , const bool red //The step was a redundant-dependent step?
     , const Var leaveOut //Leave this literal out
     , vector<uint16_t>& seen
 ) {
     //Mark every literal that is to be added in 'seen'
-    for (size_t i = 0, size = otherLits.size(); i < size; i++) {
-        const Lit lit = otherLits[i].getLit();
-        const bool onlyIrred = otherLits[i].getOnlyIrredBin();
-
-        seen[lit.toInt()] = 1 + (int)onlyIrred;
+    for (const LitExtra l: other) {
+        seen[l.getLit().toInt()] = 1 + (int)l.getOnlyIrredBin();
     }
 
     bool taut = mergeHelper(extraLit, red, seen);
 
     //Whatever rests needs to be added
-    for (size_t i = 0 ,size = otherLits.size(); i < size; i++) {
-        const Lit lit = otherLits[i].getLit();
+    vector<LitExtra> toAdd;
+    for (const LitExtra l: other) {
+        const Lit lit = l.getLit();
         if (seen[lit.toInt()]) {
             if (lit.var() != leaveOut)
-                lits.push_back(LitExtra(lit, !red && otherLits[i].getOnlyIrredBin()));
+                toAdd.push_back(LitExtra(lit, !red && l.getOnlyIrredBin()));
             seen[lit.toInt()] = 0;
         }
     }
@@ -530,9 +635,10 @@ bool TransCache::merge(
     //Handle extra lit
     if (extraLit != lit_Undef && seen[extraLit.toInt()]) {
         if (extraLit.var() != leaveOut)
-            lits.push_back(LitExtra(extraLit, !red));
+            toAdd.push_back(LitExtra(extraLit, !red));
         seen[extraLit.toInt()] = 0;
     }
+    add_sorted(toAdd);
 
     return taut;
 }
@@ -553,11 +659,12 @@ bool TransCache::merge(
     bool taut = mergeHelper(extraLit, red, seen);
 
     //Whatever rests needs to be added
+    vector<LitExtra> toAdd;
     for (size_t i = 0 ,size = otherLits.size(); i < size; i++) {
         const Lit lit = otherLits[i];
         if (seen[lit.toInt()]) {
             if (lit.var() != leaveOut)
-                lits.push_back(LitExtra(lit, false));
+                toAdd.push_back(LitExtra(lit, false));
             seen[lit.toInt()] = 0;
         }
     }
@@ -565,9 +672,10 @@ bool TransCache::merge(
     //Handle extra lit
     if (extraLit != lit_Undef && seen[extraLit.toInt()]) {
         if (extraLit.var() != leaveOut)
-            lits.push_back(LitExtra(extraLit, !red));
+            toAdd.push_back(LitExtra(extraLit, !red));
         seen[extraLit.toInt()] = 0;
     }
+    add_sorted(toAdd);
 
     return taut;
 }
@@ -585,19 +693,27 @@ bool TransCache::mergeHelper(
 
     //Everything that's already in the cache, set seen[] to zero
     //Also, if seen[] is 2, but it's marked redundant in the cache
-    //mark it as irred
-    for (size_t i = 0, size = lits.size(); i < size; i++) {
+    //mark it as irred -- the flag is in the first byte, set it in place
+    uint32_t prev = 0;
+    for (uint8_t* at = data, *end = data + bytes; at != end;) {
+        uint8_t* const start = at;
+        const uint8_t* next = at;
+        const uint64_t val = read_varint(next);
+        at = start + (next - start);
+        const Lit lit = Lit::toLit(prev + (val >> 1));
+        prev = lit.toInt();
+
         if (!red
-            && !lits[i].getOnlyIrredBin()
-            && seen[lits[i].getLit().toInt()] == 2
+            && !(val & 1)
+            && seen[lit.toInt()] == 2
         ) {
-            lits[i].setOnlyIrredBin();
+            *start |= 1;
         }
 
-        seen[lits[i].getLit().toInt()] = 0;
+        seen[lit.toInt()] = 0;
 
         //Both L and ~L are in, the ancestor is a tautology
-        if (seen[(~(lits[i].getLit())).toInt()]) {
+        if (seen[(~lit).toInt()]) {
             taut = true;
         }
     }
@@ -608,21 +724,25 @@ bool TransCache::mergeHelper(
 //Make all literals as if propagated only by redundant
 void TransCache::makeAllRed()
 {
-    for(size_t i = 0; i < lits.size(); i++) {
-        lits[i] = LitExtra(lits[i].getLit(), false);
+    for (uint8_t* at = data, *end = data + bytes; at != end;) {
+        *at &= ~(uint8_t)1;
+        const uint8_t* next = at;
+        read_varint(next);
+        at += next - at;
     }
-
 }
 
 void TransCache::updateVars(
     const std::vector< uint32_t >& outerToInter
     , const size_t newMaxVars
 ) {
-    for(size_t i = 0; i < lits.size(); i++) {
-        lits[i] = LitExtra(getUpdatedLit(lits[i].getLit(), outerToInter), lits[i].getOnlyIrredBin());
-        assert(lits[i].getLit().var() < newMaxVars);
+    vector<LitExtra> lits;
+    lits.reserve(num);
+    for(const LitExtra l: *this) {
+        lits.push_back(LitExtra(getUpdatedLit(l.getLit(), outerToInter), l.getOnlyIrredBin()));
+        assert(lits.back().getLit().var() < newMaxVars);
     }
-
+    set(lits);
 }
 
 void ImplCache::updateVars(
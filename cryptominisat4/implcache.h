@@ -26,6 +26,8 @@
 #include <limits>
 #include <algorithm>
 #include <vector>
+#include <cstdlib>
+#include <cstring>
 #include "constants.h"
 #include "solvertypes.h"
 
@@ -78,14 +80,154 @@ private:
 
 };
 
+/**
+@brief The literals implied by a literal, stored compressed
+
+The literals are kept sorted, and every one is stored as a varint of the
+difference to the previous one, shifted up by one to make space for the
+"only irredundant binaries" flag. Literals of nearby variables thus take a
+single byte instead of the four a LitExtra takes. The flag is in the lowest
+bit of the first byte of every entry, so it can be changed in place.
+
+The literals can only be read in order, through const_iterator, which decodes
+them on the fly. The buffer is always allocated to the exact size, as most
+caches never change once filled.
+*/
 class TransCache {
 public:
     TransCache()
-        //conflictLastUpdated(std::numeric_limits<uint64_t>::max())
     {}
 
+    ~TransCache()
+    {
+        std::free(data);
+    }
+
+    TransCache(const TransCache& other) :
+        num(other.num)
+    {
+        alloc(other.bytes);
+        if (bytes > 0) {
+            memcpy(data, other.data, bytes);
+        }
+    }
+
+    TransCache(TransCache&& other) noexcept
+    {
+        swap(other);
+    }
+
+    TransCache& operator=(TransCache other)
+    {
+        swap(other);
+        return *this;
+    }
+
+    class const_iterator
+    {
+    public:
+        const_iterator(const uint8_t* _at, const uint8_t* _end) :
+            at(_at)
+            , end(_end)
+            , prev(0)
+        {
+            decode();
+        }
+
+        const_iterator& operator++()
+        {
+            prev = cur.getLit().toInt();
+            at = next;
+            decode();
+            return *this;
+        }
+
+        LitExtra operator*() const
+        {
+            return cur;
+        }
+
+        const LitExtra* operator->() const
+        {
+            return &cur;
+        }
+
+        bool operator==(const const_iterator& other) const
+        {
+            return at == other.at;
+        }
+
+        bool operator!=(const const_iterator& other) const
+        {
+            return at != other.at;
+        }
+
+    private:
+        void decode()
+        {
+            if (at == end)
+                return;
+
+            next = at;
+            const uint64_t val = TransCache::read_varint(next);
+            cur = LitExtra(Lit::toLit(prev + (val >> 1)), val & 1);
+        }
+
+        const uint8_t* at;
+        const uint8_t* end;
+        const uint8_t* next;
+        uint32_t prev;
+        LitExtra cur;
+    };
+
+    const_iterator begin() const
+    {
+        return const_iterator(data, data + bytes);
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(data + bytes, data + bytes);
+    }
+
+    size_t size() const
+    {
+        return num;
+    }
+
+    bool empty() const
+    {
+        return num == 0;
+    }
+
+    void clear()
+    {
+        alloc(0);
+        num = 0;
+    }
+
+    void free()
+    {
+        clear();
+    }
+
+    size_t memUsed() const
+    {
+        return bytes;
+    }
+
+    void swap(TransCache& other) noexcept
+    {
+        std::swap(data, other.data);
+        std::swap(bytes, other.bytes);
+        std::swap(num, other.num);
+    }
+
+    ///Replaces the contents with 'lits', which must not contain a literal twice
+    void set(vector<LitExtra>& lits);
+
     bool merge(
-        const vector<LitExtra>& otherLits
+        const TransCache& other
         , const Lit extraLit
         , const bool red
         , const Var leaveOut
@@ -105,8 +247,20 @@ public:
         , const size_t newMaxVars
     );
 
-    std::vector<LitExtra> lits;
-    //uint64_t conflictLastUpdated;
+    static uint64_t read_varint(const uint8_t*& at)
+    {
+        uint64_t val = 0;
+        unsigned shift = 0;
+        while(*at & 0x80) {
+            val |= (uint64_t)(*at & 0x7f) << shift;
+            shift += 7;
+            at++;
+        }
+        val |= (uint64_t)*at << shift;
+        at++;
+
+        return val;
+    }
 
 private:
     bool mergeHelper(
@@ -114,13 +268,22 @@ private:
         , const bool red //The step was a redundant-dependent step?
         , vector<uint16_t>& seen
     );
+    void add_sorted(vector<LitExtra>& toAdd);
+    void alloc(const size_t newBytes);
+    static size_t varint_len(uint64_t val);
+    static void write_varint(uint8_t*& out, uint64_t val);
+    static uint64_t entry(uint32_t& prev, const LitExtra lit);
+
+    uint8_t* data = NULL;
+    uint32_t bytes = 0;
+    uint32_t num = 0;
 };
 
 inline std::ostream& operator<<(std::ostream& os, const TransCache& tc)
 {
-    for (size_t i = 0; i < tc.lits.size(); i++) {
-        os << tc.lits[i].getLit()
-        << "(" << (tc.lits[i].getOnlyIrredBin() ? "NL" : "L") << ") ";
+    for (const LitExtra l: tc) {
+        os << l.getLit()
+        << "(" << (l.getOnlyIrredBin() ? "NL" : "L") << ") ";
     }
     return os;
 }
@@ -254,12 +417,8 @@ public:
 
     void clear()
     {
-        for(vector<TransCache>::iterator
-            it = implCache.begin(), end = implCache.end()
-            ; it != end
-            ; it++
-        ) {
-            it->lits.clear();
+        for(TransCache& trans: implCache) {
+            trans.clear();
         }
     }
 
@@ -284,7 +443,7 @@ namespace std
     template <>
     inline void swap (CMSat::TransCache& m1, CMSat::TransCache& m2) noexcept (true)
     {
-         m1.lits.swap(m2.lits);
+         m1.swap(m2);
     }
 }
 
@@ -0,0 +1,425 @@
+/*****************************************************************************
+CryptoMiniSat -- Copyright (c) 2009 Mate Soos
+
+File under MIT licence.
+******************************************************************************/
+
+#include "inputreader.h"
+
+#include <iostream>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using std::cout;
+using std::endl;
+
+InputReader::InputReader()
+{
+    filled[0] = filled[1] = 0;
+    full[0] = full[1] = false;
+}
+
+InputReader::~InputReader()
+{
+    {
+        std::lock_guard<std::mutex> lock(mu);
+        stop = true;
+    }
+    cv.notify_all();
+    if (worker.joinable())
+        worker.join();
+
+    #ifdef USE_ZLIB
+    if (zsInited)
+        inflateEnd(&zs);
+    #endif
+    #ifdef USE_LZMA
+    if (xsInited)
+        lzma_end(&xs);
+    #endif
+    #ifdef USE_ZSTD
+    if (zds != NULL)
+        ZSTD_freeDStream(zds);
+    #endif
+
+    if (ownFd && fd >= 0)
+        ::close(fd);
+}
+
+InputReader::Format InputReader::detect_format(const char* data, size_t len)
+{
+    const unsigned char* d = (const unsigned char*)data;
+    if (len >= 2 && d[0] == 0x1f && d[1] == 0x8b)
+        return Format::gzip;
+
+    if (len >= 6 && d[0] == 0xfd && std::memcmp(d+1, "7zXZ", 4) == 0 && d[5] == 0)
+        return Format::xz;
+
+    if (len >= 4 && d[0] == 0x28 && d[1] == 0xb5 && d[2] == 0x2f && d[3] == 0xfd)
+        return Format::zstd;
+
+    return Format::plain;
+}
+
+const char* InputReader::format_name(Format format)
+{
+    switch(format) {
+        case Format::plain: return "plain";
+        case Format::gzip: return "gzip";
+        case Format::xz: return "xz";
+        case Format::zstd: return "zstd";
+    }
+    return "unknown";
+}
+
+bool InputReader::format_supported(Format format)
+{
+    switch(format) {
+        case Format::plain:
+            return true;
+        case Format::gzip:
+            #ifdef USE_ZLIB
+            return true;
+            #else
+            return false;
+            #endif
+        case Format::xz:
+            #ifdef USE_LZMA
+            return true;
+            #else
+            return false;
+            #endif
+        case Format::zstd:
+            #ifdef USE_ZSTD
+            return true;
+            #else
+            return false;
+            #endif
+    }
+    return false;
+}
+
+bool InputReader::open(const std::string& fname)
+{
+    fd = ::open(fname.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    ownFd = true;
+    start();
+    return true;
+}
+
+void InputReader::open_fd(const int _fd)
+{
+    fd = _fd;
+    ownFd = false;
+    start();
+}
+
+void InputReader::start()
+{
+    raw.resize(bufSize);
+    bufs[0].resize(bufSize);
+    bufs[1].resize(bufSize);
+    worker = std::thread(&InputReader::run, this);
+}
+
+size_t InputReader::next(const char*& data)
+{
+    std::unique_lock<std::mutex> lock(mu);
+    if (held >= 0) {
+        full[held] = false;
+        held = -1;
+        cv.notify_all();
+    }
+    if (atEOF)
+        return 0;
+
+    cv.wait(lock, [&]{return full[consumeAt];});
+    if (!error.empty()) {
+        cout << "ERROR! " << error << endl;
+        std::exit(1);
+    }
+
+    const size_t n = filled[consumeAt];
+    if (n == 0) {
+        atEOF = true;
+        return 0;
+    }
+    held = consumeAt;
+    consumeAt ^= 1;
+    data = bufs[held].data();
+    return n;
+}
+
+void InputReader::set_error(const std::string& err)
+{
+    std::lock_guard<std::mutex> lock(mu);
+    if (error.empty())
+        error = err;
+}
+
+//Reads more raw input after what is left unconsumed. Returns false at EOF
+bool InputReader::fill_raw()
+{
+    if (rawPos > 0) {
+        std::memmove(raw.data(), raw.data() + rawPos, rawLen - rawPos);
+        rawLen -= rawPos;
+        rawPos = 0;
+    }
+
+    while (rawLen < raw.size()) {
+        const ssize_t got = ::read(fd, raw.data() + rawLen, raw.size() - rawLen);
+        if (got < 0 && errno == EINTR)
+            continue;
+
+        if (got < 0) {
+            set_error(std::string("Could not read input: ") + std::strerror(errno));
+            rawEOF = true;
+            return false;
+        }
+        if (got == 0) {
+            rawEOF = true;
+            return false;
+        }
+        rawLen += got;
+        return true;
+    }
+    return true;
+}
+
+void InputReader::run()
+{
+    //Find the format from the first bytes
+    while (rawLen < 6 && !rawEOF)
+        fill_raw();
+    format = detect_format(raw.data(), rawLen);
+    if (!format_supported(format)) {
+        set_error(std::string("Input is ") + format_name(format)
+            + " compressed, but this build has no " + format_name(format)
+            + " support");
+        decoderDone = true;
+    }
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mu);
+            cv.wait(lock, [&]{return stop || !full[produceAt];});
+            if (stop)
+                return;
+        }
+
+        size_t n = 0;
+        if (!decoderDone) {
+            n = produce(bufs[produceAt].data(), bufSize);
+        }
+        bool failed;
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            failed = !error.empty();
+            filled[produceAt] = failed ? 0 : n;
+            full[produceAt] = true;
+        }
+        cv.notify_all();
+
+        //An empty buffer tells the reader the input is over
+        if (n == 0 || failed)
+            return;
+        produceAt ^= 1;
+    }
+}
+
+//Fills "out" as far as it goes. Returns 0 only once the input is over
+size_t InputReader::produce(char* out, size_t cap)
+{
+    switch(format) {
+        case Format::plain: return produce_plain(out, cap);
+        case Format::gzip: return produce_gzip(out, cap);
+        case Format::xz: return produce_xz(out, cap);
+        case Format::zstd: return produce_zstd(out, cap);
+    }
+    return 0;
+}
+
+size_t InputReader::produce_plain(char* out, size_t cap)
+{
+    //What was read for finding the format comes first
+    size_t at = std::min(cap, rawLen - rawPos);
+    std::memcpy(out, raw.data() + rawPos, at);
+    rawPos += at;
+
+    while (at < cap && !rawEOF) {
+        const ssize_t got = ::read(fd, out + at, cap - at);
+        if (got < 0 && errno == EINTR)
+            continue;
+
+        if (got < 0) {
+            set_error(std::string("Could not read input: ") + std::strerror(errno));
+            break;
+        }
+        if (got == 0) {
+            rawEOF = true;
+            break;
+        }
+        at += got;
+    }
+    if (at == 0)
+        decoderDone = true;
+
+    return at;
+}
+
+size_t InputReader::produce_gzip(char* out, size_t cap)
+{
+    #ifdef USE_ZLIB
+    if (!zsInited) {
+        std::memset(&zs, 0, sizeof(zs));
+        //15+32: any window size, gzip or zlib header
+        if (inflateInit2(&zs, 15+32) != Z_OK) {
+            set_error("Could not initialise zlib");
+            return 0;
+        }
+        zsInited = true;
+    }
+
+    zs.next_out = (Bytef*)out;
+    zs.avail_out = cap;
+    while (zs.avail_out > 0 && !decoderDone) {
+        if (rawPos == rawLen && !rawEOF)
+            fill_raw();
+
+        zs.next_in = (Bytef*)raw.data() + rawPos;
+        zs.avail_in = rawLen - rawPos;
+        const int ret = inflate(&zs, Z_NO_FLUSH);
+        rawPos = rawLen - zs.avail_in;
+
+        if (ret == Z_STREAM_END) {
+            //Concatenated gzip members are read one after the other,
+            //anything else after the end is ignored, as gzread does
+            while (rawLen - rawPos < 2 && !rawEOF)
+                fill_raw();
+            if (detect_format(raw.data() + rawPos, rawLen - rawPos) == Format::gzip) {
+                inflateReset(&zs);
+            } else {
+                decoderDone = true;
+            }
+            continue;
+        }
+
+        if (ret == Z_BUF_ERROR && rawPos == rawLen && rawEOF) {
+            set_error("Gzipped input is truncated");
+            return 0;
+        }
+        if (ret != Z_OK && ret != Z_BUF_ERROR) {
+            set_error(std::string("Could not decompress gzipped input: ")
+                + (zs.msg ? zs.msg : "unknown error"));
+            return 0;
+        }
+    }
+    return cap - zs.avail_out;
+
+    #else
+    (void)out;
+    (void)cap;
+    return 0;
+    #endif
+}
+
+size_t InputReader::produce_xz(char* out, size_t cap)
+{
+    #ifdef USE_LZMA
+    if (!xsInited) {
+        lzma_stream init = LZMA_STREAM_INIT;
+        xs = init;
+        if (lzma_stream_decoder(&xs, UINT64_MAX, LZMA_CONCATENATED) != LZMA_OK) {
+            set_error("Could not initialise the xz decoder");
+            return 0;
+        }
+        xsInited = true;
+    }
+
+    xs.next_out = (uint8_t*)out;
+    xs.avail_out = cap;
+    while (xs.avail_out > 0 && !decoderDone) {
+        if (rawPos == rawLen && !rawEOF)
+            fill_raw();
+
+        xs.next_in = (const uint8_t*)raw.data() + rawPos;
+        xs.avail_in = rawLen - rawPos;
+        const lzma_action action =
+            (rawPos == rawLen && rawEOF) ? LZMA_FINISH : LZMA_RUN;
+        const lzma_ret ret = lzma_code(&xs, action);
+        rawPos = rawLen - xs.avail_in;
+
+        if (ret == LZMA_STREAM_END) {
+            decoderDone = true;
+        } else if (ret == LZMA_BUF_ERROR) {
+            set_error("Xz input is truncated");
+            return 0;
+        } else if (ret != LZMA_OK) {
+            set_error("Could not decompress xz input, error code "
+                + std::to_string((int)ret));
+            return 0;
+        }
+    }
+    return cap - xs.avail_out;
+
+    #else
+    (void)out;
+    (void)cap;
+    return 0;
+    #endif
+}
+
+size_t InputReader::produce_zstd(char* out, size_t cap)
+{
+    #ifdef USE_ZSTD
+    if (zds == NULL) {
+        zds = ZSTD_createDStream();
+        if (zds == NULL || ZSTD_isError(ZSTD_initDStream(zds))) {
+            set_error("Could not initialise the zstd decoder");
+            return 0;
+        }
+    }
+
+    ZSTD_outBuffer outb = {out, cap, 0};
+    while (outb.pos < cap && !decoderDone) {
+        if (rawPos == rawLen && !rawEOF)
+            fill_raw();
+
+        ZSTD_inBuffer inb = {raw.data() + rawPos, rawLen - rawPos, 0};
+        const size_t before = outb.pos;
+        const size_t ret = ZSTD_decompressStream(zds, &outb, &inb);
+        if (ZSTD_isError(ret)) {
+            set_error(std::string("Could not decompress zstd input: ")
+                + ZSTD_getErrorName(ret));
+            return 0;
+        }
+        rawPos += inb.pos;
+
+        //No input left and nothing came out: either all frames are done,
+        //or the last one was cut short. The return value of such a call
+        //says nothing, the one of the last call that made progress does
+        if (rawPos == rawLen && rawEOF && inb.pos == 0 && outb.pos == before) {
+            if (zstdLastRet != 0) {
+                set_error("Zstd input is truncated");
+                return 0;
+            }
+            decoderDone = true;
+            continue;
+        }
+        zstdLastRet = ret;
+    }
+    return outb.pos;
+
+    #else
+    (void)out;
+    (void)cap;
+    return 0;
+    #endif
+}
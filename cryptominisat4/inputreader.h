@@ -0,0 +1,112 @@
+/*****************************************************************************
+CryptoMiniSat -- Copyright (c) 2009 Mate Soos
+
+File under MIT licence.
+******************************************************************************/
+
+#ifndef INPUTREADER_H
+#define INPUTREADER_H
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef USE_LZMA
+#include <lzma.h>
+#endif
+#ifdef USE_ZSTD
+#include <zstd.h>
+#endif
+
+/**
+@brief Reads, and if needed decompresses, an input on a background thread
+
+The thread fills two buffers in turn. The parser works on one of them
+while the other is being filled, so decompression and parsing overlap.
+The format (plain, gzip, xz or zstd) is found from the first bytes of the
+input, so compressed data can also come through standard input.
+*/
+class InputReader
+{
+public:
+    enum class Format {
+        plain
+        , gzip
+        , xz
+        , zstd
+    };
+    static Format detect_format(const char* data, size_t len);
+    static const char* format_name(Format format);
+    static bool format_supported(Format format);
+
+    InputReader();
+    ~InputReader();
+    InputReader(const InputReader&) = delete;
+    InputReader& operator=(const InputReader&) = delete;
+
+    bool open(const std::string& fname);
+    void open_fd(int fd); ///<The descriptor is not closed
+
+    ///Blocks until the next piece is ready. Returns 0 at the end of input
+    size_t next(const char*& data);
+
+private:
+    static const size_t bufSize = 1048576;
+
+    void start();
+    void run();
+    bool fill_raw();
+    size_t produce(char* out, size_t cap);
+    size_t produce_plain(char* out, size_t cap);
+    size_t produce_gzip(char* out, size_t cap);
+    size_t produce_xz(char* out, size_t cap);
+    size_t produce_zstd(char* out, size_t cap);
+    void set_error(const std::string& err);
+
+    int fd = -1;
+    bool ownFd = false;
+    Format format = Format::plain;
+
+    //Raw, possibly compressed, input. Only touched by the thread
+    std::vector<char> raw;
+    size_t rawPos = 0;
+    size_t rawLen = 0;
+    bool rawEOF = false;
+    bool decoderDone = false;
+
+    //The two buffers handed over to the parser
+    std::vector<char> bufs[2];
+    size_t filled[2];
+    bool full[2];
+    unsigned produceAt = 0;
+    unsigned consumeAt = 0;
+    int held = -1; ///<Buffer the parser is working on, -1 if none
+    bool atEOF = false;
+    bool stop = false;
+    std::string error;
+
+    std::thread worker;
+    std::mutex mu;
+    std::condition_variable cv;
+
+    #ifdef USE_ZLIB
+    z_stream zs;
+    bool zsInited = false;
+    #endif
+    #ifdef USE_LZMA
+    lzma_stream xs;
+    bool xsInited = false;
+    #endif
+    #ifdef USE_ZSTD
+    ZSTD_DStream* zds = NULL;
+    size_t zstdLastRet = 0;
+    #endif
+};
+
+#endif //INPUTREADER_H
@@ -0,0 +1,376 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.0 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+#include "localsearch.h"
+#include "solver.h"
+#include "clauseallocator.h"
+#include "time_mem.h"
+
+#include <cmath>
+#include <limits>
+#include <iomanip>
+using std::cout;
+using std::endl;
+using namespace CMSat;
+
+LocalSearch::LocalSearch(Solver* _solver) :
+    solver(_solver)
+    , bestUnsat(0)
+    , mems(0)
+    , memsLimit(0)
+{
+}
+
+bool LocalSearch::run(const vector<Lit>& assumptions)
+{
+    assert(solver->decisionLevel() == 0);
+    const double myTime = cpuTime();
+    stats.numCalls++;
+
+    bool found = false;
+    if (init(assumptions)) {
+        mems = 0;
+        memsLimit = solver->conf.localSearchTimeLimitM*1000ULL*1000ULL;
+        walk();
+        found = bestUnsat == 0;
+
+        //Feed the best assignment back as phases
+        for(size_t var = 0; var < solver->nVars(); var++) {
+            if (!fixed[var])
+                solver->varData[var].polarity = best[var];
+        }
+        stats.numCls += clStart.size()-1;
+        stats.bestUnsatSum += bestUnsat;
+    }
+    stats.numFound += found;
+
+    const double timeUsed = cpuTime() - myTime;
+    stats.cpu_time += timeUsed;
+    if (solver->conf.verbosity >= 2) {
+        cout
+        << "c [sls] "
+        << (found ? "found a model" : "no model")
+        << " cls: " << (clStart.empty() ? 0 : clStart.size()-1)
+        << " best unsat: " << bestUnsat
+        << " mems: " << mems/(1000*1000) << "M"
+        << " T: " << std::setprecision(2) << std::fixed << timeUsed
+        << endl;
+    }
+    free_mem();
+
+    return found;
+}
+
+/**
+@brief Builds the problem out of the clauses not satisfied at level 0
+
+@returns FALSE if the assumptions falsify a clause, so there is no model
+*/
+bool LocalSearch::init(const vector<Lit>& assumptions)
+{
+    const size_t nVars = solver->nVars();
+    val.resize(nVars);
+    fixed.resize(nVars);
+    for(size_t var = 0; var < nVars; var++) {
+        const lbool v = solver->value(var);
+        fixed[var] = (v != l_Undef);
+        val[var] = fixed[var] ? (v == l_True) : solver->varData[var].polarity;
+    }
+    for(const Lit p: assumptions) {
+        if (fixed[p.var()]) {
+            if (!is_true(p))
+                return false;
+
+            continue;
+        }
+        fixed[p.var()] = true;
+        val[p.var()] = !p.sign();
+    }
+
+    clStart.clear();
+    clStart.push_back(0);
+    uint32_t wsLit = 0;
+    for (watch_array::const_iterator
+        it = solver->watches.begin(), end = solver->watches.end()
+        ; it != end
+        ; ++it, wsLit++
+    ) {
+        const Lit lit = Lit::toLit(wsLit);
+        watch_subarray_const ws = *it;
+        for (const Watched& w: ws) {
+            //Only one instance of each implicit clause
+            if (w.isBinary() && !w.red() && lit < w.lit2()) {
+                const Lit cl[2] = {lit, w.lit2()};
+                if (!add_clause(cl, cl + 2))
+                    return false;
+            } else if (w.isTri() && !w.red() && lit < w.lit2()) {
+                const Lit cl[3] = {lit, w.lit2(), w.lit3()};
+                if (!add_clause(cl, cl + 3))
+                    return false;
+            }
+        }
+    }
+
+    for(const ClOffset offs: solver->longIrredCls) {
+        const Clause& cl = *solver->clAllocator.getPointer(offs);
+        if (!add_clause(cl.begin(), cl.end()))
+            return false;
+    }
+
+    build_occur();
+    init_break_probs();
+
+    return true;
+}
+
+/**
+@brief Adds the literals of the clause not fixed to false
+
+@returns FALSE if all of them are fixed to false
+*/
+bool LocalSearch::add_clause(const Lit* begin, const Lit* end)
+{
+    const size_t origSize = lits.size();
+    for(const Lit* l = begin; l != end; l++) {
+        if (fixed[l->var()]) {
+            if (is_true(*l)) {
+                lits.resize(origSize);
+                return true;
+            }
+
+            continue;
+        }
+        lits.push_back(*l);
+    }
+
+    if (lits.size() == origSize)
+        return false;
+
+    clStart.push_back(lits.size());
+    return true;
+}
+
+void LocalSearch::build_occur()
+{
+    const size_t numCls = clStart.size()-1;
+    occStart.assign(solver->nVars()*2 + 1, 0);
+    for(const Lit lit: lits) {
+        occStart[lit.toInt()+1]++;
+    }
+    for(size_t i = 1; i < occStart.size(); i++) {
+        occStart[i] += occStart[i-1];
+    }
+
+    occ.resize(lits.size());
+    vector<uint32_t> at(occStart.begin(), occStart.end()-1);
+    numTrue.assign(numCls, 0);
+    trueVarXor.assign(numCls, 0);
+    unsatAt.assign(numCls, std::numeric_limits<uint32_t>::max());
+    unsat.clear();
+    for(uint32_t cl = 0; cl < numCls; cl++) {
+        for(uint32_t i = clStart[cl]; i < clStart[cl+1]; i++) {
+            const Lit lit = lits[i];
+            occ[at[lit.toInt()]++] = cl;
+            if (is_true(lit)) {
+                numTrue[cl]++;
+                trueVarXor[cl] ^= lit.var();
+            }
+        }
+        if (numTrue[cl] == 0)
+            make_unsat(cl);
+    }
+
+    breakCount.assign(solver->nVars(), 0);
+    for(uint32_t cl = 0; cl < numCls; cl++) {
+        if (numTrue[cl] == 1)
+            breakCount[trueVarXor[cl]]++;
+    }
+    bestUnsat = unsat.size();
+    best = val;
+}
+
+/**
+@brief The weights of probSAT's polynomial break-only scheme
+
+The exponent is the one suggested for 3-SAT, and a higher one if there are
+longer clauses.
+*/
+void LocalSearch::init_break_probs()
+{
+    uint32_t maxSize = 0;
+    for(size_t cl = 0; cl+1 < clStart.size(); cl++) {
+        maxSize = std::max(maxSize, clStart[cl+1] - clStart[cl]);
+    }
+    const double cb = (maxSize <= 3) ? 2.06 : 3.0;
+    const double eps = 0.9;
+
+    breakProb.resize(64);
+    for(size_t i = 0; i < breakProb.size(); i++) {
+        breakProb[i] = std::pow(eps + i, -cb);
+    }
+}
+
+void LocalSearch::walk()
+{
+    while(!unsat.empty()
+        && mems < memsLimit
+        && !solver->must_interrupt_asap()
+    ) {
+        const uint32_t cl = unsat[solver->mtrand.randInt(unsat.size()-1)];
+        flip(pick_var(cl));
+        stats.numFlips++;
+
+        if (unsat.size() < bestUnsat)
+            save_best();
+    }
+}
+
+Var LocalSearch::pick_var(const uint32_t cl)
+{
+    const uint32_t start = clStart[cl];
+    const uint32_t size = clStart[cl+1] - start;
+    tmpProb.resize(size);
+
+    double sum = 0;
+    for(uint32_t i = 0; i < size; i++) {
+        const uint32_t b = std::min<uint32_t>(num_break(lits[start+i].var()), breakProb.size()-1);
+        sum += breakProb[b];
+        tmpProb[i] = sum;
+    }
+
+    const double r = solver->mtrand.randDblExc()*sum;
+    for(uint32_t i = 0; i+1 < size; i++) {
+        if (r < tmpProb[i])
+            return lits[start+i].var();
+    }
+
+    return lits[start+size-1].var();
+}
+
+///Number of clauses that would become falsified if 'var' was flipped
+uint32_t LocalSearch::num_break(const Var var)
+{
+    return breakCount[var];
+}
+
+void LocalSearch::flip(const Var var)
+{
+    assert(!fixed[var]);
+    val[var] ^= 1;
+    const Lit nowTrue = Lit(var, !val[var]);
+
+    for(uint32_t i = occStart[nowTrue.toInt()]; i < occStart[nowTrue.toInt()+1]; i++) {
+        const uint32_t cl = occ[i];
+        if (numTrue[cl] == 0) {
+            make_sat(cl);
+            breakCount[var]++;
+        } else if (numTrue[cl] == 1) {
+            //The one that was the only true literal is not any more
+            breakCount[trueVarXor[cl]]--;
+        }
+        numTrue[cl]++;
+        trueVarXor[cl] ^= var;
+    }
+
+    const Lit nowFalse = ~nowTrue;
+    for(uint32_t i = occStart[nowFalse.toInt()]; i < occStart[nowFalse.toInt()+1]; i++) {
+        const uint32_t cl = occ[i];
+        numTrue[cl]--;
+        trueVarXor[cl] ^= var;
+        if (numTrue[cl] == 0) {
+            make_unsat(cl);
+            breakCount[var]--;
+        } else if (numTrue[cl] == 1) {
+            //The remaining true literal is now the only one
+            breakCount[trueVarXor[cl]]++;
+        }
+    }
+    mems += (occStart[nowTrue.toInt()+1] - occStart[nowTrue.toInt()])
+        + (occStart[nowFalse.toInt()+1] - occStart[nowFalse.toInt()]);
+}
+
+void LocalSearch::make_unsat(const uint32_t cl)
+{
+    unsatAt[cl] = unsat.size();
+    unsat.push_back(cl);
+}
+
+void LocalSearch::make_sat(const uint32_t cl)
+{
+    const uint32_t at = unsatAt[cl];
+    const uint32_t last = unsat.back();
+    unsat[at] = last;
+    unsatAt[last] = at;
+    unsat.pop_back();
+    unsatAt[cl] = std::numeric_limits<uint32_t>::max();
+}
+
+void LocalSearch::save_best()
+{
+    bestUnsat = unsat.size();
+    best = val;
+    mems += val.size()/8;
+}
+
+void LocalSearch::free_mem()
+{
+    vector<Lit>().swap(lits);
+    vector<uint32_t>().swap(clStart);
+    vector<uint32_t>().swap(occStart);
+    vector<uint32_t>().swap(occ);
+    vector<char>().swap(val);
+    vector<char>().swap(fixed);
+    vector<char>().swap(best);
+    vector<uint32_t>().swap(numTrue);
+    vector<Var>().swap(trueVarXor);
+    vector<uint32_t>().swap(breakCount);
+    vector<uint32_t>().swap(unsat);
+    vector<uint32_t>().swap(unsatAt);
+}
+
+void LocalSearch::Stats::print() const
+{
+    cout << "c -------- LOCAL SEARCH STATS --------" << endl;
+    printStatsLine("c time"
+        , cpu_time
+        , cpu_time/(double)numCalls
+        , "per call"
+    );
+
+    printStatsLine("c models found"
+        , numFound
+        , stats_line_percent(numFound, numCalls)
+        , "% of calls"
+    );
+
+    printStatsLine("c flips"
+        , numFlips
+        , (double)numFlips/cpu_time
+        , "per second"
+    );
+
+    printStatsLine("c avg best unsat"
+        , (double)bestUnsatSum/(double)numCalls
+        , stats_line_percent(bestUnsatSum, numCls)
+        , "% of cls"
+    );
+    cout << "c -------- LOCAL SEARCH STATS END --------" << endl;
+}
@@ -0,0 +1,120 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.0 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+#ifndef __LOCALSEARCH_H__
+#define __LOCALSEARCH_H__
+
+#include <vector>
+#include "solvertypes.h"
+
+namespace CMSat {
+
+using std::vector;
+
+class Solver;
+
+/**
+@brief probSAT-style stochastic local search on the irredundant clauses
+
+The binary and tertiary clauses are read from the watchlists, the long ones
+from longIrredCls. Variables set at decision level 0 and the assumptions are
+fixed, everything else starts from the saved polarity. At every step a random
+falsified clause is picked, and one of its variables is flipped with a
+probability that falls polynomially with the number of clauses the flip would
+falsify.
+
+Whatever the outcome, the best assignment found is written back as the saved
+polarities, so a model can be reached by deciding on them.
+*/
+class LocalSearch
+{
+    public:
+        LocalSearch(Solver* solver);
+
+        ///Returns TRUE if the saved polarities now satisfy all irredundant clauses
+        bool run(const vector<Lit>& assumptions);
+
+        struct Stats
+        {
+            void print() const;
+
+            double cpu_time = 0;
+            uint64_t numCalls = 0;
+            uint64_t numFound = 0;
+            uint64_t numFlips = 0;
+            uint64_t numCls = 0;
+            uint64_t bestUnsatSum = 0; ///<Lowest number of falsified clauses, summed over calls
+        };
+        const Stats& getStats() const;
+
+    private:
+        Solver* solver;
+
+        bool init(const vector<Lit>& assumptions);
+        bool add_clause(const Lit* begin, const Lit* end);
+        void build_occur();
+        void init_break_probs();
+        void walk();
+        Var pick_var(uint32_t cl);
+        uint32_t num_break(Var var);
+        void flip(Var var);
+        void make_sat(uint32_t cl);
+        void make_unsat(uint32_t cl);
+        void save_best();
+        void free_mem();
+
+        bool is_true(const Lit lit) const
+        {
+            return val[lit.var()] != lit.sign();
+        }
+
+        //Problem, clauses stored one after the other
+        vector<Lit> lits;
+        vector<uint32_t> clStart; ///<Clause 'i' is lits[clStart[i]..clStart[i+1])
+        vector<uint32_t> occStart; ///<Clauses containing 'lit' are occ[occStart[lit]..occStart[lit+1])
+        vector<uint32_t> occ;
+
+        //Assignment
+        vector<char> val;
+        vector<char> fixed;
+        vector<char> best;
+        vector<uint32_t> numTrue; ///<Number of true literals in each clause
+        vector<Var> trueVarXor; ///<XOR of the variables of the true literals, i.e. the only one if numTrue is 1
+        vector<uint32_t> breakCount; ///<Number of clauses in which the variable is the only true one
+        vector<uint32_t> unsat;
+        vector<uint32_t> unsatAt; ///<Position of the clause in 'unsat'
+        size_t bestUnsat;
+
+        vector<double> breakProb; ///<Weight of a variable with given break count
+        vector<double> tmpProb;
+        uint64_t mems;
+        uint64_t memsLimit;
+        Stats stats;
+};
+
+inline const LocalSearch::Stats& LocalSearch::getStats() const
+{
+    return stats;
+}
+
+} //end namespace
+
+#endif //__LOCALSEARCH_H__
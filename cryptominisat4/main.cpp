@@ -37,6 +37,7 @@ THE SOFTWARE.
 #include "main.h"
 #include "time_mem.h"
 #include "dimacsparser.h"
+#include "binarycnf.h"
 #include "cryptominisat.h"
 
 
@@ -64,6 +65,8 @@ Main::Main(int _argc, char** _argv) :
         debugLib(false)
         , printResult (true)
         , max_nr_of_solutions (1)
+        , num_threads (1)
+        , parse_threads (0)
         , fileNamePresent (false)
         , argc(_argc)
         , argv(_argv)
@@ -107,13 +110,29 @@ void Main::readInAFile(const string& filename)
     if (conf.verbosity >= 1) {
         cout << "c Reading file '" << filename << "'" << endl;
     }
-    #ifndef USE_ZLIB
-        FILE * in = fopen(filename.c_str(), "rb");
-    #else
-        gzFile in = gzopen(filename.c_str(), "rb");
+
+    #ifdef USE_MMAP_INPUT
+    //Plain and binary CNF files are parsed straight from a mapping of the file
+    MappedFile mapped;
+    if (mapped.open(filename.c_str())) {
+        DimacsParser parser(solver, debugLib);
+        if (BinaryCnf::is_binary(mapped.data(), mapped.size())) {
+            parser.parse_binary(mapped.data(), mapped.size());
+            return;
+        }
+        if (InputReader::detect_format(mapped.data(), mapped.size())
+            == InputReader::Format::plain
+        ) {
+            parser.parse_DIMACS_parallel(mapped.data(), mapped.size(), parse_threads);
+            return;
+        }
+    }
+    mapped.close();
     #endif
 
-    if (in == NULL) {
+    //Compressed files are decompressed on a separate thread while parsing
+    InputReader in;
+    if (!in.open(filename)) {
         cout
         << "ERROR! Could not open file '"
         << filename
@@ -123,13 +142,7 @@ void Main::readInAFile(const string& filename)
     }
 
     DimacsParser parser(solver, debugLib);
-    parser.parse_DIMACS(in);
-
-    #ifndef USE_ZLIB
-        fclose(in);
-    #else
-        gzclose(in);
-    #endif
+    parser.parse_DIMACS(&in);
 }
 
 void Main::readInStandardInput()
@@ -140,23 +153,11 @@ void Main::readInStandardInput()
         << endl;
     }
 
-    #ifndef USE_ZLIB
-        FILE * in = stdin;
-    #else
-        gzFile in = gzdopen(fileno(stdin), "rb");
-    #endif
-
-    if (in == NULL) {
-        cout << "ERROR! Could not open standard input for reading" << endl;
-        std::exit(1);
-    }
+    InputReader in;
+    in.open_fd(fileno(stdin));
 
     DimacsParser parser(solver, debugLib);
-    parser.parse_DIMACS(in);
-
-    #ifdef USE_ZLIB
-        gzclose(in);
-    #endif
+    parser.parse_DIMACS(&in);
 }
 
 void Main::parseInAllFiles()
@@ -256,8 +257,10 @@ void Main::add_supported_options()
     ("input", po::value< vector<string> >(), "file(s) to read")
     ("random,r", po::value<unsigned>(&conf.origSeed)->default_value(conf.origSeed)
         , "[0..] Sets random seed")
-//     ("threads,t", po::value<int>(&numThreads)->default_value(1)
-//         , "Number of threads to use")
+    ("threads,t", po::value<unsigned>(&num_threads)->default_value(num_threads)
+        , "Number of threads to use. Threads run differently configured solvers, the first to finish wins")
+    ("parsethreads", po::value<unsigned>(&parse_threads)->default_value(parse_threads)
+        , "Number of threads tokenising large plain input files. 0 = one per core")
     ("maxtime", po::value<double>(&conf.maxTime)->default_value(conf.maxTime, "MAX")
         , "Stop solving after this much time, print stats and exit")
     ("maxconfl", po::value<long>(&conf.maxConfl)->default_value(conf.maxConfl, "MAX")
@@ -303,6 +306,18 @@ void Main::add_supported_options()
         , "Length of the long term trail size for blocking restart")
     ("blkrestmultip", po::value<double>(&conf.blocking_restart_multip)->default_value(conf.blocking_restart_multip, s_blocking_multip.str())
         , "Multiplier used for blocking restart cut-off (called 'R' in Glucose 3.0)")
+    ("reusetrail", po::value<int>(&conf.doReuseTrail)->default_value(conf.doReuseTrail)
+        , "On restart, keep the decision levels that would be picked again in the same order")
+    ;
+
+    po::options_description localSearchOptions("Local search options");
+    localSearchOptions.add_options()
+    ("sls", po::value<int>(&conf.doLocalSearch)->default_value(conf.doLocalSearch)
+        , "Regularly run probSAT-style local search from the saved polarities, and keep its best assignment as the polarities")
+    ("slsevery", po::value<unsigned>(&conf.localSearchEvery)->default_value(conf.localSearchEvery)
+        , "Run local search before every N-th restart")
+    ("slsmems", po::value<uint64_t>(&conf.localSearchTimeLimitM)->default_value(conf.localSearchTimeLimitM)
+        , "Memory accesses (in millions) that one local search call may use")
     ;
 
     std::ostringstream s_perf_multip;
@@ -339,6 +354,14 @@ void Main::add_supported_options()
         , "Clean increment cleaning by this factor for next cleaning")
     ("maxredratio", po::value<double>(&conf.maxNumRedsRatio)->default_value(conf.maxNumRedsRatio)
         , "Don't ever have more than maxNumRedsRatio*(irred_clauses) redundant clauses")
+    ("coreglue", po::value<unsigned>(&conf.coreTierGlue)->default_value(conf.coreTierGlue)
+        , "Redundant clauses with at most this glue are put into the core tier and are never cleaned")
+    ("midglue", po::value<unsigned>(&conf.midTierGlue)->default_value(conf.midTierGlue)
+        , "Redundant clauses with at most this glue are put into the mid tier, and are kept as long as they are used in conflict analysis")
+    ("midclean", po::value<unsigned>(&conf.midTierCleanEvery)->default_value(conf.midTierCleanEvery)
+        , "Demote mid tier clauses not used since the last such check to the local tier every this many clause cleanings")
+    ("clorder", po::value<string>(&clause_order)->default_value(getNameOfClauseOrder(conf.clauseOrder))
+        , "Order of clauses in memory after compacting it: 'alloc' keeps the allocation order, 'watch' puts clauses watched by the same literal next to each other, 'prop' puts the clauses that propagate the most first. Anything but 'alloc' needs a second copy of the compacted clauses while compacting")
     ;
 
     std::ostringstream s_random_var_freq_for_top_N;
@@ -369,6 +392,8 @@ void Main::add_supported_options()
         , "Frequency of increased random  picking brancing variable from top N")
     ("topnincnum", po::value<unsigned>(&conf.random_var_freq_increase_for)->default_value(conf.random_var_freq_increase_for)
         , "Until what decision level should the increase in variable branch randomness be. 0 means none, 1 means only dec. level 0, etc.")
+    ("branch", po::value<string>(&branch_strategy)->default_value(getNameOfBranchStrategy(conf.branchStrategy))
+        , "Pick decision variables with: 'vsids' an activity heap, 'vmtf' a queue where conflicts move variables to the front, 'alternate' switch between the two at every search round")
     ;
 
     po::options_description polar_options("Variable polarity options");
@@ -463,6 +488,26 @@ void Main::add_supported_options()
     //    , "Mix XORs and OrGates for new truths")
     ;
 
+    po::options_description nativeXorOptions("Native XOR options");
+    nativeXorOptions.add_options()
+    ("nativexor", po::value<int>(&conf.doNativeXor)->default_value(conf.doNativeXor)
+        , "Keep long XORs out of the CNF and propagate them on their own. Not done with DRUP or chronological backtracking")
+    ("nativexorsize", po::value<unsigned>(&conf.nativeXorMinSize)->default_value(conf.nativeXorMinSize)
+        , "Only XORs at least this long are kept out of the CNF")
+    ;
+
+    po::options_description gaussOptions("Gauss-Jordan options");
+    gaussOptions.add_options()
+    ("gauss", po::value<int>(&conf.doGauss)->default_value(conf.doGauss)
+        , "Propagate blocks of XORs with Gauss-Jordan elimination during search. Not done with DRUP or chronological backtracking")
+    ("gaussminrows", po::value<unsigned>(&conf.gaussMinMatrixRows)->default_value(conf.gaussMinMatrixRows)
+        , "Smallest number of XORs in a block that gets a matrix")
+    ("gaussmaxrows", po::value<unsigned>(&conf.gaussMaxMatrixRows)->default_value(conf.gaussMaxMatrixRows)
+        , "Largest number of XORs in a block that gets a matrix")
+    ("gaussmaxmat", po::value<unsigned>(&conf.gaussMaxMatrixes)->default_value(conf.gaussMaxMatrixes)
+        , "Maximum number of matrixes")
+    ;
+
     po::options_description eqLitOpts("Equivalent literal options");
     eqLitOpts.add_options()
     ("scc", po::value<int>(&conf.doFindAndReplaceEqLits)->default_value(conf.doFindAndReplaceEqLits)
@@ -503,6 +548,10 @@ void Main::add_supported_options()
         , "Always strong-minimise clause")
     ("otfsubsume", po::value<int>(&conf.doOTFSubsume)->default_value(conf.doOTFSubsume)
         , "Perform on-the-fly subsumption")
+    ("chrono", po::value<int>(&conf.doChronoBT)->default_value(conf.doChronoBT)
+        , "Backtrack only one level after a conflict if the jump would be long. Turns off on-the-fly subsumption and hyper-binary resolution during search")
+    ("chronojump", po::value<unsigned>(&conf.chronoBTJump)->default_value(conf.chronoBTJump)
+        , "Backtrack chronologically if the jump would be at least this many levels. Only active if 'chrono' is on")
     ("rewardotfsubsume", po::value<int>(&conf.rewardShortenedClauseWithConfl)
         ->default_value(conf.rewardShortenedClauseWithConfl)
         , "Reward with this many prop&confl a clause that has been shortened with on-the-fly subsumption")
@@ -518,6 +567,8 @@ void Main::add_supported_options()
         , "Perform lazy hyper-binary resolution while propagating")
     ("binpri", po::value<int>(&conf.propBinFirst)->default_value(conf.propBinFirst)
         , "Propagated binary clauses strictly first")
+    ("simdwatch", po::value<int>(&conf.doSIMDWatchSearch)->default_value(conf.doSIMDWatchSearch)
+        , "Use AVX2 (if the CPU has it) to look for a new watch in long clauses")
     ("otfhyper", po::value<int>(&conf.otfHyperbin)->default_value(conf.otfHyperbin)
         , "Perform hyper-binary resolution at dec. level 1 after every restart and during probing")
     ;
@@ -594,6 +645,10 @@ void Main::add_supported_options()
         , "Renumber variables to increase CPU cache efficiency")
     ("savemem", po::value<int>(&conf.doSaveMem)->default_value(conf.doSaveMem)
         , "Save memory by deallocating variable space after renumbering. Only works if renumbering is active.")
+    ("maxmem", po::value<unsigned long long>(&conf.maxMemMB)->default_value(conf.maxMemMB)
+        , "Memory budget of the solver in MB. When getting close to it, caches are thrown away and redundant clauses are cleaned harder. 0 means no budget")
+    ("memhighwater", po::value<double>(&conf.memBudgetHighWater)->default_value(conf.memBudgetHighWater)
+        , "Start shedding memory when this fraction of the memory budget is used")
     ("implicitmanip", po::value<int>(&conf.doStrSubImplicit)->default_value(conf.doStrSubImplicit)
         , "Subsume and strengthen implicit clauses with each other")
     ;
@@ -609,7 +664,28 @@ void Main::add_supported_options()
     ("compsvar", po::value<size_t>(&conf.compVarLimit)->default_value(conf.compVarLimit)
         , "Only use components in case the number of variables is below this limit")
     ("compslimit", po::value<unsigned long long>(&conf.compFindLimitMega)->default_value(conf.compFindLimitMega)
-        , "Limit how much time is spent in component-finding");
+        , "Limit how much time is spent in component-finding")
+    ("compsthreads", po::value<unsigned>(&conf.compNumThreads)->default_value(conf.compNumThreads)
+        , "Solve this many components in parallel. 0 means one per CPU core");
+
+    po::options_description threadOptions("Multi-threading options");
+    threadOptions.add_options()
+    ("share", po::value<int>(&conf.doShareClauses)->default_value(conf.doShareClauses)
+        , "Share short learnt clauses between the threads")
+    ("sharesize", po::value<unsigned>(&conf.shareMaxSize)->default_value(conf.shareMaxSize)
+        , "Share learnt clauses of at most this size")
+    ("shareglue", po::value<unsigned>(&conf.shareMaxGlue)->default_value(conf.shareMaxGlue)
+        , "Share learnt clauses of at most this glue, irrespective of size")
+    ("sharering", po::value<unsigned>(&conf.shareRingSize)->default_value(conf.shareRingSize)
+        , "Size of each thread's clause sharing buffer, in literals")
+    ("cube", po::value<int>(&conf.doCubeAndConquer)->default_value(conf.doCubeAndConquer)
+        , "Split the problem into cubes with lookahead and let the threads solve the cubes, instead of running a portfolio")
+    ("cubedepth", po::value<unsigned>(&conf.cubeDepth)->default_value(conf.cubeDepth)
+        , "Generate at most 2^N cubes. 0 means decide based on the number of threads")
+    ("cubecands", po::value<unsigned>(&conf.cubeCandidates)->default_value(conf.cubeCandidates)
+        , "Look ahead on this many variables at every split")
+    ("cubetime", po::value<unsigned long long>(&conf.cubeTimeLimitM)->default_value(conf.cubeTimeLimitM)
+        , "Time limit for cube generation, in millions of bogo-props");
 
     p.add("input", 1);
     p.add("drup", 1);
@@ -617,6 +693,7 @@ void Main::add_supported_options()
     cmdline_options
     .add(generalOptions)
     .add(restartOptions)
+    .add(localSearchOptions)
     .add(printOptions)
     .add(propOptions)
     .add(reduceDBOptions)
@@ -629,9 +706,12 @@ void Main::add_supported_options()
     .add(simplificationOptions)
     .add(eqLitOpts)
     .add(componentOptions)
+    .add(threadOptions)
     #ifdef USE_M4RI
     .add(xorOptions)
     #endif
+    .add(nativeXorOptions)
+    .add(gaussOptions)
     .add(gateOptions)
     #ifdef USE_MYSQL
     .add(sqlOptions)
@@ -649,13 +729,17 @@ void Main::check_options_correctness()
         {
             cout
             << "USAGE: " << argv[0] << " [options] <input-files>" << endl
-            << " where input is "
-            #ifndef USE_ZLIB
-            << "plain"
-            #else
-            << "plain or gzipped"
+            << " where input is plain"
+            #ifdef USE_ZLIB
+            << ", gzipped"
+            #endif
+            #ifdef USE_LZMA
+            << ", xz"
+            #endif
+            #ifdef USE_ZSTD
+            << ", zstd"
             #endif
-            << " DIMACS." << endl;
+            << " DIMACS, or binary CNF written by cnf2bin." << endl;
 
             cout << cmdline_options << endl;
             std::exit(0);
@@ -843,6 +927,42 @@ void Main::parse_cleaning_type()
     }
 }
 
+void Main::parse_branch_strategy()
+{
+    if (branch_strategy == getNameOfBranchStrategy(branch_vsids)) {
+        conf.branchStrategy = branch_vsids;
+    } else if (branch_strategy == getNameOfBranchStrategy(branch_vmtf)) {
+        conf.branchStrategy = branch_vmtf;
+    } else if (branch_strategy == getNameOfBranchStrategy(branch_alternate)) {
+        conf.branchStrategy = branch_alternate;
+    } else {
+        std::cerr
+        << "ERROR: Cannot parse option given to '--branch'. It's '"
+        << branch_strategy << "'" << " but that none of the possiblities listed."
+        << endl;
+
+        std::exit(-1);
+    }
+}
+
+void Main::parse_clause_order()
+{
+    if (clause_order == getNameOfClauseOrder(clorder_alloc)) {
+        conf.clauseOrder = clorder_alloc;
+    } else if (clause_order == getNameOfClauseOrder(clorder_watch)) {
+        conf.clauseOrder = clorder_watch;
+    } else if (clause_order == getNameOfClauseOrder(clorder_prop)) {
+        conf.clauseOrder = clorder_prop;
+    } else {
+        std::cerr
+        << "ERROR: Cannot parse option given to '--clorder'. It's '"
+        << clause_order << "'" << " but that none of the possiblities listed."
+        << endl;
+
+        std::exit(-1);
+    }
+}
+
 void Main::parse_var_elim_strategy()
 {
     if (var_elim_strategy == getNameOfElimStrategy(elimstrategy_heuristic)) {
@@ -932,12 +1052,20 @@ void Main::manually_parse_some_options()
     parse_cleaning_type();
     parse_restart_type();
     parse_var_elim_strategy();
+    parse_clause_order();
+    parse_branch_strategy();
+
+    if (num_threads < 1)
+        throw WrongParam("threads", "Num threads must be at least 1");
+
+    if (conf.localSearchEvery < 1)
+        throw WrongParam("slsevery", "Local search must be run at least every 1 restart");
 
-//     if (numThreads < 1)
-//         throw WrongParam("threads", "Num threads must be at least 1");
-//
-//     if (numThreads > 1)
-//         throw WrongParam("threads", "Currently, more than 1 thread is not supported. Sorry!");
+    if (num_threads > 1 && vm.count("drup"))
+        throw WrongParam("threads", "DRUP is not supported with more than 1 thread");
+
+    if (conf.shareRingSize < 1)
+        throw WrongParam("sharering", "Clause sharing buffer must be at least 1 literal long");
 
     if (vm.count("input")) {
         filesToRead = vm["input"].as<vector<string> >();
@@ -1015,6 +1143,9 @@ int Main::solve()
 {
     solver = new SATSolver(conf);
     solverToInterrupt = solver;
+    if (num_threads > 1) {
+        solver->set_num_threads(num_threads);
+    }
     if (drupf) {
         solver->set_drup(drupf);
     }
@@ -1044,7 +1175,7 @@ int Main::solve()
     }
     solver->add_sql_tag("commandline", commandLine);
 
-    //Parse in DIMACS (maybe gzipped) files
+    //Parse in DIMACS (maybe compressed) files
     parseInAllFiles();
 
     //Multi-solutions
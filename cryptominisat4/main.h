@@ -48,12 +48,16 @@ class Main
     private:
         string typeclean;
         string var_elim_strategy;
+        string clause_order;
+        string branch_strategy;
         string drupfilname;
         int drupExistsCheck = 1;
         void add_supported_options();
         void check_options_correctness();
         void manually_parse_some_options();
         void parse_var_elim_strategy();
+        void parse_clause_order();
+        void parse_branch_strategy();
         void parse_cleaning_type();
         void handle_drup_option();
         void parse_restart_type();
@@ -90,6 +94,12 @@ class Main
         //Multi-start solving
         uint32_t max_nr_of_solutions;
 
+        //Portfolio solving
+        unsigned num_threads;
+
+        //Threads tokenising plain input files, 0 = one per core
+        unsigned parse_threads;
+
         //Files to read & write
         bool fileNamePresent;
         vector<string> filesToRead;
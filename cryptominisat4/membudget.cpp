@@ -0,0 +1,279 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.0 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+#include "membudget.h"
+#include "solver.h"
+#include "simplifier.h"
+#include "varreplacer.h"
+#include "clauseallocator.h"
+#include "time_mem.h"
+
+#include <limits>
+#include <iomanip>
+#include <cassert>
+using std::cout;
+using std::endl;
+using namespace CMSat;
+
+MemBudget::MemBudget(Solver* _solver) :
+    solver(_solver)
+{
+}
+
+size_t MemBudget::Usage::total() const
+{
+    return clauses + watches + cache + stamp + simplifier + varReplacer + search;
+}
+
+MemBudget::Usage MemBudget::sample() const
+{
+    Usage usage;
+    usage.clauses = solver->clAllocator.memUsed();
+    usage.clauses += solver->longIrredCls.capacity()*sizeof(ClOffset);
+    usage.clauses += solver->longRedCls.capacity()*sizeof(ClOffset);
+
+    usage.watches = solver->watches.mem_used_alloc();
+    usage.watches += solver->watches.mem_used_array();
+
+    usage.cache = solver->implCache.memUsed();
+    usage.cache += solver->litReachable.capacity()*sizeof(LitReachData);
+    usage.stamp = solver->stamp.memUsed();
+
+    if (solver->simplifier) {
+        usage.simplifier = solver->simplifier->memUsed();
+        usage.simplifier += solver->simplifier->memUsedXor();
+    }
+    usage.varReplacer = solver->varReplacer->memUsed();
+
+    usage.search = solver->memUsed();
+    usage.search += solver->assigns.capacity()*sizeof(lbool);
+    usage.search += solver->varLevel.capacity()*sizeof(uint32_t);
+    usage.search += solver->varReason.capacity()*sizeof(PropBy);
+    usage.search += solver->varData.capacity()*sizeof(VarData);
+
+    return usage;
+}
+
+bool MemBudget::limited() const
+{
+    return solver->conf.maxMemMB > 0;
+}
+
+size_t MemBudget::high_water() const
+{
+    return (double)solver->conf.maxMemMB*1024.0*1024.0
+        * solver->conf.memBudgetHighWater;
+}
+
+bool MemBudget::over() const
+{
+    return sample().total() > high_water();
+}
+
+size_t MemBudget::headroom() const
+{
+    if (!limited())
+        return std::numeric_limits<size_t>::max();
+
+    const size_t used = sample().total();
+    const size_t limit = high_water();
+    return used >= limit ? 0 : limit - used;
+}
+
+void MemBudget::remember(const Usage& usage)
+{
+    stats.maxUsage = std::max(stats.maxUsage, usage.total());
+    lastNonArena = usage.total() - solver->clAllocator.memUsed();
+}
+
+bool MemBudget::clauses_over(const uint64_t sumConfl) const
+{
+    //Leave some conflicts between cleanings, in case the irred clauses alone
+    //are over the budget
+    return limited()
+        && sumConfl >= lastClean + solver->conf.startClean/10
+        && lastNonArena + solver->clAllocator.memUsed() > high_water();
+}
+
+void MemBudget::update_pressure(const bool forced)
+{
+    if (!limited())
+        return;
+
+    lastClean = solver->sumConflicts();
+    stats.forcedCleans += forced;
+
+    const Usage usage = sample();
+    remember(usage);
+    const size_t used = usage.total();
+    if (solver->conf.verbosity >= 2) {
+        print_usage("at cleaning,", usage);
+    }
+
+    //Only let go once comfortably below, so it doesn't flip at every cleaning
+    if (used > high_water()) {
+        if (pressure < maxPressure)
+            pressure++;
+    } else if (used < high_water()*0.8 && pressure > 0) {
+        pressure--;
+    }
+}
+
+double MemBudget::remove_ratio(const double normal) const
+{
+    if (pressure == 0)
+        return normal;
+
+    //Every level of pressure halves what is kept, and how long
+    //clauses are protected from cleaning after being learnt
+    return 1.0 - (1.0 - normal)/(double)(1U << pressure);
+}
+
+void MemBudget::print_usage(const char* what, const Usage& usage) const
+{
+    cout
+    << "c [mem] " << what
+    << " total: " << usage.total()/(1024UL*1024UL) << " MB"
+    << " budget: " << solver->conf.maxMemMB << " MB"
+    << " cls: " << usage.clauses/(1024UL*1024UL)
+    << " watch: " << usage.watches/(1024UL*1024UL)
+    << " cache: " << usage.cache/(1024UL*1024UL)
+    << " stamp: " << usage.stamp/(1024UL*1024UL)
+    << " simp: " << usage.simplifier/(1024UL*1024UL)
+    << " repl: " << usage.varReplacer/(1024UL*1024UL)
+    << " search: " << usage.search/(1024UL*1024UL)
+    << endl;
+}
+
+void MemBudget::enforce()
+{
+    if (!limited())
+        return;
+
+    assert(solver->okay());
+    assert(solver->decisionLevel() == 0);
+    const double myTime = cpuTime();
+    stats.numEnforce++;
+
+    const Usage usage = sample();
+    remember(usage);
+    if (usage.total() <= high_water()) {
+        stats.cpu_time += cpuTime() - myTime;
+        return;
+    }
+    stats.numOver++;
+    if (solver->conf.verbosity >= 1) {
+        print_usage("over high water,", usage);
+    }
+
+    //Giving back unused space loses nothing
+    solver->freeUnusedWatches();
+    solver->watches.consolidate();
+    solver->clAllocator.consolidate(solver, true, true);
+
+    //The caches, stamps and XOR finding only speed things up, so they go
+    //first. They are switched off for good, re-enabling them could push the
+    //solver straight back over the budget
+    if (over() && solver->conf.doCache) {
+        solver->implCache.free();
+        vector<LitReachData> tmp;
+        solver->litReachable.swap(tmp);
+        solver->conf.doCache = false;
+        stats.cacheDropped++;
+    }
+
+    if (over() && solver->conf.doStamp) {
+        solver->stamp.freeMem();
+        solver->conf.doStamp = false;
+        stats.stampDropped++;
+    }
+
+    if (over()
+        && solver->conf.perform_occur_based_simp
+        && solver->conf.doFindXors
+    ) {
+        solver->simplifier->freeXorMem();
+        solver->conf.doFindXors = false;
+        stats.xorDropped++;
+    }
+
+    //Learnt information is the most expensive to lose
+    while(over() && pressure < maxPressure) {
+        pressure++;
+        stats.harderCleans++;
+        solver->reduceDB(false);
+        solver->consolidateMem();
+    }
+
+    if (solver->conf.verbosity >= 1) {
+        print_usage("after shedding,", sample());
+        cout
+        << "c [mem] cache: " << (solver->conf.doCache ? "on" : "off")
+        << " stamp: " << (solver->conf.doStamp ? "on" : "off")
+        << " clean pressure: " << pressure
+        << " T: " << std::setprecision(2) << std::fixed << (cpuTime() - myTime)
+        << endl;
+    }
+    remember(sample());
+    stats.cpu_time += cpuTime() - myTime;
+}
+
+void MemBudget::Stats::print() const
+{
+    cout << "c -------- MEM BUDGET STATS --------" << endl;
+    printStatsLine("c time"
+        , cpu_time
+        , cpu_time/(double)numEnforce
+        , "per call"
+    );
+
+    printStatsLine("c over high water"
+        , numOver
+        , stats_line_percent(numOver, numEnforce)
+        , "% of calls"
+    );
+
+    printStatsLine("c max mem used"
+        , maxUsage/(1024UL*1024UL)
+        , "MB"
+    );
+
+    printStatsLine("c dropped cache"
+        , cacheDropped
+    );
+
+    printStatsLine("c dropped stamp"
+        , stampDropped
+    );
+
+    printStatsLine("c dropped xor"
+        , xorDropped
+    );
+
+    printStatsLine("c harder cleans"
+        , harderCleans
+    );
+
+    printStatsLine("c forced cleans"
+        , forcedCleans
+    );
+    cout << "c -------- MEM BUDGET STATS END --------" << endl;
+}
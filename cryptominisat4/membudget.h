@@ -0,0 +1,124 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.0 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+#ifndef MEMBUDGET_H
+#define MEMBUDGET_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace CMSat {
+
+class Solver;
+
+/**
+@brief Keeps the memory of the solver under conf.maxMemMB
+
+The memory of the subsystems is sampled through their memUsed(). When it gets
+over conf.memBudgetHighWater of the budget, memory is shed, the cheapest first:
+unused watch and clause space is given back, then the implication cache, the
+stamps and the XOR finder's memory are thrown away, and finally the redundant
+clauses are cleaned harder and harder until the usage goes down again. During
+search, the clause database is cleaned ahead of schedule when the clauses push
+the usage over.
+Subsystems that can do without their memory (e.g. occurrence lists) can ask
+for the headroom() before allocating.
+*/
+class MemBudget
+{
+public:
+    MemBudget(Solver* solver);
+
+    struct Usage
+    {
+        size_t total() const;
+
+        size_t clauses = 0;
+        size_t watches = 0;
+        size_t cache = 0;
+        size_t stamp = 0;
+        size_t simplifier = 0;
+        size_t varReplacer = 0;
+        size_t search = 0;
+    };
+    Usage sample() const;
+
+    bool limited() const;
+
+    ///Sheds memory if over the high water mark. Only call at decision level 0
+    void enforce();
+
+    ///Re-samples usage and updates how hard redundant clauses must be cleaned
+    void update_pressure(bool forced);
+    bool under_pressure() const
+    {
+        return pressure > 0;
+    }
+
+    ///Cheap check during search if the clauses have pushed usage over the budget
+    bool clauses_over(uint64_t sumConfl) const;
+
+    ///Fraction of the local tier to remove at a cleaning, given the normal one
+    double remove_ratio(double normal) const;
+    uint64_t min_time_in_db(uint64_t normal) const
+    {
+        return normal >> pressure;
+    }
+
+    ///Bytes that may still be allocated before reaching the high water mark
+    size_t headroom() const;
+
+    struct Stats
+    {
+        void print() const;
+
+        uint64_t numEnforce = 0;
+        uint64_t numOver = 0;
+        uint64_t cacheDropped = 0;
+        uint64_t stampDropped = 0;
+        uint64_t xorDropped = 0;
+        uint64_t harderCleans = 0;
+        uint64_t forcedCleans = 0;
+        size_t maxUsage = 0;
+        double cpu_time = 0;
+    };
+    const Stats& getStats() const
+    {
+        return stats;
+    }
+
+private:
+    Solver* solver;
+    size_t high_water() const;
+    bool over() const;
+    void print_usage(const char* what, const Usage& usage) const;
+    void remember(const Usage& usage);
+
+    static const unsigned maxPressure = 4;
+    unsigned pressure = 0;
+    size_t lastNonArena = 0; ///<Usage outside of the clause arenas at the last sample
+    uint64_t lastClean = 0;
+    Stats stats;
+};
+
+} //end namespace
+
+#endif //MEMBUDGET_H
@@ -24,7 +24,7 @@ void Searcher::find_removable(const vector<Lit>& out_learnt, const uint32_t abst
     trace_lits_minim.clear();
     for (int i = 1, sz = out_learnt.size(); i < sz; i++) {
         const Lit curLit = out_learnt[i];
-        assert(varData[curLit.var()].level > 0);
+        assert(varLevel[curLit.var()] > 0);
 
         if ((seen[curLit.var()] & (2|4|8)) == 0) {
             found_some |= (bool)dfs_removable(curLit, abstract_level);
@@ -39,7 +39,7 @@ int Searcher::quick_keeper(Lit p, uint32_t abstract_level, const bool maykeep)
 {
     // See if I can kill myself right away.
     // maykeep == 1 if I am in the original conflict clause.
-    if (varData[p.var()].reason.isNULL()) {
+    if (varReason[p.var()].isNULL()) {
         return (maykeep ? 2 : 8);
     } else if ((abstractLevel(p.var()) & abstract_level) == 0) {
         assert(maykeep == 0);
@@ -66,11 +66,11 @@ int Searcher::dfs_removable(Lit p, uint32_t abstract_level)
     pstatus = 4;
 
     // rp[0] is p.  The rest of rp are predecessors of p.
-    const PropBy rp = varData[p.var()].reason;
+    const PropBy rp = varReason[p.var()];
     switch (rp.getType()) {
         case tertiary_t : {
             const Lit q = rp.lit3();
-            if (varData[q.var()].level > 0) {
+            if (varLevel[q.var()] > 0) {
                 if ((seen[q.var()] & (2|4|8)) == 0) {
                     found_some |= dfs_removable(q, abstract_level);
                 }
@@ -86,7 +86,7 @@ int Searcher::dfs_removable(Lit p, uint32_t abstract_level)
 
         case binary_t: {
             const Lit q = rp.lit2();
-            if (varData[q.var()].level > 0) {
+            if (varLevel[q.var()] > 0) {
                 if ((seen[q.var()] & (2|4|8)) == 0) {
                     found_some |= dfs_removable(q, abstract_level);
                 }
@@ -107,7 +107,7 @@ int Searcher::dfs_removable(Lit p, uint32_t abstract_level)
                     continue;
 
                 const Lit q = cl[i];
-                if (varData[q.var()].level > 0) {
+                if (varLevel[q.var()] > 0) {
                     if ((seen[q.var()] & (2|4|8)) == 0) {
                         found_some |= dfs_removable(q, abstract_level);
                     }
@@ -142,13 +142,13 @@ int Searcher::dfs_removable(Lit p, uint32_t abstract_level)
 
 void Searcher::mark_needed_removable(const Lit p)
 {
-    const PropBy rp = varData[p.var()].reason;
+    const PropBy rp = varReason[p.var()];
     switch (rp.getType()) {
         case tertiary_t : {
             const Lit q = rp.lit3();
-            if (varData[q.var()].level > 0) {
+            if (varLevel[q.var()] > 0) {
                 const int qseen = seen[q.var()];
-                if ((qseen & (1)) == 0 && !varData[q.var()].reason.isNULL()) {
+                if ((qseen & (1)) == 0 && !varReason[q.var()].isNULL()) {
                     seen[q.var()] |= 1;
                     if (qseen == 0) toClear.push_back(q);
                 }
@@ -158,9 +158,9 @@ void Searcher::mark_needed_removable(const Lit p)
 
         case binary_t : {
             const Lit q  = rp.lit2();
-            if (varData[q.var()].level > 0) {
+            if (varLevel[q.var()] > 0) {
                 const int qseen = seen[q.var()];
-                if ((qseen & (1)) == 0 && !varData[q.var()].reason.isNULL()) {
+                if ((qseen & (1)) == 0 && !varReason[q.var()].isNULL()) {
                     seen[q.var()] |= 1;
                     if (qseen == 0) toClear.push_back(q);
                 }
@@ -175,9 +175,9 @@ void Searcher::mark_needed_removable(const Lit p)
                     continue;
 
                 const Lit q  = cl[i];
-                if (varData[q.var()].level > 0) {
+                if (varLevel[q.var()] > 0) {
                     const int qseen = seen[q.var()];
-                    if ((qseen & (1)) == 0 && !varData[q.var()].reason.isNULL()) {
+                    if ((qseen & (1)) == 0 && !varReason[q.var()].isNULL()) {
                         seen[q.var()] |= 1;
                         if (qseen == 0) toClear.push_back(q);
                     }
@@ -202,12 +202,12 @@ int  Searcher::res_removable()
     while (trace_lits_minim.size() > 0){
         const Lit p = trace_lits_minim.back();
         trace_lits_minim.pop_back();
-        assert(!varData[p.var()].reason.isNULL());
+        assert(!varReason[p.var()].isNULL());
 
         int pseen = seen[p.var()];
         if (pseen & (1)) {
             minim_res_ctr ++;
-            trace_reasons.push_back(varData[p.var()].reason);
+            trace_reasons.push_back(varReason[p.var()]);
             mark_needed_removable(p);
         }
     }
@@ -0,0 +1,146 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.0 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+#ifndef PACKEDMATRIX_H
+#define PACKEDMATRIX_H
+
+#include <vector>
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+
+namespace CMSat {
+
+/**
+@brief A dense GF(2) matrix, every row packed into 64-bit words
+
+The right hand side of the rows is kept apart, so adding a row to another is
+just XOR-ing the words and the two right hand sides.
+*/
+class PackedMatrix
+{
+public:
+    void resize(const uint32_t _numRows, const uint32_t numCols)
+    {
+        numRows = _numRows;
+        numWords = (numCols + 63)/64;
+        bits.assign((size_t)numRows*numWords, 0);
+        rhs.assign(numRows, 0);
+    }
+
+    uint32_t getNumRows() const
+    {
+        return numRows;
+    }
+
+    uint32_t getNumWords() const
+    {
+        return numWords;
+    }
+
+    uint64_t* row(const uint32_t r)
+    {
+        return bits.data() + (size_t)r*numWords;
+    }
+
+    const uint64_t* row(const uint32_t r) const
+    {
+        return bits.data() + (size_t)r*numWords;
+    }
+
+    bool get(const uint32_t r, const uint32_t col) const
+    {
+        return (row(r)[col/64] >> (col%64)) & 1;
+    }
+
+    void flip(const uint32_t r, const uint32_t col)
+    {
+        row(r)[col/64] ^= 1ULL << (col%64);
+    }
+
+    bool getRhs(const uint32_t r) const
+    {
+        return rhs[r];
+    }
+
+    void flipRhs(const uint32_t r)
+    {
+        rhs[r] ^= 1;
+    }
+
+    ///Row 'dest' += row 'src'
+    void addRow(const uint32_t dest, const uint32_t src)
+    {
+        uint64_t* d = row(dest);
+        const uint64_t* s = row(src);
+        for(uint32_t i = 0; i < numWords; i++) {
+            d[i] ^= s[i];
+        }
+        rhs[dest] ^= rhs[src];
+    }
+
+    void swapRows(const uint32_t a, const uint32_t b)
+    {
+        uint64_t* ra = row(a);
+        uint64_t* rb = row(b);
+        for(uint32_t i = 0; i < numWords; i++) {
+            std::swap(ra[i], rb[i]);
+        }
+        std::swap(rhs[a], rhs[b]);
+    }
+
+    ///Keeps only the first 'num' rows
+    void shrink(const uint32_t num)
+    {
+        assert(num <= numRows);
+        numRows = num;
+        bits.resize((size_t)numRows*numWords);
+        rhs.resize(numRows);
+    }
+
+    ///Calls f(col) for every column set in the row, in increasing order
+    template<class F> void forEachSet(const uint32_t r, F f) const
+    {
+        const uint64_t* d = row(r);
+        for(uint32_t i = 0; i < numWords; i++) {
+            uint64_t w = d[i];
+            while(w) {
+                f(i*64 + __builtin_ctzll(w));
+                w &= w-1;
+            }
+        }
+    }
+
+    size_t memUsed() const
+    {
+        return bits.capacity()*sizeof(uint64_t) + rhs.capacity();
+    }
+
+private:
+    std::vector<uint64_t> bits;
+    std::vector<unsigned char> rhs;
+    uint32_t numRows = 0;
+    uint32_t numWords = 0;
+};
+
+} //end namespace
+
+#endif //PACKEDMATRIX_H
@@ -436,7 +436,7 @@ void Prober::clearUpBeforeFirstSet()
 void Prober::updateCache(Lit thisLit, Lit lit, size_t numElemsSet)
 {
     //Update cache, if the trail was within limits (cacheUpdateCutoff)
-    const Lit ancestor = solver->varData[thisLit.var()].reason.getAncestor();
+    const Lit ancestor = solver->varReason[thisLit.var()].getAncestor();
     if (solver->conf.doCache
         && thisLit != lit
         && numElemsSet <= solver->conf.cacheUpdateCutoff
@@ -445,15 +445,15 @@ void Prober::updateCache(Lit thisLit, Lit lit, size_t numElemsSet)
         //Update stats/markings
         //cacheUpdated[(~ancestor).toInt()]++;
         extraTime += 1;
-        extraTimeCache += solver->implCache[(~ancestor).toInt()].lits.size()/30;
-        extraTimeCache += solver->implCache[(~thisLit).toInt()].lits.size()/30;
+        extraTimeCache += solver->implCache[(~ancestor).toInt()].size()/30;
+        extraTimeCache += solver->implCache[(~thisLit).toInt()].size()/30;
 
-        const bool redStep = solver->varData[thisLit.var()].reason.isRedStep();
+        const bool redStep = solver->varReason[thisLit.var()].isRedStep();
 
         //Update the cache now
         assert(ancestor != lit_Undef);
         bool taut = solver->implCache[(~ancestor).toInt()].merge(
-            solver->implCache[(~thisLit).toInt()].lits
+            solver->implCache[(~thisLit).toInt()]
             , thisLit
             , redStep
             , ancestor.var()
@@ -32,18 +32,19 @@
 
 namespace CMSat {
 
-enum PropByType {null_clause_t = 0, clause_t = 1, binary_t = 2, tertiary_t = 3};
+enum PropByType {null_clause_t = 0, clause_t = 1, binary_t = 2, tertiary_t = 3, xor_t = 4};
 
 class PropBy
 {
     private:
         uint32_t data1;
-        uint32_t type:2;
+        uint32_t type:3;
         //0: clause, NULL
         //1: clause, non-null
         //2: binary
         //3: tertiary
-        uint32_t data2:30;
+        //4: native XOR, its clause not yet made
+        uint32_t data2:29;
 
     public:
         PropBy() :
@@ -61,6 +62,7 @@ class PropBy
         PropBy(const Lit lit) :
             data1(lit.toInt())
             , type(binary_t)
+            , data2(0)
         {
         }
 
@@ -94,6 +96,23 @@ class PropBy
         {
         }
 
+        //For native XORs. The reason clause is only made when it is needed
+        static PropBy xor_reason(const uint32_t xor_offset)
+        {
+            PropBy ret;
+            ret.data1 = xor_offset;
+            ret.type = xor_t;
+            return ret;
+        }
+
+        uint32_t getXor() const
+        {
+            #ifdef DEBUG_PROPAGATEFROM
+            assert(type == xor_t);
+            #endif
+            return data1;
+        }
+
         bool isRedStep() const
         {
             return data2 & 1U;
@@ -196,6 +215,10 @@ inline std::ostream& operator<<(std::ostream& os, const PropBy& pb)
             os << " clause, num= " << pb.getClause();
             break;
 
+        case xor_t :
+            os << " XOR, offset= " << pb.getXor();
+            break;
+
         case null_clause_t :
             os << " NULL";
             break;
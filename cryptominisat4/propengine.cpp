@@ -53,7 +53,9 @@ PropEngine::PropEngine(
         // Stats
         , qhead(0)
         , agility(_conf.agilityG, _conf.agilityLimit)
+        , findNonFalse(get_non_false_finder(_conf.doSIMDWatchSearch))
 {
+    select_propagate_func();
 }
 
 PropEngine::~PropEngine()
@@ -216,6 +218,7 @@ Need to be somewhat tricky if the clause indicates that current assignement
 is incorrect (i.e. both literals evaluate to FALSE). If conflict if found,
 sets failBinLit
 */
+template<bool update_stats, bool chrono>
 inline bool PropEngine::propBinaryClause(
     watch_subarray_const::const_iterator i
     , const Lit p
@@ -224,13 +227,19 @@ inline bool PropEngine::propBinaryClause(
     const lbool val = value(i->lit2());
     if (val == l_Undef) {
         #ifdef STATS_NEEDED
-        if (i->red())
-            propStats.propsBinRed++;
-        else
-            propStats.propsBinIrred++;
+        if (update_stats) {
+            if (i->red())
+                propStats.propsBinRed++;
+            else
+                propStats.propsBinIrred++;
+        }
         #endif
 
-        enqueue(i->lit2(), PropBy(~p));
+        enqueue(
+            i->lit2()
+            , chrono ? varLevel[p.var()] : decisionLevel()
+            , PropBy(~p)
+        );
     } else if (val == l_False) {
         //Update stats
         if (i->red())
@@ -253,11 +262,11 @@ void PropEngine::lazy_hyper_bin_resolve(
     , ClOffset offset
 ) {
     //Do lazy hyper-binary resolution if possible
-    const Lit other = varData[c[1].var()].reason.lit2();
+    const Lit other = varReason[c[1].var()].lit2();
     bool OK = true;
     for(uint32_t i = 2; i < c.size(); i++) {
-        if (varData[c[i].var()].reason.getType() != binary_t
-            || other != varData[c[i].var()].reason.lit2()
+        if (varReason[c[i].var()].getType() != binary_t
+            || other != varReason[c[i].var()].lit2()
         ) {
             OK = false;
             break;
@@ -282,14 +291,66 @@ void PropEngine::lazy_hyper_bin_resolve(
 void PropEngine::update_glue(Clause& c)
 {
     if (c.red()
-        && c.stats.glue > 2
-        && conf.updateGlues
+        && clAllocator.getStats(c).glue > 2
     ) {
         uint32_t newGlue = calcGlue(c);
-        c.stats.glue = std::min(c.stats.glue, newGlue);
+        clAllocator.getStats(c).glue = std::min(clAllocator.getStats(c).glue, newGlue);
+        promote_red_tier(clAllocator.getStats(c));
+    }
+}
+
+///Moves the clause into a better tier if its glue allows, never demotes
+void PropEngine::promote_red_tier(ClauseStats& stats) const
+{
+    if (stats.glue <= conf.coreTierGlue) {
+        stats.tier = RedTier::core;
+    } else if (stats.glue <= conf.midTierGlue
+        && stats.tier == RedTier::local
+    ) {
+        stats.tier = RedTier::mid;
     }
 }
 
+inline uint32_t PropEngine::implied_level_tri(const Lit lit1, const Lit lit3) const
+{
+    return std::max(varLevel[lit1.var()], varLevel[lit3.var()]);
+}
+
+/**
+@brief Finds the level c[0] is implied at when c[1..] are all false
+
+Also moves the highest level literal to c[1], so that the clause stays
+watched by the literal that is unassigned first on backtrack.
+
+@returns TRUE if c[1] changed, in which case the clause is now watched by the
+new c[1] and the caller must drop the old watch
+*/
+bool PropEngine::watch_highest_level_lit(
+    Clause& c
+    , const ClOffset offset
+    , uint32_t& level
+) {
+    level = varLevel[c[1].var()];
+    if (level == decisionLevel())
+        return false;
+
+    uint32_t at = 1;
+    for(uint32_t k = 2; k < c.size(); k++) {
+        const uint32_t lev = varLevel[c[k].var()];
+        if (lev > level) {
+            level = lev;
+            at = k;
+        }
+    }
+    if (at == 1)
+        return false;
+
+    std::swap(c[1], c[at]);
+    watches[c[1].toInt()].push(Watched(offset, c[0]));
+    return true;
+}
+
+template<bool update_stats>
 PropResult PropEngine::prop_normal_helper(
     Clause& c
     , ClOffset offset
@@ -297,8 +358,10 @@ PropResult PropEngine::prop_normal_helper(
     , const Lit p
 ) {
     #ifdef STATS_NEEDED
-    c.stats.clause_looked_at++;
-    c.stats.visited_literals++;
+    if (update_stats) {
+        clAllocator.getStats(c).clause_looked_at++;
+        clAllocator.getStats(c).visited_literals++;
+    }
     #endif
 
     // Make sure the false literal is data[1]:
@@ -316,28 +379,21 @@ PropResult PropEngine::prop_normal_helper(
     }
 
     // Look for new watch:
-    uint32_t numLitVisited = 0;
-    for (Lit *k = c.begin() + 2, *end2 = c.end()
-        ; k != end2
-        ; k++, numLitVisited++
-    ) {
-        //Literal is either unset or satisfied, attach to other watchlist
-        if (value(*k) != l_False) {
-            c[1] = *k;
-            #ifdef STATS_NEEDED
-            //propStats.bogoProps += numLitVisited/10;
-            c.stats.visited_literals+= numLitVisited;
-            #endif
-            *k = ~p;
-            watches[c[1].toInt()].push(Watched(offset, c[0]));
-            return PROP_NOTHING;
-        }
-    }
+    Lit* const k = find_new_watch(c.begin() + 2, c.end());
     #ifdef STATS_NEEDED
-    //propStats.bogoProps += numLitVisited/10;
-    c.stats.visited_literals+= numLitVisited;
+    if (update_stats) {
+        clAllocator.getStats(c).visited_literals+= k - (c.begin() + 2);
+    }
     #endif
 
+    //Literal is either unset or satisfied, attach to other watchlist
+    if (k != c.end()) {
+        c[1] = *k;
+        *k = ~p;
+        watches[c[1].toInt()].push(Watched(offset, c[0]));
+        return PROP_NOTHING;
+    }
+
     return PROP_TODO;
 }
 
@@ -356,8 +412,8 @@ PropResult PropEngine::handle_normal_prop_fail(
     #endif //VERBOSE_DEBUG_FULLPROP
 
     //Update stats
-    c.stats.conflicts_made++;
-    c.stats.sum_of_branch_depth_conflict += decisionLevel() + 1;
+    clAllocator.getStats(c).conflicts_made++;
+    clAllocator.getStats(c).sum_of_branch_depth_conflict += decisionLevel() + 1;
     if (c.red())
         lastConflictCausedBy = ConflCausedBy::longred;
     else
@@ -367,6 +423,7 @@ PropResult PropEngine::handle_normal_prop_fail(
     return PROP_FAIL;
 }
 
+template<bool update_stats, bool do_lhbr, bool update_glues, bool chrono>
 PropResult PropEngine::propNormalClause(
     watch_subarray_const::const_iterator i
     , watch_subarray::iterator &j
@@ -384,40 +441,49 @@ PropResult PropEngine::propNormalClause(
     const ClOffset offset = i->getOffset();
     Clause& c = *clAllocator.getPointer(offset);
 
-    PropResult ret = prop_normal_helper(c, offset, j, p);
+    PropResult ret = prop_normal_helper<update_stats>(c, offset, j, p);
     if (ret != PROP_TODO)
         return ret;
 
     // Did not find watch -- clause is unit under assignment:
-    *j++ = *i;
     if (value(c[0]) == l_False) {
+        *j++ = *i;
         return handle_normal_prop_fail(c, offset, confl);
     }
+    uint32_t level = decisionLevel();
+    if (!chrono || !watch_highest_level_lit(c, offset, level)) {
+        *j++ = *i;
+    }
 
     //Update stats
-    c.stats.propagations_made++;
-    c.stats.sum_of_branch_depth_propagation += decisionLevel() + 1;
+    clAllocator.getStats(c).propagations_made++;
+    clAllocator.getStats(c).sum_of_branch_depth_propagation += decisionLevel() + 1;
     #ifdef STATS_NEEDED
-    if (c.red())
-        propStats.propsLongRed++;
-    else
-        propStats.propsLongIrred++;
+    if (update_stats) {
+        if (c.red())
+            propStats.propsLongRed++;
+        else
+            propStats.propsLongIrred++;
+    }
     #endif
 
-    if (conf.doLHBR
-        && varData[c[1].var()].reason.getType() == binary_t
+    if (do_lhbr
+        && varReason[c[1].var()].getType() == binary_t
     ) {
         lazy_hyper_bin_resolve(c, offset);
     } else {
-        enqueue(c[0], PropBy(offset));
+        enqueue(c[0], level, PropBy(offset));
     }
 
-    update_glue(c);
+    if (update_glues) {
+        update_glue(c);
+    }
 
     return PROP_SOMETHING;
 }
 
 
+template<bool update_stats, bool update_glues, bool chrono>
 bool PropEngine::propNormalClauseAnyOrder(
     watch_subarray_const::const_iterator i
     , watch_subarray::iterator &j
@@ -433,8 +499,10 @@ bool PropEngine::propNormalClauseAnyOrder(
     const ClOffset offset = i->getOffset();
     Clause& c = *clAllocator.getPointer(offset);
     #ifdef STATS_NEEDED
-    c.stats.clause_looked_at++;
-    c.stats.visited_literals++;
+    if (update_stats) {
+        clAllocator.getStats(c).clause_looked_at++;
+        clAllocator.getStats(c).visited_literals++;
+    }
     #endif
 
     // Make sure the false literal is data[1]:
@@ -452,36 +520,24 @@ bool PropEngine::propNormalClauseAnyOrder(
     }
 
     // Look for new watch:
+    Lit* const k = find_new_watch(c.begin() + 2, c.end());
     #ifdef STATS_NEEDED
-    uint numLitVisited = 2;
-    #endif
-    for (Lit *k = c.begin() + 2, *end2 = c.end()
-        ; k != end2
-        ; k++
-        #ifdef STATS_NEEDED
-        , numLitVisited++
-        #endif
-    ) {
-        //Literal is either unset or satisfied, attach to other watchlist
-        if (value(*k) != l_False) {
-            c[1] = *k;
-            //propStats.bogoProps += numLitVisited/10;
-            #ifdef STATS_NEEDED
-            c.stats.visited_literals+= numLitVisited;
-            #endif
-            *k = ~p;
-            watches[c[1].toInt()].push(Watched(offset, c[0]));
-            return true;
-        }
+    if (update_stats) {
+        clAllocator.getStats(c).visited_literals+= 2 + (k - (c.begin() + 2));
     }
-    #ifdef STATS_NEEDED
-    //propStats.bogoProps += numLitVisited/10;
-    c.stats.visited_literals+= numLitVisited;
     #endif
 
+    //Literal is either unset or satisfied, attach to other watchlist
+    if (k != c.end()) {
+        c[1] = *k;
+        *k = ~p;
+        watches[c[1].toInt()].push(Watched(offset, c[0]));
+        return true;
+    }
+
     // Did not find watch -- clause is unit under assignment:
-    *j++ = *i;
     if (value(c[0]) == l_False) {
+        *j++ = *i;
 
         confl = PropBy(offset);
         #ifdef VERBOSE_DEBUG_FULLPROP
@@ -493,8 +549,8 @@ bool PropEngine::propNormalClauseAnyOrder(
         #endif //VERBOSE_DEBUG_FULLPROP
 
         //Update stats
-        c.stats.conflicts_made++;
-        c.stats.sum_of_branch_depth_conflict += decisionLevel() + 1;
+        clAllocator.getStats(c).conflicts_made++;
+        clAllocator.getStats(c).sum_of_branch_depth_conflict += decisionLevel() + 1;
         if (c.red())
             lastConflictCausedBy = ConflCausedBy::longred;
         else
@@ -503,25 +559,26 @@ bool PropEngine::propNormalClauseAnyOrder(
         qhead = trail.size();
         return false;
     } else {
+        uint32_t level = decisionLevel();
+        if (!chrono || !watch_highest_level_lit(c, offset, level)) {
+            *j++ = *i;
+        }
 
         //Update stats
-        c.stats.propagations_made++;
-        c.stats.sum_of_branch_depth_propagation += decisionLevel() + 1;
+        clAllocator.getStats(c).propagations_made++;
+        clAllocator.getStats(c).sum_of_branch_depth_propagation += decisionLevel() + 1;
         #ifdef STATS_NEEDED
-        if (c.red())
-            propStats.propsLongRed++;
-        else
-            propStats.propsLongIrred++;
+        if (update_stats) {
+            if (c.red())
+                propStats.propsLongRed++;
+            else
+                propStats.propsLongIrred++;
+        }
         #endif
-        enqueue(c[0], PropBy(offset));
+        enqueue(c[0], level, PropBy(offset));
 
-        //Update glues?
-        if (c.red()
-            && c.stats.glue > 2
-            && conf.updateGlues
-        ) {
-            uint32_t newGlue = calcGlue(c);
-            c.stats.glue = std::min(c.stats.glue, newGlue);
+        if (update_glues) {
+            update_glue(c);
         }
     }
 
@@ -552,6 +609,7 @@ PropResult PropEngine::handle_prop_tri_fail(
     return PROP_FAIL;
 }
 
+template<bool update_stats, bool do_lhbr, bool chrono>
 PropResult PropEngine::propTriClause(
     watch_subarray_const::const_iterator i
     , const Lit lit1
@@ -576,16 +634,17 @@ PropResult PropEngine::propTriClause(
     }
 
     if (val2 == l_Undef && val3 == l_False) {
-        return propTriHelperSimple(lit1, lit2, lit3, i->red());
+        return propTriHelperSimple<update_stats, do_lhbr, chrono>(lit1, lit2, lit3, i->red());
     }
 
     if (val3 == l_Undef && val2 == l_False) {
-        return propTriHelperSimple(lit1, lit3, lit2, i->red());
+        return propTriHelperSimple<update_stats, do_lhbr, chrono>(lit1, lit3, lit2, i->red());
     }
 
     return PROP_NOTHING;
 }
 
+template<bool update_stats, bool chrono>
 inline bool PropEngine::propTriClauseAnyOrder(
     watch_subarray_const::const_iterator i
     , const Lit lit1
@@ -625,26 +684,12 @@ inline bool PropEngine::propTriClauseAnyOrder(
         return false;
     }
     if (val2 == l_Undef && val3 == l_False) {
-        propTriHelperAnyOrder(
-            lit1
-            , lit2
-            , lit3
-            #ifdef STATS_NEEDED
-            , i->red()
-            #endif
-        );
+        propTriHelperAnyOrder<update_stats, chrono>(lit1, lit2, lit3, i->red());
         return true;
     }
 
     if (val3 == l_Undef && val2 == l_False) {
-        propTriHelperAnyOrder(
-            lit1
-            , lit3
-            , lit2
-            #ifdef STATS_NEEDED
-            , i->red()
-            #endif
-        );
+        propTriHelperAnyOrder<update_stats, chrono>(lit1, lit3, lit2, i->red());
         return true;
     }
 
@@ -653,7 +698,7 @@ inline bool PropEngine::propTriClauseAnyOrder(
 
 void PropEngine::lazy_hyper_bin_resolve(Lit lit1, Lit lit2)
 {
-    Lit lit= varData[lit1.var()].reason.lit2();
+    Lit lit= varReason[lit1.var()].lit2();
 
     attachBinClause(lit, lit2, true, false);
     enqueue(lit2, PropBy(lit));
@@ -666,14 +711,15 @@ void PropEngine::lazy_hyper_bin_resolve(Lit lit1, Lit lit2)
 bool PropEngine::can_do_lazy_hyper_bin(Lit lit1, Lit lit2, Lit lit3)
 {
     bool ret;
-    ret = varData[lit1.var()].reason.getType() == binary_t
-        && ((varData[lit3.var()].reason.getType() == binary_t
-        && varData[lit3.var()].reason.lit2() == varData[lit1.var()].reason.lit2())
-        || (varData[lit1.var()].reason.lit2().var() == lit3.var()));
+    ret = varReason[lit1.var()].getType() == binary_t
+        && ((varReason[lit3.var()].getType() == binary_t
+        && varReason[lit3.var()].lit2() == varReason[lit1.var()].lit2())
+        || (varReason[lit1.var()].lit2().var() == lit3.var()));
 
     return ret;
 }
 
+template<bool update_stats, bool do_lhbr, bool chrono>
 PropResult PropEngine::propTriHelperSimple(
     const Lit lit1
     , const Lit lit2
@@ -681,46 +727,63 @@ PropResult PropEngine::propTriHelperSimple(
     , const bool red
 ) {
     #ifdef STATS_NEEDED
-    if (red)
-        propStats.propsTriRed++;
-    else
-        propStats.propsTriIrred++;
+    if (update_stats) {
+        if (red)
+            propStats.propsTriRed++;
+        else
+            propStats.propsTriIrred++;
+    }
     #endif
 
     //Check if we could do lazy hyper-binary resoution
-    if (conf.doLHBR
+    if (do_lhbr
         && can_do_lazy_hyper_bin(lit1, lit2, lit3)
     ) {
         lazy_hyper_bin_resolve(lit1, lit2);
     } else {
         //Lazy hyper-bin is not possibe
-        enqueue(lit2, PropBy(~lit1, lit3));
+        enqueue(
+            lit2
+            , chrono ? implied_level_tri(lit1, lit3) : decisionLevel()
+            , PropBy(~lit1, lit3)
+        );
     }
 
     return PROP_SOMETHING;
 }
 
+template<bool update_stats, bool chrono>
 inline void PropEngine::propTriHelperAnyOrder(
     const Lit lit1
     , const Lit lit2
     , const Lit lit3
-    #ifdef STATS_NEEDED
     , const bool red
-    #endif
 ) {
     #ifdef STATS_NEEDED
-    if (red)
-        propStats.propsTriRed++;
-    else
-        propStats.propsTriIrred++;
+    if (update_stats) {
+        if (red)
+            propStats.propsTriRed++;
+        else
+            propStats.propsTriIrred++;
+    }
+    #else
+    (void)red;
     #endif
 
     //Lazy hyper-bin is not possibe
-    enqueue(lit2, PropBy(~lit1, lit3));
+    enqueue(
+        lit2
+        , chrono ? implied_level_tri(lit1, lit3) : decisionLevel()
+        , PropBy(~lit1, lit3)
+    );
 }
 
-PropBy PropEngine::propagateAnyOrder()
-{
+template<bool update_stats, bool update_glues, bool chrono>
+PropBy PropEngine::propagateAnyOrder(
+    #ifdef STATS_NEEDED
+    AvgCalc<size_t>* /*watchListSizeTraversed*/
+    #endif
+) {
     PropBy confl;
 
     #ifdef VERBOSE_DEBUG_PROP
@@ -737,7 +800,7 @@ PropBy PropEngine::propagateAnyOrder()
         for (; i != end; i++) {
             if (i->isBinary()) {
                 *j++ = *i;
-                if (!propBinaryClause(i, p, confl)) {
+                if (!propBinaryClause<update_stats, chrono>(i, p, confl)) {
                     i++;
                     break;
                 }
@@ -748,7 +811,7 @@ PropBy PropEngine::propagateAnyOrder()
             //Propagate tri clause
             if (i->isTri()) {
                 *j++ = *i;
-                if (!propTriClauseAnyOrder(i, p, confl)) {
+                if (!propTriClauseAnyOrder<update_stats, chrono>(i, p, confl)) {
                     i++;
                     break;
                 }
@@ -757,7 +820,7 @@ PropBy PropEngine::propagateAnyOrder()
 
             //propagate normal clause
             if (i->isClause()) {
-                if (!propNormalClauseAnyOrder(i, j, p, confl)) {
+                if (!propNormalClauseAnyOrder<update_stats, update_glues, chrono>(i, j, p, confl)) {
                     i++;
                     break;
                 }
@@ -862,6 +925,8 @@ void PropEngine::updateVars(
     , const vector<uint32_t>& interToOuter
     , const vector<uint32_t>& interToOuter2
 ) {
+    updateArray(varLevel, interToOuter);
+    updateArray(varReason, interToOuter);
     updateArray(varData, interToOuter);
     #ifdef STATS_NEEDED
     updateArray(varDataLT, interToOuter);
@@ -926,6 +991,7 @@ inline void PropEngine::updateWatch(
     }
 }
 
+template<bool update_stats, bool do_lhbr, bool update_glues, bool chrono>
 PropBy PropEngine::propagateBinFirst(
     #ifdef STATS_NEEDED
     AvgCalc<size_t>* watchListSizeTraversed
@@ -945,7 +1011,7 @@ PropBy PropEngine::propagateBinFirst(
         const Lit p = trail[qhead++];     // 'p' is enqueued fact to propagate.
         watch_subarray_const ws = watches[(~p).toInt()];
         #ifdef STATS_NEEDED
-        if (watchListSizeTraversed)
+        if (update_stats && watchListSizeTraversed)
             watchListSizeTraversed->push(ws.size());
         #endif
 
@@ -956,7 +1022,7 @@ PropBy PropEngine::propagateBinFirst(
 
             //Propagate binary clause
             if (i->isBinary()) {
-                if (!propBinaryClause(i, p, confl)) {
+                if (!propBinaryClause<update_stats, chrono>(i, p, confl)) {
                     break;
                 }
 
@@ -993,7 +1059,7 @@ PropBy PropEngine::propagateBinFirst(
             if (i->isTri()) {
                 *j++ = *i;
                 //Propagate tri clause
-                ret = propTriClause(i, p, confl);
+                ret = propTriClause<update_stats, do_lhbr, chrono>(i, p, confl);
                  if (ret == PROP_SOMETHING || ret == PROP_FAIL) {
                     //Conflict or propagated something
                     i++;
@@ -1006,7 +1072,7 @@ PropBy PropEngine::propagateBinFirst(
             } //end TRICLAUSE
 
             if (i->isClause()) {
-                ret = propNormalClause(i, j, p, confl);
+                ret = propNormalClause<update_stats, do_lhbr, update_glues, chrono>(i, j, p, confl);
                  if (ret == PROP_SOMETHING || ret == PROP_FAIL) {
                     //Conflict or propagated something
                     i++;
@@ -1038,6 +1104,54 @@ PropBy PropEngine::propagateBinFirst(
     return confl;
 }
 
+template<bool update_stats, bool chrono>
+PropEngine::PropagateFunc PropEngine::get_propagate_func() const
+{
+    if (!conf.propBinFirst) {
+        //LHBR needs binary clauses propagated first, see Solver::solve()
+        if (conf.updateGlues)
+            return &PropEngine::propagateAnyOrder<update_stats, true, chrono>;
+        else
+            return &PropEngine::propagateAnyOrder<update_stats, false, chrono>;
+    }
+
+    //LHBR would put the new binary at the current level, it is not done
+    //while backtracking chronologically
+    if (conf.doLHBR && !chrono) {
+        if (conf.updateGlues)
+            return &PropEngine::propagateBinFirst<update_stats, true, true, false>;
+        else
+            return &PropEngine::propagateBinFirst<update_stats, true, false, false>;
+    } else {
+        if (conf.updateGlues)
+            return &PropEngine::propagateBinFirst<update_stats, false, true, chrono>;
+        else
+            return &PropEngine::propagateBinFirst<update_stats, false, false, chrono>;
+    }
+}
+
+void PropEngine::select_propagate_func()
+{
+    //The detailed propagation stats are only looked at when they are
+    //printed or written to the database
+    bool stats = false;
+    #ifdef STATS_NEEDED
+    stats = conf.doSQL || conf.verbosity >= 1;
+    #endif
+
+    if (stats) {
+        if (conf.doChronoBT)
+            propagate_func = get_propagate_func<true, true>();
+        else
+            propagate_func = get_propagate_func<true, false>();
+    } else {
+        if (conf.doChronoBT)
+            propagate_func = get_propagate_func<false, true>();
+        else
+            propagate_func = get_propagate_func<false, false>();
+    }
+}
+
 PropBy PropEngine::propagateIrredBin()
 {
     PropBy confl;
@@ -1051,7 +1165,7 @@ PropBy PropEngine::propagateIrredBin()
                 continue;
 
             //Propagate, if conflict, exit
-            if (!propBinaryClause(k, p, confl))
+            if (!propBinaryClause<true, false>(k, p, confl))
                 return confl;
         }
     }
@@ -1065,8 +1179,16 @@ void PropEngine::print_trail()
     for(size_t i = trail_lim[0]; i < trail.size(); i++) {
         cout
         << "trail " << i << ":" << trail[i]
-        << " lev: " << varData[trail[i].var()].level
-        << " reason: " << varData[trail[i].var()].reason
+        << " lev: " << varLevel[trail[i].var()]
+        << " reason: " << varReason[trail[i].var()]
         << endl;
     }
 }
+
+//HyperEngine uses it for its own propagation
+template PropResult PropEngine::prop_normal_helper<true>(
+    Clause& c
+    , ClOffset offset
+    , watch_subarray::iterator &j
+    , const Lit p
+);
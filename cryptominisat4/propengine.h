@@ -86,8 +86,8 @@ struct PolaritySorter
 
         //Tie 2: last level
         /*assert(pol1 == pol2);
-        if (pol1 == true) return varData[lit1.var()].level < varData[lit2.var()].level;
-        else return varData[lit1.var()].level > varData[lit2.var()].level;*/
+        if (pol1 == true) return varLevel[lit1.var()] < varLevel[lit2.var()];
+        else return varLevel[lit1.var()] > varLevel[lit2.var()];*/
 
         return false;
     }
@@ -144,14 +144,40 @@ protected:
     Lit                 failBinLit;       ///< Used to store which watches[lit] we were looking through when conflict occured
 
     void   enqueue (const Lit p, const PropBy from = PropBy());
+    void   enqueue (const Lit p, const uint32_t level, const PropBy from);
     void   newDecisionLevel();
-    PropBy propagateAnyOrder();
+
+    /**
+    @brief The propagation loop, specialised for the configuration
+
+    Call select_propagate_func() when doLHBR, propBinFirst, updateGlues,
+    doChronoBT, doSQL or verbosity change, so that the loop does not check
+    them for every watch.
+    */
+    typedef PropBy (PropEngine::*PropagateFunc)(
+        #ifdef STATS_NEEDED
+        AvgCalc<size_t>* watchListSizeTraversed
+        #endif
+    );
+    PropagateFunc propagate_func;
+    void select_propagate_func();
+    template<bool update_stats, bool chrono>
+    PropagateFunc get_propagate_func() const;
+
+    template<bool update_stats, bool update_glues, bool chrono>
+    PropBy propagateAnyOrder(
+        #ifdef STATS_NEEDED
+        AvgCalc<size_t>* watchListSizeTraversed
+        #endif
+    );
+    template<bool update_stats, bool do_lhbr, bool update_glues, bool chrono>
     PropBy propagateBinFirst(
         #ifdef STATS_NEEDED
-        AvgCalc<size_t>* watchListSizeTraversed = NULL
+        AvgCalc<size_t>* watchListSizeTraversed
         #endif
     );
     PropBy propagateIrredBin();  ///<For debug purposes, to test binary clause removal
+    template<bool update_stats>
     PropResult prop_normal_helper(
         Clause& c
         , ClOffset offset
@@ -230,7 +256,11 @@ protected:
         return mem;
     }
 
+    ///Moves a redundant clause to a better tier if its glue allows
+    void promote_red_tier(ClauseStats& stats) const;
+
 private:
+    template<bool update_stats, bool chrono>
     bool propBinaryClause(
         watch_subarray_const::const_iterator i
         , const Lit p
@@ -238,29 +268,37 @@ private:
     ); ///<Propagate 2-long clause
 
     ///Propagate 3-long clause
+    template<bool update_stats, bool do_lhbr, bool chrono>
     PropResult propTriHelperSimple(
         const Lit lit1
         , const Lit lit2
         , const Lit lit3
         , const bool red
     );
+    template<bool update_stats, bool chrono>
     void propTriHelperAnyOrder(
         const Lit lit1
         , const Lit lit2
         , const Lit lit3
-        #ifdef STATS_NEEDED
         , const bool red
-        #endif
     );
     void lazy_hyper_bin_resolve(Lit lit1, Lit lit2);
     bool can_do_lazy_hyper_bin(Lit lit1, Lit lit2, Lit lit3);
     void update_glue(Clause& c);
+    uint32_t implied_level_tri(Lit lit1, Lit lit3) const;
+    bool watch_highest_level_lit(Clause& c, ClOffset offset, uint32_t& level);
 
+    ///Returns the first non-false literal in [k, end), or 'end'
+    Lit* find_new_watch(Lit* k, Lit* end) const;
+    const NonFalseFinder findNonFalse;
+
+    template<bool update_stats, bool do_lhbr, bool chrono>
     PropResult propTriClause (
         watch_subarray_const::const_iterator i
         , const Lit p
         , PropBy& confl
     );
+    template<bool update_stats, bool chrono>
     bool propTriClauseAnyOrder(
         watch_subarray_const::const_iterator i
         , const Lit lit1
@@ -268,12 +306,14 @@ private:
     );
 
     ///Propagate >3-long clause
+    template<bool update_stats, bool do_lhbr, bool update_glues, bool chrono>
     PropResult propNormalClause(
         watch_subarray_const::const_iterator i
         , watch_subarray::iterator &j
         , const Lit p
         , PropBy& confl
     );
+    template<bool update_stats, bool update_glues, bool chrono>
     bool propNormalClauseAnyOrder(
         watch_subarray_const::const_iterator i
         , watch_subarray::iterator &j
@@ -290,6 +330,18 @@ private:
 ///////////////////////////////////////
 // Implementation of inline methods:
 
+inline Lit* PropEngine::find_new_watch(Lit* k, Lit* const end) const
+{
+    //The new watch is very often among the first few literals, only go
+    //through the function pointer if it is not
+    for(Lit* const stop = std::min(end, k + 4); k != stop; k++) {
+        if (value(*k) != l_False)
+            return k;
+    }
+
+    return findNonFalse(k, end, assigns.data());
+}
+
 inline void PropEngine::newDecisionLevel()
 {
     trail_lim.push_back(trail.size());
@@ -319,6 +371,18 @@ and does some logging if logging is enabled
 @p from Why was it propagated (binary clause, tertiary clause, normal clause)
 */
 inline void PropEngine::enqueue(const Lit p, const PropBy from)
+{
+    enqueue(p, decisionLevel(), from);
+}
+
+/**
+@brief Same as above, but the fact is put at the given level
+
+With chronological backtracking, facts can be implied at a level lower than
+the current one. They then sit on the trail out of order, and
+Searcher::cancelUntil() keeps them when backtracking above their level.
+*/
+inline void PropEngine::enqueue(const Lit p, const uint32_t level, const PropBy from)
 {
     #ifdef DEBUG_ENQUEUE_LEVEL0
     #ifndef VERBOSE_DEBUG
@@ -347,8 +411,8 @@ inline void PropEngine::enqueue(const Lit p, const PropBy from)
     varData[v].stats.trailLevelHist.push(trail.size());
     varData[v].stats.decLevelHist.push(decisionLevel());
     #endif
-    varData[v].reason = from;
-    varData[v].level = decisionLevel();
+    varReason[v] = from;
+    varLevel[v] = level;
 
     trail.push_back(p);
     propStats.propagations++;
@@ -434,7 +498,7 @@ uint32_t PropEngine::calcGlue(const T& ps)
     typename T::const_iterator l, end;
 
     for(l = ps.begin(), end = ps.end(); l != end; l++) {
-        uint32_t lev = varData[l->var()].level;
+        uint32_t lev = varLevel[l->var()];
         if (!seen2[lev]) {
             nbLevels++;
             seen2[lev] = 1;
@@ -442,7 +506,7 @@ uint32_t PropEngine::calcGlue(const T& ps)
     }
 
     for(l = ps.begin(), end = ps.end(); l != end; l++) {
-        uint32_t lev = varData[l->var()].level;
+        uint32_t lev = varLevel[l->var()];
         seen2[lev] = 0;
     }
     return nbLevels;
@@ -95,14 +95,13 @@ void SCCFinder::tarjan(const uint32_t vertex)
     ) {
         Lit vertLit = Lit::toLit(vertex);
 
-        vector<LitExtra>* transCache = NULL;
+        const TransCache* transCache = NULL;
 
         if (solver->conf.doCache
             && solver->conf.doExtendedSCC
             && (!solver->drup->enabled() || solver->conf.otfHyperbin)
         ) {
-            transCache = &(solver->implCache[(~vertLit).toInt()].lits);
-            __builtin_prefetch(transCache->data());
+            transCache = &(solver->implCache[(~vertLit).toInt()]);
         }
 
         //Go through the watch
@@ -122,10 +121,10 @@ void SCCFinder::tarjan(const uint32_t vertex)
         }
 
         if (transCache) {
-            for (vector<LitExtra>::iterator
+            for (TransCache::const_iterator
                 it = transCache->begin(), end = transCache->end()
                 ; it != end
-                ; it++
+                ; ++it
             ) {
                 Lit lit = it->getLit();
                 if (lit != ~vertLit) doit(lit, vertex);
@@ -24,11 +24,14 @@
 #include "calcdefpolars.h"
 #include "time_mem.h"
 #include "solver.h"
+#include "membudget.h"
+#include "localsearch.h"
 #include <iomanip>
 #include "sccfinder.h"
 #include "varreplacer.h"
 #include "clausecleaner.h"
 #include "propbyforgraph.h"
+#include "shareddata.h"
 #include <algorithm>
 #include <cstddef>
 
@@ -73,12 +76,17 @@ Searcher::Searcher(const SolverConf& _conf, Solver* _solver) :
 
 Searcher::~Searcher()
 {
+    for(Gaussian* g: gmatrices) {
+        delete g;
+    }
 }
 
 void Searcher::new_var(const bool bva, const Var orig_outer)
 {
     PropEngine::new_var(bva, orig_outer);
     activities.push_back(0);
+    if (vmtf_active)
+        vmtf.new_var(nVars()-1);
     insertVarOrder(nVars()-1);
     assumptionsSet.push_back(false);
 
@@ -134,6 +142,10 @@ void Searcher::renumber_assumptions(const vector<Var>& outerToInter)
 
 /**
 @brief Revert to the state at given level
+
+With chronological backtracking, literals implied at a level at or below the
+target can sit above it on the trail. These are kept, in their original order,
+and are propagated again.
 */
 void Searcher::cancelUntil(uint32_t level)
 {
@@ -147,10 +159,18 @@ void Searcher::cancelUntil(uint32_t level)
 
         //Go through in reverse order, unassign & insert then
         //back to the vars to be branched upon
+        assert(toKeep.empty());
         for (int sublevel = trail.size()-1
             ; sublevel >= (int)trail_lim[level]
             ; sublevel--
         ) {
+            if (conf.doChronoBT
+                && varLevel[trail[sublevel].var()] <= level
+            ) {
+                toKeep.push_back(trail[sublevel]);
+                continue;
+            }
+
             #ifdef VERBOSE_DEBUG
             cout
             << "Canceling lit " << trail[sublevel]
@@ -170,6 +190,19 @@ void Searcher::cancelUntil(uint32_t level)
         qhead = trail_lim[level];
         trail.resize(trail_lim[level]);
         trail_lim.resize(level);
+        for(int i = (int)toKeep.size()-1; i >= 0; i--) {
+            const Lit lit = toKeep[i];
+            trail.push_back(lit);
+
+            //Now a unit, like all other facts at level 0
+            if (level == 0) {
+                varReason[lit.var()] = PropBy();
+                *drup << lit << fin;
+            }
+        }
+        toKeep.clear();
+        gqhead = std::min(gqhead, trail.size());
+        xqhead = std::min(xqhead, trail.size());
     }
 
     #ifdef VERBOSE_DEBUG
@@ -190,7 +223,7 @@ void Searcher::add_lit_to_learnt(
     );
 
     //If var is at level 0, don't do anything with it, just skip
-    if (varData[var].level == 0)
+    if (varLevel[var] == 0)
         return;
 
     //Update our state of going through the conflict
@@ -202,18 +235,18 @@ void Searcher::add_lit_to_learnt(
         seen2[lit.toInt()] = 1;
         tmp_learnt_clause_abst |= abst_var(lit.var());
 
-        if (varData[var].level == decisionLevel()) {
+        if (varLevel[var] == decisionLevel()) {
             pathC++;
 
             //Glucose 2.1
             if (!fromProber
                 && params.rest_type != restart_type_geom
-                && varData[var].reason != PropBy()
-                && varData[var].reason.getType() == clause_t
+                && varReason[var] != PropBy()
+                && varReason[var].getType() == clause_t
             ) {
-                Clause* cl = clAllocator.getPointer(varData[var].reason.getClause());
+                Clause* cl = clAllocator.getPointer(varReason[var].getClause());
                 if (cl->red()) {
-                    lastDecisionLevel.push_back(std::make_pair(lit, cl->stats.glue));
+                    lastDecisionLevel.push_back(std::make_pair(lit, clAllocator.getStats(*cl).glue));
                 }
             }
         }
@@ -236,7 +269,7 @@ void Searcher::recursiveConfClauseMin()
         #ifdef DEBUG_LITREDUNDANT
         cout << "Calling litRedundant at i = " << i << endl;
         #endif
-        if (varData[learnt_clause[i].var()].reason.isNULL()
+        if (varReason[learnt_clause[i].var()].isNULL()
             || !litRedundant(learnt_clause[i], abstract_level)
         ) {
             learnt_clause[j++] = learnt_clause[i];
@@ -336,7 +369,7 @@ void Searcher::normalClMinim()
 {
     size_t i,j;
     for (i = j = 1; i < learnt_clause.size(); i++) {
-        const PropBy& reason = varData[learnt_clause[i].var()].reason;
+        const PropBy& reason = get_reason(learnt_clause[i].var());
         size_t size;
         Clause* cl = NULL;
         PropByType type = reason.getType();
@@ -385,13 +418,15 @@ void Searcher::normalClMinim()
                     }
                     break;
 
+                //XOR reasons are made into clauses by get_reason()
+                case xor_t:
                 case null_clause_t:
                     release_assert(false);
                     std::exit(-1);
                     break;
             }
 
-            if (!seen[p.var()] && varData[p.var()].level > 0) {
+            if (!seen[p.var()] && varLevel[p.var()] > 0) {
                 learnt_clause[j++] = learnt_clause[i];
                 break;
             }
@@ -423,6 +458,7 @@ void Searcher::debug_print_resolving_clause(const PropBy confl) const
             break;
         }
 
+        case xor_t:
         case null_clause_t: {
             assert(false);
             break;
@@ -471,9 +507,10 @@ Clause* Searcher::add_literals_from_confl_to_learnt(
                 resolutions.irredL++;
                 stats.resolvs.irredL++;
             }
-            cl->stats.used_for_uip_creation++;
+            clAllocator.getStats(*cl).used_for_uip_creation++;
             if (cl->red() && !fromProber) {
                 bumpClauseAct(cl);
+                clAllocator.getStats(*cl).last_touched = sumConflicts();
             }
 
             for (size_t j = 0; j < cl->size(); j++) {
@@ -544,7 +581,7 @@ void Searcher::print_fully_minimized_learnt_clause() const
     if (conf.verbosity >= 6) {
         cout << "Final clause: " << learnt_clause << endl;
         for (uint32_t i = 0; i < learnt_clause.size(); i++) {
-            cout << "lev learnt_clause[" << i << "]:" << varData[learnt_clause[i].var()].level << endl;
+            cout << "lev learnt_clause[" << i << "]:" << varLevel[learnt_clause[i].var()] << endl;
         }
     }
 }
@@ -556,10 +593,10 @@ size_t Searcher::find_backtrack_level_of_learnt()
     else {
         uint32_t max_i = 1;
         for (uint32_t i = 2; i < learnt_clause.size(); i++)
-            if (varData[learnt_clause[i].var()].level > varData[learnt_clause[max_i].var()].level)
+            if (varLevel[learnt_clause[i].var()] > varLevel[learnt_clause[max_i].var()])
                 max_i = i;
         std::swap(learnt_clause[max_i], learnt_clause[1]);
-        return varData[learnt_clause[1].var()].level;
+        return varLevel[learnt_clause[1].var()];
     }
 }
 
@@ -589,13 +626,24 @@ Clause* Searcher::create_learnt_clause(PropBy confl, bool fromProber)
 
         last_resolved_long_cl = add_literals_from_confl_to_learnt(confl, p, fromProber);
 
-        // Select next implication to look at
-        while (!seen[trail[index--].var()]);
+        // Select next implication to look at. Lower level literals can be
+        // interleaved with this level's when backtracking chronologically
+        while (!seen[trail[index].var()]
+            || varLevel[trail[index].var()] != decisionLevel()
+        ) {
+            index--;
+        }
+        index--;
 
         p = trail[index+1];
 
         if (!fromProber
             && conf.doOTFSubsume
+            //Subsumed clauses are re-attached assuming no lower level lits
+            //are above the current level
+            && !conf.doChronoBT
+            //Reasons made from XORs are not in the clause lists
+            && !uses_xor_reasons()
             //A long clause
             && last_resolved_long_cl != NULL
             //Must subsume, so must be smaller
@@ -607,7 +655,7 @@ Clause* Searcher::create_learnt_clause(PropBy confl, bool fromProber)
             check_otf_subsume(confl);
         }
 
-        confl = varData[p.var()].reason;
+        confl = get_reason(p.var());
 
         //This clears out vars that haven't been added to learnt_clause,
         //but their 'seen' has been set
@@ -644,6 +692,8 @@ Clause* Searcher::otf_subsume_last_resolved_clause(Clause* last_resolved_long_cl
     //furthermore, we cannot subsume a clause that is marked for deletion
     //due to its high glue value
     if (!conf.doOTFSubsume
+        || conf.doChronoBT
+        || uses_xor_reasons()
         //Last was a lont clause
         || last_resolved_long_cl == NULL
         //Final clause will not be implicit
@@ -728,7 +778,7 @@ bool Searcher::litRedundant(const Lit p, uint32_t abstract_levels)
         cout << "At point in litRedundant: " << analyze_stack.top() << endl;
         #endif
 
-        const PropBy reason = varData[analyze_stack.top().var()].reason;
+        const PropBy reason = get_reason(analyze_stack.top().var());
         PropByType type = reason.getType();
         analyze_stack.pop();
 
@@ -789,8 +839,8 @@ bool Searcher::litRedundant(const Lit p, uint32_t abstract_levels)
             }
             stats.recMinimCost++;
 
-            if (!seen[p.var()] && varData[p.var()].level > 0) {
-                if (!varData[p.var()].reason.isNULL()
+            if (!seen[p.var()] && varLevel[p.var()] > 0) {
+                if (!varReason[p.var()].isNULL()
                     && (abstractLevel(p.var()) & abstract_levels) != 0
                 ) {
                     seen[p.var()] = 1;
@@ -844,8 +894,8 @@ void Searcher::analyzeFinal(const Lit p, vector<Lit>& out_conflict)
 
     for (int32_t i = (int32_t)trail.size()-1; i >= (int32_t)trail_lim[0]; i--) {
         const Var x = trail[i].var();
-        if (varData[x].reason.isNULL()) {
-            assert(varData[x].level > 0);
+        if (varReason[x].isNULL()) {
+            assert(varLevel[x] > 0);
             out_conflict.push_back(~trail[i]);
         }
     }
@@ -898,13 +948,13 @@ void Searcher::hyper_bin_update_cache(vector<Lit>& to_enqueue_toplevel)
     ) {
         for (int64_t c = trail.size()-1; c > (int64_t)trail_lim[0]; c--) {
             const Lit thisLit = trail[c];
-            const Lit ancestor = varData[thisLit.var()].reason.getAncestor();
+            const Lit ancestor = varReason[thisLit.var()].getAncestor();
             assert(thisLit != trail[trail_lim[0]]);
-            const bool redStep = varData[thisLit.var()].reason.isRedStep();
+            const bool redStep = varReason[thisLit.var()].isRedStep();
 
             assert(ancestor != lit_Undef);
             bool taut = solver->implCache[(~ancestor).toInt()].merge(
-                solver->implCache[(~thisLit).toInt()].lits
+                solver->implCache[(~thisLit).toInt()]
                 , thisLit
                 , redStep
                 , ancestor.var()
@@ -999,11 +1049,18 @@ lbool Searcher::search()
     cout << "c started Searcher::search()" << endl;
     #endif //VERBOSE_DEBUG
 
-    assert(solver->qhead == solver->trail.size());
-
     //Loop until restart or finish (SAT/UNSAT)
     last_decision_ended_in_conflict = false;
     PropBy confl;
+
+    //Facts kept by chronological backtracking may not be propagated yet
+    if (qhead < trail.size()) {
+        confl = propagate(
+            #ifdef STATS_NEEDED
+            &hist.watchListSizeTraversed
+            #endif
+        );
+    }
     while (
         (!params.needToStopSearch
             && sumConflicts() <= solver->getNextCleanLimit()
@@ -1031,7 +1088,7 @@ lbool Searcher::search()
         }
 
         again:
-        if (conf.otfHyperbin && decisionLevel() == 1) {
+        if (otf_hyperbin_at_first_level()) {
             bool must_continue;
             lbool ret = otf_hyper_prop_first_dec_level(must_continue);
             if (ret != l_Undef)
@@ -1049,12 +1106,104 @@ lbool Searcher::search()
         }
     }
 
-    cancelUntil(0);
-    assert(solver->qhead == solver->trail.size());
+    if (!restart())
+        return l_False;
 
     return l_Undef;
 }
 
+/**
+@brief Backtracks at the end of search()
+
+The levels whose decisions would be picked again, in the same order, are kept
+so that their propagations need not be redone. The maintenance between
+searches needs the trail rolled back fully, so if any is due, everything is
+undone.
+
+@returns FALSE if the problem is UNSAT
+*/
+bool Searcher::restart()
+{
+    uint32_t level = 0;
+    if (conf.doReuseTrail
+        && params.rest_type != restart_type_never
+        && !needToInterrupt
+        && !maintenance_due()
+    ) {
+        level = find_reuse_trail_level();
+    }
+    cancelUntil(level);
+    free_unused_xor_reasons();
+
+    if (level > 0) {
+        stats.trailReused++;
+        stats.trailReusedLits += trail.size() - trail_lim[0];
+        return true;
+    }
+
+    //Chronological backtracking may have kept facts that the maintenance
+    //needs propagated
+    return propagate().isNULL();
+}
+
+/**
+@brief Finds the highest level whose decisions would all be made again
+
+After a full restart the most active unassigned variable is decided first.
+Every level whose decision variable is more active than it would be rebuilt
+the same way. With the VMTF queue, the same holds for decision variables that
+were bumped more recently.
+*/
+uint32_t Searcher::find_reuse_trail_level()
+{
+    if (vmtf_active) {
+        const Var next = next_vmtf_var();
+        if (next == var_Undef)
+            return 0;
+
+        const uint64_t next_bumped = vmtf.bumped(next);
+        uint32_t level = std::min<uint32_t>(assumptions.size(), decisionLevel());
+        while (level < decisionLevel()
+            && vmtf.bumped(trail[trail_lim[level]].var()) > next_bumped
+        ) {
+            level++;
+        }
+
+        return level;
+    }
+
+    //Assigned variables are only taken off the heap lazily
+    while (!order_heap.empty()
+        && (value(order_heap[0]) != l_Undef
+            || !varData[order_heap[0]].is_decision)
+    ) {
+        order_heap.removeMin();
+    }
+    if (order_heap.empty())
+        return 0;
+
+    const uint32_t next_act = activities[order_heap[0]];
+
+    //Assumptions are always decided the same way
+    uint32_t level = std::min<uint32_t>(assumptions.size(), decisionLevel());
+    while (level < decisionLevel()
+        && activities[trail[trail_lim[level]].var()] > next_act
+    ) {
+        level++;
+    }
+
+    return level;
+}
+
+bool Searcher::maintenance_due() const
+{
+    return sumConflicts() > solver->getNextCleanLimit()
+        || solver->memBudget->clauses_over(sumConflicts())
+        || clean_clauses_due()
+        || scc_due()
+        || local_search_due();
+}
+
 /**
 @brief Picks a new decision variable to branch on
 
@@ -1194,6 +1343,11 @@ void Searcher::checkNeedRestart()
         cout << endl;
     }
 
+    //Clauses must be cleaned now to stay within the memory budget
+    if (solver->memBudget->clauses_over(sumConflicts())) {
+        params.needToStopSearch = true;
+    }
+
     //Conflict limit reached?
     if (params.conflictsDoneThisRestart > params.conflictsToDo) {
         if (conf.verbosity >= 3)
@@ -1210,7 +1364,7 @@ void Searcher::add_otf_subsume_long_clauses()
     for(size_t i = 0; i < otf_subsuming_long_cls.size(); i++) {
         const ClOffset offset = otf_subsuming_long_cls[i];
         Clause& cl = *solver->clAllocator.getPointer(offset);
-        cl.stats.conflicts_made += conf.rewardShortenedClauseWithConfl;
+        clAllocator.getStats(cl).conflicts_made += conf.rewardShortenedClauseWithConfl;
 
         //Find the l_Undef
         size_t at = std::numeric_limits<size_t>::max();
@@ -1394,14 +1548,17 @@ void Searcher::update_history_stats(size_t backtrack_level, size_t glue)
     #endif
 }
 
-void Searcher::attach_and_enqueue_learnt_clause(Clause* cl)
+void Searcher::attach_and_enqueue_learnt_clause(Clause* cl, const uint32_t level)
 {
+    const bool hyperbin_level = otf_hyperbin_at_first_level();
+
     switch (learnt_clause.size()) {
         case 0:
             assert(false);
         case 1:
             //Unitary learnt
             stats.learntUnits++;
+            assert(level == 0);
             enqueue(learnt_clause[0]);
             assert(decisionLevel() == 0);
 
@@ -1414,10 +1571,10 @@ void Searcher::attach_and_enqueue_learnt_clause(Clause* cl)
             //Binary learnt
             stats.learntBins++;
             solver->attachBinClause(learnt_clause[0], learnt_clause[1], true);
-            if (conf.otfHyperbin && decisionLevel() == 1)
+            if (hyperbin_level)
                 enqueueComplex(learnt_clause[0], ~learnt_clause[1], true);
             else
-                enqueue(learnt_clause[0], PropBy(learnt_clause[1]));
+                enqueue(learnt_clause[0], level, PropBy(learnt_clause[1]));
 
             #ifdef STATS_NEEDED
             propStats.propsBinRed++;
@@ -1430,10 +1587,10 @@ void Searcher::attach_and_enqueue_learnt_clause(Clause* cl)
             std::sort((&learnt_clause[0])+1, (&learnt_clause[0])+3);
             solver->attachTriClause(learnt_clause[0], learnt_clause[1], learnt_clause[2], true);
 
-            if (conf.otfHyperbin && decisionLevel() == 1)
+            if (hyperbin_level)
                 addHyperBin(learnt_clause[0], learnt_clause[1], learnt_clause[2]);
             else
-                enqueue(learnt_clause[0], PropBy(learnt_clause[1], learnt_clause[2]));
+                enqueue(learnt_clause[0], level, PropBy(learnt_clause[1], learnt_clause[2]));
 
             #ifdef STATS_NEEDED
             propStats.propsTriRed++;
@@ -1442,14 +1599,14 @@ void Searcher::attach_and_enqueue_learnt_clause(Clause* cl)
 
         default:
             //Long learnt
-            cl->stats.resolutions = resolutions;
+            clAllocator.getStats(*cl).resolutions = resolutions;
             stats.learntLongs++;
             std::sort(learnt_clause.begin()+1, learnt_clause.end(), PolaritySorter(varData));
             solver->attachClause(*cl);
-            if (conf.otfHyperbin && decisionLevel() == 1)
+            if (hyperbin_level)
                 addHyperBin(learnt_clause[0], *cl);
             else
-                enqueue(learnt_clause[0], PropBy(clAllocator.getOffset(cl)));
+                enqueue(learnt_clause[0], level, PropBy(clAllocator.getOffset(cl)));
 
             #ifdef STATS_NEEDED
             propStats.propsLongRed++;
@@ -1490,8 +1647,9 @@ Clause* Searcher::handle_last_confl_otf_subsumption(
     //No on-the-fly subsumption
     if (cl == NULL) {
         if (learnt_clause.size() > 3) {
-            cl = clAllocator.Clause_new(learnt_clause, Searcher::sumConflicts());
-            cl->makeRed(glue);
+            cl = clAllocator.Clause_new(learnt_clause, Searcher::sumConflicts(), true);
+            clAllocator.getStats(*cl).glue = glue;
+            promote_red_tier(clAllocator.getStats(*cl));
             ClOffset offset = clAllocator.getOffset(cl);
             solver->longRedCls.push_back(offset);
             return cl;
@@ -1521,14 +1679,51 @@ Clause* Searcher::handle_last_confl_otf_subsumption(
     assert(cl->size() == learnt_clause.size());
 
     //Update stats
-    if (cl->red() && cl->stats.glue > glue) {
-        cl->stats.glue = glue;
+    if (cl->red() && clAllocator.getStats(*cl).glue > glue) {
+        clAllocator.getStats(*cl).glue = glue;
+        promote_red_tier(clAllocator.getStats(*cl));
     }
-    cl->stats.conflicts_made += conf.rewardShortenedClauseWithConfl;
+    clAllocator.getStats(*cl).conflicts_made += conf.rewardShortenedClauseWithConfl;
 
     return cl;
 }
 
+/**
+@brief Returns the highest level among the literals of the conflict
+
+Only differs from the current decision level when backtracking
+chronologically
+*/
+uint32_t Searcher::find_conflict_level(const PropBy confl) const
+{
+    uint32_t level = 0;
+    switch (confl.getType()) {
+        case tertiary_t :
+            level = varLevel[confl.lit3().var()];
+            //fall-through
+
+        case binary_t :
+            level = std::max(level, varLevel[confl.lit2().var()]);
+            level = std::max(level, varLevel[failBinLit.var()]);
+            break;
+
+        case clause_t : {
+            const Clause& cl = *clAllocator.getPointer(confl.getClause());
+            for(const Lit lit: cl) {
+                level = std::max(level, varLevel[lit.var()]);
+            }
+            break;
+        }
+
+        case null_clause_t:
+        default:
+            assert(false && "Error in conflict level calculation");
+            break;
+    }
+
+    return level;
+}
+
 bool Searcher::handle_conflict(PropBy confl)
 {
     uint32_t backtrack_level;
@@ -1539,6 +1734,16 @@ bool Searcher::handle_conflict(PropBy confl)
     if (conf.doPrintConflDot)
         create_graphviz_confl_graph(confl);
 
+    //The conflict may be entirely below the current level, analysis must
+    //start from the level it was implied at. The matrices can find such
+    //conflicts, too, after a row changed
+    if (conf.doChronoBT || !gmatrices.empty()) {
+        const uint32_t conflict_level = find_conflict_level(confl);
+        if (conflict_level < decisionLevel()) {
+            cancelUntil(conflict_level);
+        }
+    }
+
     if (decisionLevel() == 0)
         return false;
 
@@ -1554,7 +1759,18 @@ bool Searcher::handle_conflict(PropBy confl)
     if (params.update) {
         update_history_stats(backtrack_level, glue);
     }
-    cancelUntil(backtrack_level);
+
+    //Long jumps are replaced by a single step back, the learnt clause is then
+    //propagated at its real level, below the ones kept
+    if (conf.doChronoBT
+        && learnt_clause.size() > 1
+        && decisionLevel() - backtrack_level >= conf.chronoBTJump
+    ) {
+        stats.chronoBacktracks++;
+        cancelUntil(decisionLevel()-1);
+    } else {
+        cancelUntil(backtrack_level);
+    }
 
     add_otf_subsume_long_clauses();
     add_otf_subsume_implicit_clause();
@@ -1563,10 +1779,16 @@ bool Searcher::handle_conflict(PropBy confl)
     glue = std::min<uint32_t>(glue, std::numeric_limits<uint32_t>::max());
     cl = handle_last_confl_otf_subsumption(cl, glue);
     assert(learnt_clause.size() <= 3 || cl != NULL);
-    attach_and_enqueue_learnt_clause(cl);
+    attach_and_enqueue_learnt_clause(cl, backtrack_level);
+    if (shared_data) {
+        export_learnt_clause(glue);
+    }
 
+    if (vmtf_active)
+        bump_vmtf();
     varDecayActivity();
     decayClauseAct();
+    free_unused_xor_reasons();
 
     return true;
 }
@@ -2023,9 +2245,80 @@ void Searcher::setup_restart_print()
     }
 }
 
+bool Searcher::vmtf_for_this_round() const
+{
+    switch(conf.branchStrategy) {
+        case branch_vsids:
+            return false;
+
+        case branch_vmtf:
+            return true;
+
+        case branch_alternate:
+            return num_search_called % 2 == 0;
+    }
+
+    assert(false);
+    return false;
+}
+
+/**
+@brief Fills the VMTF queue from the activities
+
+The most active variables go to the front, so whatever the heap learnt is
+kept when switching to the queue.
+*/
+void Searcher::restore_vmtf()
+{
+    vector<Var> order(nVars());
+    for(size_t var = 0; var < nVars(); var++) {
+        order[var] = var;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](const Var a, const Var b) {
+        return activities[a] < activities[b];
+    });
+    vmtf.build(order);
+    vmtf_bumped.clear();
+}
+
+/**
+@brief Moves the variables bumped during conflict analysis to the front
+
+They are moved in the order they were in the queue, so they keep their order
+relative to each other.
+*/
+void Searcher::bump_vmtf()
+{
+    std::sort(vmtf_bumped.begin(), vmtf_bumped.end(), [&](const Var a, const Var b) {
+        return vmtf.bumped(a) < vmtf.bumped(b);
+    });
+
+    for(size_t i = 0; i < vmtf_bumped.size(); i++) {
+        const Var var = vmtf_bumped[i];
+        if (i > 0 && vmtf_bumped[i-1] == var)
+            continue;
+
+        vmtf.bump(var, value(var) == l_Undef);
+    }
+    vmtf_bumped.clear();
+}
+
+Var Searcher::next_vmtf_var()
+{
+    return vmtf.next([&](const Var var) {
+        return value(var) != l_Undef || !varData[var].is_decision;
+    });
+}
+
 void Searcher::restore_order_heap()
 {
     order_heap.clear();
+    if (vmtf_active) {
+        restore_vmtf();
+        return;
+    }
+    vmtf.clear();
+
     for(size_t var = 0; var < nVars(); var++) {
         if (solver->varData[var].is_decision
             && value(var) == l_Undef
@@ -2042,7 +2335,8 @@ void Searcher::restore_order_heap()
 void Searcher::reduce_db_if_needed()
 {
     //Check if we should do DBcleaning
-    if (sumConflicts() > solver->getNextCleanLimit()) {
+    const bool scheduled = sumConflicts() > solver->getNextCleanLimit();
+    if (scheduled || solver->memBudget->clauses_over(sumConflicts())) {
         if (conf.verbosity >= 3) {
             cout
             << "c "
@@ -2053,7 +2347,7 @@ void Searcher::reduce_db_if_needed()
             << " maxConfls:" << max_conflicts
             << " Trail size: " << trail.size() << endl;
         }
-        solver->reduce_db_and_update_reset_stats();
+        solver->reduce_db_and_update_reset_stats(scheduled, scheduled);
 
         genRandomVarActMultDiv();
 
@@ -2066,10 +2360,16 @@ void Searcher::reduce_db_if_needed()
     }
 }
 
+bool Searcher::clean_clauses_due() const
+{
+    const size_t newZeroDepthAss = getNumUnitaries() - lastCleanZeroDepthAssigns;
+    return newZeroDepthAss > ((double)solver->getNumFreeVars()*0.005);
+}
+
 void Searcher::clean_clauses_if_needed()
 {
-    const size_t newZeroDepthAss = trail.size() - lastCleanZeroDepthAssigns;
-    if (newZeroDepthAss > ((double)solver->getNumFreeVars()*0.005))  {
+    if (clean_clauses_due()) {
+        const size_t newZeroDepthAss = trail.size() - lastCleanZeroDepthAssigns;
         if (conf.verbosity >= 2) {
             cout << "c newZeroDepthAss : " << newZeroDepthAss  << endl;
         }
@@ -2079,12 +2379,28 @@ void Searcher::clean_clauses_if_needed()
     }
 }
 
+bool Searcher::scc_due() const
+{
+    return conf.doFindAndReplaceEqLits
+        && (solver->binTri.numNewBinsSinceSCC
+            > ((double)solver->getNumFreeVars()*conf.sccFindPercent));
+}
+
+/**
+@brief Local search is run before every conf.localSearchEvery-th restart
+
+It only helps if the decisions follow the saved polarities.
+*/
+bool Searcher::local_search_due() const
+{
+    return conf.doLocalSearch
+        && conf.polarity_mode == polarmode_automatic
+        && (loop_num+1) % conf.localSearchEvery == 0;
+}
+
 lbool Searcher::perform_scc_and_varreplace_if_needed()
 {
-    if (conf.doFindAndReplaceEqLits
-            && (solver->binTri.numNewBinsSinceSCC
-                > ((double)solver->getNumFreeVars()*conf.sccFindPercent))
-    ) {
+    if (scc_due()) {
         if (conf.verbosity >= 1) {
             cout
             << "c new bins since last SCC: "
@@ -2110,12 +2426,362 @@ lbool Searcher::perform_scc_and_varreplace_if_needed()
             if (!solver->varReplacer->performReplace()) {
                 return l_False;
             }
+
+            //The XORs may have replaced variables in them
+            if (uses_xor_reasons() && !init_xors()) {
+                return l_False;
+            }
         }
     }
 
     return l_Undef;
 }
 
+/**
+@brief Sets up the native XORs and the Gauss-Jordan matrices, at decision level 0
+
+@returns FALSE if the XORs, or the facts they imply, make the problem UNSAT
+*/
+bool Searcher::init_xors()
+{
+    assert(decisionLevel() == 0);
+    free_xors();
+    if (!init_native_xors()
+        || !init_gauss()
+    ) {
+        ok = false;
+        return false;
+    }
+
+    //Propagate the facts found from the XORs
+    ok = propagate().isNULL();
+
+    return ok;
+}
+
+void Searcher::free_xors()
+{
+    free_native_xors();
+    free_gauss();
+
+    for(const std::pair<ClOffset, Var>& reason: xor_reasons) {
+        clAllocator.clauseFree(reason.first);
+    }
+    xor_reasons.clear();
+}
+
+/**
+@brief Turns a clause implied by an XOR into the reason of its first literal
+
+Binary and tertiary reasons need no clause. Longer ones get a temporary
+redundant clause that is not attached, see free_unused_xor_reasons()
+*/
+PropBy Searcher::make_xor_reason(const vector<Lit>& cl)
+{
+    switch(cl.size()) {
+        case 2:
+            return PropBy(cl[1]);
+
+        case 3:
+            return PropBy(cl[1], cl[2]);
+
+        default: {
+            Clause* c = clAllocator.Clause_new(cl, sumConflicts(), true);
+            const ClOffset offset = clAllocator.getOffset(c);
+            xor_reasons.push_back(std::make_pair(offset, cl[0].var()));
+            return PropBy(offset);
+        }
+    }
+}
+
+///Same as make_xor_reason(), but all literals of the clause are false
+PropBy Searcher::make_xor_conflict(const vector<Lit>& cl)
+{
+    switch(cl.size()) {
+        case 2:
+            lastConflictCausedBy = ConflCausedBy::binirred;
+            failBinLit = cl[0];
+            return PropBy(cl[1]);
+
+        case 3:
+            lastConflictCausedBy = ConflCausedBy::triirred;
+            failBinLit = cl[0];
+            return PropBy(cl[1], cl[2]);
+
+        default: {
+            lastConflictCausedBy = ConflCausedBy::longirred;
+            Clause* c = clAllocator.Clause_new(cl, sumConflicts(), true);
+            const ClOffset offset = clAllocator.getOffset(c);
+            xor_reasons.push_back(std::make_pair(offset, var_Undef));
+            return PropBy(offset);
+        }
+    }
+}
+
+///Frees the clauses made from XORs that are no longer the reason of their variable
+void Searcher::free_unused_xor_reasons()
+{
+    size_t j = 0;
+    for(const std::pair<ClOffset, Var>& reason: xor_reasons) {
+        const Var var = reason.second;
+        if (var != var_Undef
+            && value(var) != l_Undef
+            && varReason[var].isClause()
+            && varReason[var].getClause() == reason.first
+        ) {
+            xor_reasons[j++] = reason;
+            continue;
+        }
+
+        clAllocator.clauseFree(reason.first);
+    }
+    xor_reasons.resize(j);
+}
+
+/**
+@brief Copies the XORs that are not in the clause database, and watches them
+
+They are cleaned against the current state by the Solver. XORs that became
+units are enqueued here.
+
+@returns FALSE if the native XORs are UNSAT
+*/
+bool Searcher::init_native_xors()
+{
+    if (solver->numNativeXors == 0)
+        return true;
+
+    const double myTime = cpuTime();
+    if (!solver->get_native_xors(nativeXors))
+        return false;
+
+    xwatches.resize(nVars());
+    xqhead = trail.size();
+    size_t numLits = 0;
+    for(uint32_t at = nativeXors.begin()
+        ; at != nativeXors.end()
+        ; at = nativeXors.next(at)
+    ) {
+        const Var* vars = nativeXors.vars(at);
+        numLits += nativeXors.size(at);
+        if (nativeXors.size(at) == 1) {
+            const Lit unit = Lit(vars[0], !nativeXors.rhs(at));
+            if (value(unit) == l_False)
+                return false;
+
+            if (value(unit) == l_Undef)
+                enqueue(unit);
+
+            continue;
+        }
+
+        xwatches[vars[0]].push_back(at);
+        xwatches[vars[1]].push_back(at);
+    }
+
+    if (conf.verbosity >= 2) {
+        cout
+        << "c [xor] native XORs: " << nativeXors.num_xors()
+        << " lits: " << numLits
+        << " T: " << std::fixed << std::setprecision(2) << (cpuTime() - myTime)
+        << endl;
+    }
+
+    return true;
+}
+
+void Searcher::free_native_xors()
+{
+    nativeXors.clear();
+    for(vector<uint32_t>& ws: xwatches) {
+        ws.clear();
+    }
+    xqhead = 0;
+}
+
+/**
+@brief Propagates the native XORs on the assignments made since the last call
+
+The first two variables of an XOR are watched. Once only one of them is left
+unassigned, it is implied. Its reason is made lazily, see get_reason()
+*/
+PropBy Searcher::xor_propagate()
+{
+    PropBy confl;
+    if (nativeXors.empty())
+        return confl;
+
+    for(; xqhead < trail.size(); xqhead++) {
+        const Var var = trail[xqhead].var();
+        vector<uint32_t>& ws = xwatches[var];
+        size_t j = 0;
+        for(size_t i = 0; i < ws.size(); i++) {
+            const uint32_t at = ws[i];
+            if (!confl.isNULL()) {
+                ws[j++] = at;
+                continue;
+            }
+
+            Var* vars = nativeXors.vars(at);
+            const uint32_t size = nativeXors.size(at);
+            if (vars[0] == var) {
+                std::swap(vars[0], vars[1]);
+            }
+            assert(vars[1] == var);
+
+            //Look for a new variable to watch
+            uint32_t k = 2;
+            for(; k < size; k++) {
+                if (value(vars[k]) == l_Undef) {
+                    std::swap(vars[1], vars[k]);
+                    xwatches[vars[1]].push_back(at);
+                    break;
+                }
+            }
+            if (k < size)
+                continue;
+
+            //All but the other watched variable are set
+            ws[j++] = at;
+            bool parity = nativeXors.rhs(at);
+            for(k = 1; k < size; k++) {
+                parity ^= value(vars[k]) == l_True;
+            }
+
+            if (value(vars[0]) == l_Undef) {
+                stats.xorProps++;
+                enqueue(
+                    Lit(vars[0], !parity)
+                    , decisionLevel() == 0 ? PropBy() : PropBy::xor_reason(at)
+                );
+            } else if ((value(vars[0]) == l_True) != parity) {
+                stats.xorConfls++;
+                tmp_xor_clause.clear();
+                for(k = 0; k < size; k++) {
+                    tmp_xor_clause.push_back(Lit(vars[k], value(vars[k]) == l_True));
+                }
+                confl = make_xor_conflict(tmp_xor_clause);
+            }
+        }
+        ws.erase(ws.begin() + j, ws.end());
+
+        if (!confl.isNULL())
+            return confl;
+    }
+
+    return confl;
+}
+
+///Makes the clause of a native XOR that implied the variable, and sets it as the reason
+void Searcher::make_lazy_xor_reason(const Var var)
+{
+    const uint32_t at = varReason[var].getXor();
+    const Var* vars = nativeXors.vars(at);
+    tmp_xor_clause.clear();
+    tmp_xor_clause.push_back(Lit(var, value(var) == l_False));
+    for(uint32_t k = 0; k < nativeXors.size(at); k++) {
+        if (vars[k] != var) {
+            tmp_xor_clause.push_back(Lit(vars[k], value(vars[k]) == l_True));
+        }
+    }
+
+    stats.xorReasonsMade++;
+    varReason[var] = make_xor_reason(tmp_xor_clause);
+}
+
+/**
+@brief Sets up the Gauss-Jordan matrices from the XORs, at decision level 0
+
+Every block of XORs that share variables gets its own matrix, if it is
+neither too small nor too large.
+
+@returns FALSE if the XORs, or the facts they imply, make the problem UNSAT
+*/
+bool Searcher::init_gauss()
+{
+    if (!conf.doGauss
+        //The reasons of the matrices are not in the proof
+        || drup->enabled()
+        //Facts kept below their level would be out of order for the matrices
+        || conf.doChronoBT
+    ) {
+        return true;
+    }
+
+    vector<Xor> xors;
+    if (!solver->get_xors_for_gauss(xors))
+        return false;
+
+    if (xors.empty())
+        return true;
+
+    gwatches.resize(nVars());
+    gqhead = trail.size();
+    for(const vector<Xor>& block: Gaussian::cut_into_blocks(xors, nVars())) {
+        if (block.size() < conf.gaussMinMatrixRows
+            || block.size() > conf.gaussMaxMatrixRows
+            || gmatrices.size() >= conf.gaussMaxMatrixes
+        ) {
+            continue;
+        }
+
+        Gaussian* g = new Gaussian(solver, block, gmatrices.size());
+        gmatrices.push_back(g);
+        if (!g->init())
+            return false;
+    }
+
+    return true;
+}
+
+void Searcher::free_gauss()
+{
+    for(Gaussian* g: gmatrices) {
+        gaussStats += g->getStats();
+        delete g;
+    }
+    gmatrices.clear();
+    for(vector<GaussWatched>& ws: gwatches) {
+        ws.clear();
+    }
+    gqhead = 0;
+}
+
+///Lets the matrices see the assignments made since the last call
+PropBy Searcher::gauss_propagate()
+{
+    PropBy confl;
+    if (gmatrices.empty())
+        return confl;
+
+    for(Gaussian* g: gmatrices) {
+        if (!g->recheck(confl))
+            return confl;
+    }
+
+    for(; gqhead < trail.size(); gqhead++) {
+        const Var var = trail[gqhead].var();
+
+        //The rows can add watches to this very list, so no iterators
+        vector<GaussWatched>& ws = gwatches[var];
+        size_t j = 0;
+        for(size_t i = 0; i < ws.size(); i++) {
+            const GaussWatched w = ws[i];
+            if (!confl.isNULL()
+                || gmatrices[w.matrix]->find_truths(w.row, var, confl)
+            ) {
+                ws[j++] = w;
+            }
+        }
+        ws.erase(ws.begin() + j, ws.end());
+
+        if (!confl.isNULL())
+            return confl;
+    }
+
+    return confl;
+}
+
 void Searcher::save_search_loop_stats()
 {
     #ifdef STATS_NEEDED
@@ -2192,10 +2858,21 @@ lbool Searcher::solve(const uint64_t _maxConfls)
     }
 
     resetStats();
+    lbool status = l_Undef;
+    if (!init_xors()) {
+        status = l_False;
+        goto end;
+    }
+    vmtf_active = vmtf_for_this_round();
+    if (conf.verbosity >= 2) {
+        cout
+        << "c [branch] picking with "
+        << (vmtf_active ? "VMTF queue" : "VSIDS heap")
+        << endl;
+    }
     restore_activities_and_polarities();
     restore_order_heap();
     setup_restart_print();
-    lbool status = l_Undef;
     status = burstSearch();
     if (status != l_Undef)
         goto end;
@@ -2234,11 +2911,27 @@ lbool Searcher::solve(const uint64_t _maxConfls)
         if (status != l_Undef)
             goto end;
 
+        //Shared clauses are only imported at level 0, so after a restart
+        //that kept some levels they wait for the next full one
+        if (shared_data
+            && decisionLevel() == 0
+            && !import_shared_clauses()
+        ) {
+            status = l_False;
+            goto end;
+        }
+
         save_search_loop_stats();
+
+        //Its best assignment becomes the polarities of the next search()
+        if (local_search_due()) {
+            solver->localSearch->run(assumptions);
+        }
     }
 
     end:
     finish_up_solve(status);
+    vmtf_active = false;
     return status;
 }
 
@@ -2248,7 +2941,7 @@ void Searcher::print_solution_varreplace_status() const
         if (varData[var].removed == Removed::replaced
             || varData[var].removed == Removed::elimed
         ) {
-            assert(value(var) == l_Undef || varData[var].level == 0);
+            assert(value(var) == l_Undef || varLevel[var] == 0);
         }
 
         if (conf.verbosity >= 6
@@ -2259,7 +2952,7 @@ void Searcher::print_solution_varreplace_status() const
             cout
             << "var: " << var
             << " value: " << value(var)
-            << " level:" << varData[var].level
+            << " level:" << varLevel[var]
             << " type: " << removed_type_to_string(varData[var].removed)
             << endl;
         }
@@ -2285,7 +2978,7 @@ void Searcher::finish_up_solve(const lbool status)
     print_solution_type(status);
 
     if (status == l_True) {
-        model = assigns;
+        model.assign(assigns.begin(), assigns.end());
         print_solution_varreplace_status();
     } else if (status == l_False) {
         if (conflict.size() == 0)
@@ -2293,6 +2986,15 @@ void Searcher::finish_up_solve(const lbool status)
     }
     cancelUntil(0);
 
+    //Facts kept by chronological backtracking may not be propagated yet
+    if (ok
+        && qhead < trail.size()
+        && !propagate().isNULL()
+    ) {
+        ok = false;
+    }
+    free_xors();
+
     stats.cpu_time = cpuTime() - startTime;
     if (conf.verbosity >= 4) {
         cout << "c Searcher::solve() finished"
@@ -2380,10 +3082,12 @@ Lit Searcher::pickBranchLit()
         frq = conf.random_var_freq_for_top_N;
     }
     if (rand < frq
-        && order_heap.size() > conf.random_picks_from_top_T
+        && (vmtf_active || order_heap.size() > conf.random_picks_from_top_T)
     ) {
-        const Var next_var = order_heap[mtrand.randInt(conf.random_picks_from_top_T)];
-        if (value(next_var) == l_Undef
+        const uint32_t at = mtrand.randInt(conf.random_picks_from_top_T);
+        const Var next_var = vmtf_active ? vmtf.before_next(at) : order_heap[at];
+        if (next_var != var_Undef
+            && value(next_var) == l_Undef
             && solver->varData[next_var].is_decision
         ) {
             stats.decisionsRand++;
@@ -2396,6 +3100,13 @@ Lit Searcher::pickBranchLit()
       || value(next.var()) != l_Undef
       || !solver->varData[next.var()].is_decision
     ) {
+        if (vmtf_active) {
+            const Var next_var = next_vmtf_var();
+            next = (next_var == var_Undef) ? lit_Undef : Lit(next_var, !pickPolarity(next_var));
+            stats.decisionsVMTF += next != lit_Undef;
+            break;
+        }
+
         //There is no more to branch on. Satisfying assignment found.
         if (order_heap.empty()) {
             next = lit_Undef;
@@ -2474,8 +3185,8 @@ void Searcher::cache_based_more_minim(vector<Lit>& cl)
 
         assert(solver->implCache.size() > lit.toInt());
         const TransCache& cache1 = solver->implCache[lit.toInt()];
-        limit -= (int64_t)cache1.lits.size()/2;
-        for (const LitExtra litExtra: cache1.lits) {
+        limit -= (int64_t)cache1.size()/2;
+        for (const LitExtra litExtra: cache1) {
             assert(seen.size() > litExtra.getLit().toInt());
             if (seen[(~(litExtra.getLit())).toInt()]) {
                 stats.cacheShrinkedClause++;
@@ -2613,6 +3324,11 @@ void Searcher::stamp_based_more_minim(vector<Lit>& cl)
 
 void Searcher::insertVarOrder(const Var x)
 {
+    if (vmtf_active) {
+        vmtf.unassigned(x);
+        return;
+    }
+
     if (!order_heap.inHeap(x)
         && solver->varData[x].is_decision
     ) {
@@ -2630,6 +3346,116 @@ void Searcher::setNeedToInterrupt()
     needToInterrupt = true;
 }
 
+void Searcher::unsetNeedToInterrupt()
+{
+    needToInterrupt = false;
+}
+
+void Searcher::set_shared_data(SharedData* _shared_data, const unsigned _thread_num)
+{
+    assert(_shared_data == NULL || _thread_num < _shared_data->num_threads());
+    shared_data = _shared_data;
+    thread_num = _thread_num;
+    shared_read_at.clear();
+    if (shared_data) {
+        shared_read_at.resize(shared_data->num_threads(), 0);
+    }
+}
+
+void Searcher::export_learnt_clause(const uint32_t glue)
+{
+    if (learnt_clause.size() > conf.shareMaxSize
+        && glue > conf.shareMaxGlue
+    ) {
+        return;
+    }
+
+    //Other threads only understand the numbering the user sees
+    shared_lits.clear();
+    for(const Lit lit: learnt_clause) {
+        const Var outer = map_inter_to_outer(lit.var());
+        const Var outside = map_outer_to_without_bva(outer);
+        if (outside == var_Undef)
+            return;
+
+        shared_lits.push_back(Lit(outside, lit.sign()));
+    }
+    shared_data->rings[thread_num]->push(shared_lits);
+    stats.sharedExported++;
+}
+
+bool Searcher::import_shared_clauses()
+{
+    assert(decisionLevel() == 0);
+    assert(ok);
+
+    for(size_t th = 0; th < shared_data->num_threads(); th++) {
+        if (th == thread_num)
+            continue;
+
+        shared_tmp.clear();
+        if (!shared_data->rings[th]->read(shared_read_at[th], shared_tmp)) {
+            stats.sharedLapped++;
+        }
+
+        size_t at = 0;
+        while(at < shared_tmp.size()) {
+            const uint32_t size = shared_tmp[at++];
+            const uint32_t* lits = &shared_tmp[at];
+            at += size;
+
+            shared_lits.clear();
+            bool usable = true;
+            for(uint32_t i = 0; i < size; i++) {
+                const Lit lit = Lit::toLit(lits[i]);
+                if (lit.var() >= nVarsOutside()) {
+                    usable = false;
+                    break;
+                }
+                Lit outer = map_to_with_bva(lit);
+                outer = solver->varReplacer->getLitReplacedWithOuter(outer);
+                const Lit inter = map_outer_to_inter(outer);
+                if (inter.var() >= nVars()
+                    || (varData[inter.var()].removed != Removed::none
+                        && varData[inter.var()].removed != Removed::queued_replacer)
+                ) {
+                    usable = false;
+                    break;
+                }
+                shared_lits.push_back(inter);
+            }
+            if (!usable)
+                continue;
+
+            //Binaries learnt by more than one thread are common
+            if (shared_lits.size() == 2
+                && findWBin(watches, shared_lits[0], shared_lits[1])
+            ) {
+                continue;
+            }
+
+            ClauseStats clStats;
+            clStats.glue = shared_lits.size();
+            promote_red_tier(clStats);
+            shared_added.clear();
+            Clause* cl = solver->addClauseInt(shared_lits, true, clStats, true, &shared_added);
+            if (!solver->ok)
+                return false;
+
+            if (cl) {
+                solver->longRedCls.push_back(solver->clAllocator.getOffset(cl));
+            }
+
+            //Satisfied clauses are dropped before the final literals are set
+            if (!shared_added.empty()) {
+                stats.sharedImported++;
+            }
+        }
+    }
+
+    return true;
+}
+
 void Searcher::printAgilityStats()
 {
     cout
@@ -2765,19 +3591,19 @@ string Searcher::analyze_confl_for_graphviz_graph(
             const Var my_var = q.var();
 
             if (!seen[my_var] //if already handled, don't care
-                && varData[my_var].level > 0 //if it's assigned at level 0, it's assigned FALSE, so leave it out
+                && varLevel[my_var] > 0 //if it's assigned at level 0, it's assigned FALSE, so leave it out
             ) {
                 seen[my_var] = 1;
-                assert(varData[my_var].level <= decisionLevel());
+                assert(varLevel[my_var] <= decisionLevel());
 
-                if (varData[my_var].level == decisionLevel()) {
+                if (varLevel[my_var] == decisionLevel()) {
                     pathC++;
                 } else {
                     learnt_clause.push_back(q);
 
                     //Backtracking level is largest of thosee inside the clause
-                    if (varData[my_var].level > out_btlevel)
-                        out_btlevel = varData[my_var].level;
+                    if (varLevel[my_var] > out_btlevel)
+                        out_btlevel = varLevel[my_var];
                 }
             }
         }
@@ -2787,7 +3613,7 @@ string Searcher::analyze_confl_for_graphviz_graph(
         while (!seen[trail[index--].var()]);
 
         p = trail[index+1];
-        confl = PropByForGraph(varData[p.var()].reason, p, clAllocator);
+        confl = PropByForGraph(varReason[p.var()], p, clAllocator);
         seen[p.var()] = 0; // this one is resolved
         pathC--;
     } while (pathC > 0); //UIP when eveything goes through this one
@@ -2810,12 +3636,12 @@ void Searcher::print_edges_for_graphviz_file(std::ofstream& file) const
         const Lit lit = trail[i];
 
         //0-decision level means it's pretty useless to put into the impl. graph
-        if (varData[lit.var()].level == 0) continue;
+        if (varLevel[lit.var()] == 0) continue;
 
         //Not directly connected with the conflict, drop
         if (!seen[lit.var()]) continue;
 
-        PropBy reason = varData[lit.var()].reason;
+        PropBy reason = varReason[lit.var()];
 
         //A decision variable, it is not propagated by any clause
         if (reason.isNULL()) continue;
@@ -2823,7 +3649,7 @@ void Searcher::print_edges_for_graphviz_file(std::ofstream& file) const
         PropByForGraph prop(reason, lit, clAllocator);
         for (uint32_t i = 0; i < prop.size(); i++) {
             if (prop[i] == lit //This is being propagated, don't make a circular line
-                || varData[prop[i].var()].level == 0 //'clean' clauses of 0-level lits
+                || varLevel[prop[i].var()] == 0 //'clean' clauses of 0-level lits
             ) continue;
 
             file << "x" << prop[i].unsign() << " -> x" << lit.unsign() << " "
@@ -2831,7 +3657,7 @@ void Searcher::print_edges_for_graphviz_file(std::ofstream& file) const
             << " label=\"";
             for(uint32_t i2 = 0; i2 < prop.size();) {
                 //'clean' clauses of 0-level lits
-                if (varData[prop[i2].var()].level == 0) {
+                if (varLevel[prop[i2].var()] == 0) {
                     i2++;
                     continue;
                 }
@@ -2861,7 +3687,7 @@ void Searcher::print_vertex_definitions_for_graphviz_file(std::ofstream& file)
         << " shape=\"box\""
         //<< ", size = 0.8"
         << ", style=\"filled\"";
-        if (varData[lit.var()].reason.isNULL())
+        if (varReason[lit.var()].isNULL())
             file << ", color=\"darkorange2\""; //decision var
         else
             file << ", color=\"darkseagreen4\""; //propagated var
@@ -2869,7 +3695,7 @@ void Searcher::print_vertex_definitions_for_graphviz_file(std::ofstream& file)
         //Print label
         file
         << ", label=\"" << (lit.sign() ? "-" : "") << "x" << lit.unsign()
-        << " @ " << varData[lit.var()].level << "\""
+        << " @ " << varLevel[lit.var()] << "\""
         << " ];" << endl;
     }
 }
@@ -2881,7 +3707,7 @@ void Searcher::fill_seen_for_lits_connected_to_conflict_graph(
     {
         vector<Lit> newLits;
         for (size_t i = 0; i < lits.size(); i++) {
-            PropBy reason = varData[lits[i].var()].reason;
+            PropBy reason = get_reason(lits[i].var());
             //Reason in NULL, so remove: it's got no antedecent
             if (reason.isNULL()) continue;
 
@@ -2895,7 +3721,7 @@ void Searcher::fill_seen_for_lits_connected_to_conflict_graph(
                 assert(value(lit) != l_Undef);
 
                 //Don't put into the impl. graph lits at 0 decision level
-                if (varData[lit.var()].level == 0) continue;
+                if (varLevel[lit.var()] == 0) continue;
 
                 //Already added, just drop
                 if (seen[lit.var()]) continue;
@@ -2997,15 +3823,15 @@ void Searcher::decayClauseAct()
 
 void Searcher::bumpClauseAct(Clause* cl)
 {
-    cl->stats.activity += clauseActivityIncrease;
-    if (cl->stats.activity > 1e20 ) {
+    clAllocator.getStats(*cl).activity += clauseActivityIncrease;
+    if (clAllocator.getStats(*cl).activity > 1e20 ) {
         // Rescale
         for(vector<ClOffset>::iterator
             it = solver->longRedCls.begin(), end = solver->longRedCls.end()
             ; it != end
             ; it++
         ) {
-            clAllocator.getPointer(*it)->stats.activity *= 1e-20;
+            clAllocator.getStats(*clAllocator.getPointer(*it)).activity *= 1e-20;
         }
         clauseActivityIncrease *= 1e-20;
         clauseActivityIncrease = std::max(clauseActivityIncrease, 1.0);
@@ -3019,15 +3845,26 @@ PropBy Searcher::propagate(
 ) {
     const size_t origTrailSize = trail.size();
 
-    PropBy ret;
-    if (conf.propBinFirst) {
-        ret = propagateBinFirst(
+    PropBy ret = (this->*propagate_func)(
+        #ifdef STATS_NEEDED
+        watchListSizeTraversed
+        #endif
+    );
+
+    //Alternate with the XORs until none of them has anything new
+    while (ret.isNULL() && uses_xor_reasons()) {
+        ret = xor_propagate();
+        if (ret.isNULL()) {
+            ret = gauss_propagate();
+        }
+        if (!ret.isNULL() || qhead == trail.size())
+            break;
+
+        ret = (this->*propagate_func)(
             #ifdef STATS_NEEDED
             watchListSizeTraversed
             #endif
         );
-    } else {
-        ret = propagateAnyOrder();
     }
 
     //Drup -- If declevel 0 propagation, we have to add the unitaries
@@ -3059,6 +3896,21 @@ size_t Searcher::memUsed() const
     mem += otf_subsuming_long_cls.capacity()*sizeof(ClOffset);
     mem += activities.capacity()*sizeof(uint32_t);
     mem += order_heap.memUsed();
+    mem += vmtf.memUsed();
+    mem += vmtf_bumped.capacity()*sizeof(Var);
+    for(const Gaussian* g: gmatrices) {
+        mem += g->memUsed();
+    }
+    for(const vector<GaussWatched>& ws: gwatches) {
+        mem += ws.capacity()*sizeof(GaussWatched);
+    }
+    mem += gwatches.capacity()*sizeof(vector<GaussWatched>);
+    mem += xor_reasons.capacity()*sizeof(std::pair<ClOffset, Var>);
+    mem += nativeXors.memUsed();
+    for(const vector<uint32_t>& ws: xwatches) {
+        mem += ws.capacity()*sizeof(uint32_t);
+    }
+    mem += xwatches.capacity()*sizeof(vector<uint32_t>);
     mem += learnt_clause.capacity()*sizeof(Lit);
     mem += hist.memUsed();
     mem += conflict.capacity()*sizeof(Lit);
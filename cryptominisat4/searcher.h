@@ -31,12 +31,17 @@
 
 #include "time_mem.h"
 #include "avgcalc.h"
+#include <atomic>
 #include "hyperengine.h"
+#include "vmtf.h"
+#include "gaussian.h"
+#include "xor.h"
 namespace CMSat {
 
 class Solver;
 class SQLStats;
 class VarReplacer;
+class SharedData;
 
 using std::string;
 using std::cout;
@@ -185,7 +190,10 @@ class Searcher : public HyperEngine
         void setup_restart_print();
         void reduce_db_if_needed();
         void clean_clauses_if_needed();
+        bool clean_clauses_due() const;
         lbool perform_scc_and_varreplace_if_needed();
+        bool scc_due() const;
+        bool local_search_due() const;
         void save_search_loop_stats();
         bool must_abort(lbool status);
         void print_search_loop_num();
@@ -218,17 +226,22 @@ class Searcher : public HyperEngine
         const Hist& getHistory() const;
 
         void     setNeedToInterrupt();
+        void     unsetNeedToInterrupt();
+        void     set_shared_data(SharedData* shared_data, unsigned thread_num);
 
         struct Stats
         {
             Stats() :
                 // Stats
                 numRestarts(0)
+                , trailReused(0)
+                , trailReusedLits(0)
 
                 //Decisions
                 , decisions(0)
                 , decisionsAssump(0)
                 , decisionsRand(0)
+                , decisionsVMTF(0)
                 , decisionFlippedPolar(0)
 
                 //Conflict generation
@@ -258,12 +271,25 @@ class Searcher : public HyperEngine
                 , otfSubsumedRed(0)
                 , otfSubsumedLitsGained(0)
 
+                //Clause sharing
+                , sharedExported(0)
+                , sharedImported(0)
+                , sharedLapped(0)
+
                 //Hyper-bin & transitive reduction
                 , advancedPropCalled(0)
                 , hyperBinAdded(0)
                 , transReduRemIrred(0)
                 , transReduRemRed(0)
 
+                //Chronological backtracking
+                , chronoBacktracks(0)
+
+                //Native XORs
+                , xorProps(0)
+                , xorConfls(0)
+                , xorReasonsMade(0)
+
                 //Time
                 , cpu_time(0)
 
@@ -278,11 +304,14 @@ class Searcher : public HyperEngine
             Stats& operator+=(const Stats& other)
             {
                 numRestarts += other.numRestarts;
+                trailReused += other.trailReused;
+                trailReusedLits += other.trailReusedLits;
 
                 //Decisions
                 decisions += other.decisions;
                 decisionsAssump += other.decisionsAssump;
                 decisionsRand += other.decisionsRand;
+                decisionsVMTF += other.decisionsVMTF;
                 decisionFlippedPolar += other.decisionFlippedPolar;
 
                 //Conflict minimisation stats
@@ -315,12 +344,25 @@ class Searcher : public HyperEngine
                 otfSubsumedRed += other.otfSubsumedRed;
                 otfSubsumedLitsGained += other.otfSubsumedLitsGained;
 
+                //Clause sharing
+                sharedExported += other.sharedExported;
+                sharedImported += other.sharedImported;
+                sharedLapped += other.sharedLapped;
+
                 //Hyper-bin & transitive reduction
                 advancedPropCalled += other.advancedPropCalled;
                 hyperBinAdded += other.hyperBinAdded;
                 transReduRemIrred += other.transReduRemIrred;
                 transReduRemRed += other.transReduRemRed;
 
+                //Chronological backtracking
+                chronoBacktracks += other.chronoBacktracks;
+
+                //Native XORs
+                xorProps += other.xorProps;
+                xorConfls += other.xorConfls;
+                xorReasonsMade += other.xorReasonsMade;
+
                 //Stat structs
                 resolvs += other.resolvs;
                 conflStats += other.conflStats;
@@ -334,11 +376,14 @@ class Searcher : public HyperEngine
             Stats& operator-=(const Stats& other)
             {
                 numRestarts -= other.numRestarts;
+                trailReused -= other.trailReused;
+                trailReusedLits -= other.trailReusedLits;
 
                 //Decisions
                 decisions -= other.decisions;
                 decisionsAssump -= other.decisionsAssump;
                 decisionsRand -= other.decisionsRand;
+                decisionsVMTF -= other.decisionsVMTF;
                 decisionFlippedPolar -= other.decisionFlippedPolar;
 
                 //Conflict minimisation stats
@@ -370,12 +415,25 @@ class Searcher : public HyperEngine
                 otfSubsumedRed -= other.otfSubsumedRed;
                 otfSubsumedLitsGained -= other.otfSubsumedLitsGained;
 
+                //Clause sharing
+                sharedExported -= other.sharedExported;
+                sharedImported -= other.sharedImported;
+                sharedLapped -= other.sharedLapped;
+
                 //Hyper-bin & transitive reduction
                 advancedPropCalled -= other.advancedPropCalled;
                 hyperBinAdded -= other.hyperBinAdded;
                 transReduRemIrred -= other.transReduRemIrred;
                 transReduRemRed -= other.transReduRemRed;
 
+                //Chronological backtracking
+                chronoBacktracks -= other.chronoBacktracks;
+
+                //Native XORs
+                xorProps -= other.xorProps;
+                xorConfls -= other.xorConfls;
+                xorReasonsMade -= other.xorReasonsMade;
+
                 //Stat structs
                 resolvs -= other.resolvs;
                 conflStats -= other.conflStats;
@@ -401,11 +459,25 @@ class Searcher : public HyperEngine
                     , "confls per restart"
 
                 );
+                printStatsLine("c trail reused"
+                    , trailReused
+                    , stats_line_percent(trailReused, numRestarts)
+                    , "% of restarts"
+                );
+                printStatsLine("c trail reuse kept lits"
+                    , trailReusedLits
+                    , trailReused == 0 ? 0 : (double)trailReusedLits/(double)trailReused
+                    , "lits/reuse"
+                );
                 printStatsLine("c time", cpu_time);
                 printStatsLine("c decisions", decisions
                     , stats_line_percent(decisionsRand, decisions)
                     , "% random"
                 );
+                printStatsLine("c decisions by VMTF", decisionsVMTF
+                    , stats_line_percent(decisionsVMTF, decisions)
+                    , "% of decisions"
+                );
 
                 printStatsLine("c decisions/conflicts"
                     , (double)decisions/(double)conflStats.numConflicts
@@ -489,6 +561,21 @@ class Searcher : public HyperEngine
                     , "lits/otf subsume"
                 );
 
+                if (sharedExported || sharedImported) {
+                    cout << "c CLAUSE SHARING stats" << endl;
+                    printStatsLine("c shared exported"
+                        , sharedExported
+                        , stats_line_percent(sharedExported, conflStats.numConflicts)
+                        , "% of conflicts"
+                    );
+                    printStatsLine("c shared imported"
+                        , sharedImported
+                    );
+                    printStatsLine("c shared ring lapped"
+                        , sharedLapped
+                    );
+                }
+
                 cout << "c SEAMLESS HYPERBIN&TRANS-RED stats" << endl;
                 printStatsLine("c advProp called"
                     , advancedPropCalled
@@ -509,6 +596,34 @@ class Searcher : public HyperEngine
                     , "bin/call"
                 );
 
+                if (chronoBacktracks) {
+                    printStatsLine("c chrono backtracks"
+                        , chronoBacktracks
+                        , stats_line_percent(chronoBacktracks, conflStats.numConflicts)
+                        , "% of conflicts"
+                    );
+                }
+
+                if (xorProps || xorConfls) {
+                    printStatsLine("c native XOR props"
+                        , xorProps
+                        , (double)xorProps/(double)conflStats.numConflicts
+                        , "/conflict"
+                    );
+
+                    printStatsLine("c native XOR confls"
+                        , xorConfls
+                        , stats_line_percent(xorConfls, conflStats.numConflicts)
+                        , "% of conflicts"
+                    );
+
+                    printStatsLine("c native XOR reasons made"
+                        , xorReasonsMade
+                        , stats_line_percent(xorReasonsMade, xorProps)
+                        , "% of XOR props"
+                    );
+                }
+
                 cout << "c CONFL LITS stats" << endl;
                 printStatsLine("c orig "
                     , litsRedNonMin
@@ -572,11 +687,14 @@ class Searcher : public HyperEngine
             }
 
             uint64_t  numRestarts;      ///<Num restarts
+            uint64_t  trailReused;      ///<Restarts that kept some decision levels
+            uint64_t  trailReusedLits;  ///<Assignments kept above level 0 by trail reuse
 
             //Decisions
             uint64_t  decisions;        ///<Number of decisions made
             uint64_t  decisionsAssump;
             uint64_t  decisionsRand;    ///<Numer of random decisions made
+            uint64_t  decisionsVMTF;    ///<Decisions taken from the VMTF queue
             uint64_t  decisionFlippedPolar; ///<While deciding, we flipped polarity
 
             uint64_t litsRedNonMin;
@@ -605,12 +723,25 @@ class Searcher : public HyperEngine
             uint64_t otfSubsumedRed;
             uint64_t otfSubsumedLitsGained;
 
+            //Clause sharing
+            uint64_t sharedExported;
+            uint64_t sharedImported;   ///<Shared clauses actually attached or enqueued
+            uint64_t sharedLapped;
+
             //Hyper-bin & transitive reduction
             uint64_t advancedPropCalled;
             uint64_t hyperBinAdded;
             uint64_t transReduRemIrred;
             uint64_t transReduRemRed;
 
+            //Chronological backtracking
+            uint64_t chronoBacktracks;
+
+            //Native XORs
+            uint64_t xorProps;
+            uint64_t xorConfls;
+            uint64_t xorReasonsMade; ///<Clauses made from XORs for conflict analysis
+
             //Resolution Stats
             ResolutionTypes<uint64_t> resolvs;
 
@@ -635,8 +766,38 @@ class Searcher : public HyperEngine
 
         friend class CalcDefPolars;
         friend class VarReplacer;
+        friend class Gaussian;
         void filterOrderHeap();
 
+        //XORs outside the clause database, set up for each solve()
+        bool init_xors();
+        void free_xors();
+        bool uses_xor_reasons() const;
+        vector<std::pair<ClOffset, Var> > xor_reasons; ///<Long reasons and conflicts made from XORs, with the variable they imply
+        PropBy make_xor_reason(const vector<Lit>& cl);
+        PropBy make_xor_conflict(const vector<Lit>& cl);
+        void free_unused_xor_reasons();
+
+        //Native XORs, watched on two variables
+        XorArena nativeXors;
+        vector<vector<uint32_t> > xwatches; ///<Native XORs watching the variable
+        size_t xqhead = 0; ///<Position in the trail up to which the native XORs have seen the assignments
+        vector<Lit> tmp_xor_clause;
+        bool init_native_xors();
+        void free_native_xors();
+        PropBy xor_propagate();
+        const PropBy& get_reason(Var var);
+        void make_lazy_xor_reason(Var var);
+
+        //Gauss-Jordan elimination
+        vector<Gaussian*> gmatrices;
+        vector<vector<GaussWatched> > gwatches; ///<Rows watching the variable
+        size_t gqhead = 0; ///<Position in the trail up to which the matrices have seen the assignments
+        Gaussian::Stats gaussStats;
+        bool init_gauss();
+        void free_gauss();
+        PropBy gauss_propagate();
+
         //For connection with Solver
         void  resetStats();
 
@@ -655,7 +816,18 @@ class Searcher : public HyperEngine
         //Settings
         Solver*   solver;          ///< Thread control class
         MTRand           mtrand;           ///< random number generator
-        bool             needToInterrupt;  ///<If set to TRUE, interrupt cleanly ASAP
+        std::atomic<bool> needToInterrupt;  ///<If set to TRUE, interrupt cleanly ASAP. May be set from another thread
+
+        /////////////////
+        //Clause sharing between threads
+        SharedData* shared_data = NULL;
+        unsigned thread_num = 0;
+        vector<uint64_t> shared_read_at; ///<Position read up to in each thread's ring
+        vector<uint32_t> shared_tmp;
+        vector<Lit> shared_lits;
+        vector<Lit> shared_added; ///<What addClauseInt() made of an imported clause
+        void export_learnt_clause(const uint32_t glue);
+        bool import_shared_clauses();
 
         //Stats printing
         void printAgilityStats();
@@ -668,7 +840,8 @@ class Searcher : public HyperEngine
         lbool burstSearch();
         bool  handle_conflict(PropBy confl);// Handles the conflict clause
         void  update_history_stats(size_t backtrack_level, size_t glue);
-        void  attach_and_enqueue_learnt_clause(Clause* cl);
+        void  attach_and_enqueue_learnt_clause(Clause* cl, uint32_t level);
+        uint32_t find_conflict_level(PropBy confl) const;
         void  print_learning_debug_info() const;
         void  print_learnt_clause() const;
         void  add_otf_subsume_long_clauses();
@@ -676,9 +849,13 @@ class Searcher : public HyperEngine
         Clause* handle_last_confl_otf_subsumption(Clause* cl, const size_t glue);
         lbool new_decision();  // Handles the case when decision must be made
         void  checkNeedRestart();     // Helper function to decide if we need to restart during search
+        bool  restart();
+        uint32_t find_reuse_trail_level();
+        bool  maintenance_due() const;
         Restart decide_restart_type() const;
         Lit   pickBranchLit();
         lbool otf_hyper_prop_first_dec_level(bool& must_continue);
+        bool  otf_hyperbin_at_first_level() const;
         void  hyper_bin_update_cache(vector<Lit>& to_enqueue_toplevel);
 
         ///////////////
@@ -707,6 +884,7 @@ class Searcher : public HyperEngine
         };
         SearchParams params;
         void     cancelUntil      (uint32_t level);                        ///<Backtrack until a certain level.
+        vector<Lit> toKeep; ///<Lower level literals kept by cancelUntil()
         vector<Lit> learnt_clause;
         Clause* analyze_conflict(
             PropBy confl //The conflict that we are investigating
@@ -857,6 +1035,15 @@ class Searcher : public HyperEngine
         ///activity-ordered heap of decision variables
         Heap<VarOrderLt> order_heap;
 
+        ///Used instead of order_heap for this search round if set
+        bool vmtf_active = false;
+        VMTF vmtf;
+        vector<Var> vmtf_bumped; ///<Variables bumped during the last conflict analysis
+        bool vmtf_for_this_round() const;
+        void restore_vmtf();
+        void bump_vmtf();
+        Var  next_vmtf_var();
+
         //Clause activites
         double clauseActivityIncrease;
         void decayClauseAct();
@@ -944,11 +1131,52 @@ inline void Searcher::bump_var_activitiy(Var var)
     // Update order_heap with respect to new activity:
     if (order_heap.inHeap(var))
         order_heap.decrease(var);
+
+    //The queue is only updated once the conflict is analysed
+    if (vmtf_active)
+        vmtf_bumped.push_back(var);
+}
+
+/**
+@brief Whether to do hyper-binary resolution at decision level 1
+
+Not done when backtracking chronologically: level 0 literals can then be above
+trail_lim[0], and they have no ancestor at level 1. Not done with native XORs
+or Gauss-Jordan matrices either, whose implications do not go through the
+hyper-propagation
+*/
+inline bool Searcher::otf_hyperbin_at_first_level() const
+{
+    return conf.otfHyperbin
+        && !conf.doChronoBT
+        && !uses_xor_reasons()
+        && decisionLevel() == 1;
+}
+
+///Whether reasons can be temporary clauses made from XORs
+inline bool Searcher::uses_xor_reasons() const
+{
+    return !nativeXors.empty() || !gmatrices.empty();
+}
+
+/**
+@brief Returns the reason of the variable, for conflict analysis
+
+Reasons from native XORs are only turned into clauses here, when they are
+first needed.
+*/
+inline const PropBy& Searcher::get_reason(const Var var)
+{
+    if (varReason[var].getType() == xor_t) {
+        make_lazy_xor_reason(var);
+    }
+
+    return varReason[var];
 }
 
 inline uint32_t Searcher::abstractLevel(const Var x) const
 {
-    return ((uint32_t)1) << (varData[x].level % 32);
+    return ((uint32_t)1) << (varLevel[x] % 32);
 }
 
 inline const Searcher::Stats& Searcher::getStats() const
@@ -0,0 +1,149 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.0 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+#ifndef __SHAREDDATA_H__
+#define __SHAREDDATA_H__
+
+#include "solvertypesmini.h"
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <cassert>
+
+namespace CMSat {
+
+using std::vector;
+
+/**
+@brief Broadcast ring of clauses with exactly one writer and many readers
+
+Clauses are stored as [size, lit, lit, ...] words. The writer never waits:
+when it laps a slow reader, the reader notices (through 'reserved', which is
+advanced before any slot is overwritten) and skips everything it missed.
+Each reader keeps its own position, so the ring itself is never modified by
+readers.
+*/
+class ClauseRing
+{
+    public:
+        explicit ClauseRing(const size_t _size) :
+            size(_size)
+            , data(new std::atomic<uint32_t>[_size])
+            , reserved(0)
+            , published(0)
+        {}
+
+        ///Only to be called by the thread owning this ring
+        void push(const vector<Lit>& lits)
+        {
+            const uint64_t at = published.load(std::memory_order_relaxed);
+            const uint64_t end = at + lits.size() + 1;
+            if (lits.size() + 1 > size)
+                return;
+
+            reserved.store(end, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            data[at % size].store(lits.size(), std::memory_order_relaxed);
+            for(size_t i = 0; i < lits.size(); i++) {
+                data[(at + 1 + i) % size].store(lits[i].toInt(), std::memory_order_relaxed);
+            }
+            published.store(end, std::memory_order_release);
+        }
+
+        /**
+        @brief Appends the clauses published since 'at' to 'out' and advances 'at'
+
+        @returns FALSE if the writer overwrote some of the unread clauses. In
+        this case nothing is appended and 'at' is moved to the current end.
+        */
+        bool read(uint64_t& at, vector<uint32_t>& out) const
+        {
+            const uint64_t end = published.load(std::memory_order_acquire);
+            if (end - at > size) {
+                at = end;
+                return false;
+            }
+
+            const size_t origSize = out.size();
+            for(uint64_t i = at; i < end; i++) {
+                out.push_back(data[i % size].load(std::memory_order_relaxed));
+            }
+
+            //Check that none of the words we read were overwritten meanwhile
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (reserved.load(std::memory_order_relaxed) - at > size) {
+                out.resize(origSize);
+                at = published.load(std::memory_order_acquire);
+                return false;
+            }
+            at = end;
+
+            return true;
+        }
+
+        size_t memUsed() const
+        {
+            return sizeof(ClauseRing) + size*sizeof(uint32_t);
+        }
+
+    private:
+        const size_t size;
+        std::unique_ptr<std::atomic<uint32_t>[]> data;
+        std::atomic<uint64_t> reserved;
+        std::atomic<uint64_t> published;
+};
+
+/**
+@brief Clause exchange between the solver instances of a portfolio
+
+There is one ring per thread. The literals are in the numbering seen by the
+library user (i.e. without BVA variables), since each instance has its own
+internal numbering.
+*/
+class SharedData
+{
+    public:
+        SharedData(const size_t num_threads, const size_t ring_size)
+        {
+            for(size_t i = 0; i < num_threads; i++) {
+                rings.push_back(new ClauseRing(ring_size));
+            }
+        }
+
+        ~SharedData()
+        {
+            for(ClauseRing* ring: rings) {
+                delete ring;
+            }
+        }
+
+        size_t num_threads() const
+        {
+            return rings.size();
+        }
+
+        vector<ClauseRing*> rings;
+};
+
+} //end namespace
+
+#endif //__SHAREDDATA_H__
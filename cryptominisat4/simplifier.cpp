@@ -30,12 +30,14 @@
 #include <set>
 #include <iostream>
 #include <limits>
+#include <functional>
 #include <cmath>
 
 
 #include "simplifier.h"
 #include "clause.h"
 #include "solver.h"
+#include "membudget.h"
 #include "clausecleaner.h"
 #include "constants.h"
 #include "solutionextender.h"
@@ -437,6 +439,18 @@ bool Simplifier::decide_occur_limit(bool irred, uint64_t memUsage)
         return false;
     }
 
+    //Would go over the global memory budget
+    if (memUsage > solver->memBudget->headroom()) {
+        if (solver->conf.verbosity >= 2) {
+            cout
+            << "c [simp] Not linking in " << (irred ? "irred" : "red")
+            << " due to the memory budget"
+            << endl;
+        }
+
+        return false;
+    }
+
     return true;
 }
 
@@ -669,6 +683,9 @@ bool Simplifier::can_eliminate_var(const Var var) const
     if (solver->value(var) != l_Undef
         || solver->varData[var].removed != Removed::none
         ||  solver->assumptionsSet[var]
+        //Native XORs are not in the occurrence lists, so resolution would
+        //not see them: eliminating a variable in one would be unsound
+        || (var < inNativeXor.size() && inNativeXor[var])
     ) {
         return false;
     }
@@ -977,6 +994,7 @@ bool Simplifier::simplify()
 
     //Clean the clauses before playing with them
     solver->clauseCleaner->removeAndCleanAll();
+    solver->get_native_xor_vars(inNativeXor);
 
     //If too many clauses, don't do it
     if (solver->getNumLongClauses() > 10ULL*1000ULL*1000ULL
@@ -1817,13 +1835,13 @@ int Simplifier::test_elim_and_fill_resolvents(const Var var)
             //Calculate new clause stats
             ClauseStats stats;
             if ((it->isBinary() || it->isTri()) && it2->isClause())
-                stats = solver->clAllocator.getPointer(it2->getOffset())->stats;
+                stats = solver->clAllocator.getStats(*solver->clAllocator.getPointer(it2->getOffset()));
             else if ((it2->isBinary() || it2->isTri()) && it->isClause())
-                stats = solver->clAllocator.getPointer(it->getOffset())->stats;
+                stats = solver->clAllocator.getStats(*solver->clAllocator.getPointer(it->getOffset()));
             else if (it->isClause() && it2->isClause())
                 stats = ClauseStats::combineStats(
-                    solver->clAllocator.getPointer(it->getOffset())->stats
-                    , solver->clAllocator.getPointer(it2->getOffset())->stats
+                    solver->clAllocator.getStats(*solver->clAllocator.getPointer(it->getOffset()))
+                    , solver->clAllocator.getStats(*solver->clAllocator.getPointer(it2->getOffset()))
             );
 
             resolvents.push_back(std::make_pair(dummy, stats));
@@ -2268,7 +2286,7 @@ bool Simplifier::reverse_vivification_of_dummy(
         assert(lit.var() != posLit.var());
 
         //Use cache
-        const vector<LitExtra>& cache = solver->implCache[lit.toInt()].lits;
+        const TransCache& cache = solver->implCache[lit.toInt()];
         aggressive_elim_time_limit -= cache.size()/3;
         for(const LitExtra litextra: cache) {
             //If redundant, that doesn't help
@@ -2796,6 +2814,7 @@ size_t Simplifier::memUsed() const
 {
     size_t b = 0;
     b += poss_gate_parts.capacity()*sizeof(char);
+    b += inNativeXor.capacity()*sizeof(char);
     b += negs_gate_parts.capacity()*sizeof(char);
     b += gate_lits_of_elim_cls.capacity()*sizeof(Lit);
     b += seen.capacity()*sizeof(char);
@@ -3583,7 +3602,7 @@ bool Simplifier::add_longer_clause(const Lit new_lit, const OccurClause& cl)
                     lits[i] = orig_cl[i];
                 }
             }
-            Clause* newCl = solver->addClauseInt(lits, false, orig_cl.stats, false, &lits);
+            Clause* newCl = solver->addClauseInt(lits, false, solver->clAllocator.getStats(orig_cl), false, &lits);
             if (newCl != NULL) {
                 linkInClause(*newCl);
                 ClOffset offset = solver->clAllocator.getOffset(newCl);
@@ -506,6 +506,7 @@ private:
     void        add_clause_to_blck(Lit lit, const vector<Lit>& lits);
     void        set_var_as_eliminated(const Var var, const Lit lit);
     bool        can_eliminate_var(const Var var) const;
+    vector<char> inNativeXor; ///<Vars of XORs that are not in the CNF, set up for each simplify()
 
 
     TouchList   touched;
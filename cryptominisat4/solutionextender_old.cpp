@@ -176,11 +176,11 @@ bool SolutionExtender::addClause(
     vector<Lit>::iterator i = tmpLits.begin();
     vector<Lit>::iterator j = i;
     for (vector<Lit>::iterator end = tmpLits.end(); i != end; i++) {
-        if (value(*i) == l_True && solver->varData[i->var()].level == 0) {
+        if (value(*i) == l_True && solver->varLevel[i->var()] == 0) {
             return true;
         }
 
-        if (value(*i) == l_False && solver->varData[i->var()].level == 0) {
+        if (value(*i) == l_False && solver->varLevel[i->var()] == 0) {
             continue;
         }
 
@@ -200,6 +200,7 @@ bool SolutionExtender::addClause(
     Clause* cl = solver->clAllocator.Clause_new(
         tmpLits //the literals
         , 0 //the time it was created -- useless, ignoring
+        , false //irredundant
         , true //yes, this is extender, so don't care if it's <=3 in size
     );
     ClOffset offset = solver->clAllocator.getOffset(cl);
@@ -396,7 +397,7 @@ bool SolutionExtender::propagateCl(
     #endif
     assert(blockedOn != lit_Undef);
 
-    if (solver->varData[blockedOn.var()].level == 0) {
+    if (solver->varLevel[blockedOn.var()] == 0) {
         cout
         << "!! Flip 0-level var:"
         << solver->map_inter_to_outer(blockedOn.var()) + 1
@@ -404,7 +405,7 @@ bool SolutionExtender::propagateCl(
     }
 
     assert(
-        (solver->varData[blockedOn.var()].level != 0
+        (solver->varLevel[blockedOn.var()] != 0
             //|| solver->varData[blockedOn.var()].removed == Removed::decomposed
         )
         && "We cannot flip 0-level vars"
@@ -421,7 +422,7 @@ void SolutionExtender::enqueue(const Lit lit)
     #ifdef VERBOSE_DEBUG_RECONSTRUCT
     cout << "c Enqueueing lit " << lit << " during solution reconstruction" << endl;
     #endif
-    solver->varData[lit.var()].level = std::numeric_limits< uint32_t >::max();
+    solver->varLevel[lit.var()] = std::numeric_limits< uint32_t >::max();
 }
 
 void SolutionExtender::replaceSet(Lit toSet)
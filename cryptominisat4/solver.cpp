@@ -26,6 +26,7 @@
 #include "sccfinder.h"
 #include "simplifier.h"
 #include "prober.h"
+#include "cubegenerator.h"
 #include "vivifier.h"
 #include "clausecleaner.h"
 #include "solutionextender.h"
@@ -40,10 +41,13 @@
 #include "watchalgos.h"
 #include "clauseallocator.h"
 #include "subsumeimplicit.h"
+#include "membudget.h"
+#include "localsearch.h"
 #include "strengthener.h"
 
 #include <fstream>
 #include <cmath>
+#include <functional>
 #include <fcntl.h>
 
 using namespace CMSat;
@@ -71,6 +75,8 @@ Solver::Solver(const SolverConf _conf) :
     , varReplacer(NULL)
     , compHandler(NULL)
     , subsumeImplicit(NULL)
+    , memBudget(NULL)
+    , localSearch(NULL)
     , mtrand(_conf.origSeed)
     , needToInterrupt(false)
 
@@ -118,6 +124,10 @@ Solver::Solver(const SolverConf _conf) :
     if (conf.doStrSubImplicit) {
         subsumeImplicit = new SubsumeImplicit(this);
     }
+    memBudget = new MemBudget(this);
+    if (conf.doLocalSearch) {
+        localSearch = new LocalSearch(this);
+    }
     Searcher::solver = this;
 }
 
@@ -133,12 +143,15 @@ Solver::~Solver()
     delete clauseCleaner;
     delete varReplacer;
     delete subsumeImplicit;
+    delete memBudget;
+    delete localSearch;
 }
 
 bool Solver::add_xor_clause_inter(
     const vector< Lit >& lits
     , bool rhs
     , const bool attach
+    , const bool store
 ) {
     assert(ok);
     assert(!attach || qhead == trail.size());
@@ -186,6 +199,24 @@ bool Solver::add_xor_clause_inter(
     }
     //cout << "Cleaned ps is: " << ps << endl;
 
+    //Kept for the search, too. Long ones only there, if allowed
+    if (store && !ps.empty()) {
+        const bool native = native_xors_allowed()
+            && ps.size() >= conf.nativeXorMinSize;
+        if (native || conf.doGauss) {
+            vector<Var> outerVars;
+            for(const Lit lit: ps) {
+                outerVars.push_back(map_inter_to_outer(lit.var()));
+            }
+            xorclauses.add(outerVars, rhs, native);
+        }
+
+        if (native) {
+            numNativeXors++;
+            return ok;
+        }
+    }
+
     if (!ps.empty()) {
         ps[0] ^= rhs;
     } else {
@@ -395,10 +426,8 @@ Clause* Solver::addClauseInt(
             return NULL;
 
         default:
-            Clause* c = clAllocator.Clause_new(ps, sumStats.conflStats.numConflicts);
-            if (red)
-                c->makeRed(stats.glue);
-            c->stats = stats;
+            Clause* c = clAllocator.Clause_new(ps, sumStats.conflStats.numConflicts, red);
+            clAllocator.getStats(*c) = stats;
 
             //In class 'Simplifier' we don't need to attach normall
             if (attach)
@@ -1045,8 +1074,8 @@ bool Solver::reduceDBStructGlue::operator () (
     assert(xsize > 2 && ysize > 2);
 
     //First tie: glue
-    if (x->stats.glue > y->stats.glue) return 1;
-    if (x->stats.glue < y->stats.glue) return 0;
+    if (clAllocator.getStats(*x).glue > clAllocator.getStats(*y).glue) return 1;
+    if (clAllocator.getStats(*x).glue < clAllocator.getStats(*y).glue) return 0;
 
     //Second tie: size
     return xsize > ysize;
@@ -1067,8 +1096,8 @@ bool Solver::reduceDBStructActivity::operator () (
     assert(xsize > 2 && ysize > 2);
 
     //First tie: activity
-    if (x->stats.activity < y->stats.activity) return 1;
-    if (x->stats.activity > y->stats.activity) return 0;
+    if (clAllocator.getStats(*x).activity < clAllocator.getStats(*y).activity) return 1;
+    if (clAllocator.getStats(*x).activity > clAllocator.getStats(*y).activity) return 0;
 
     //Second tie: size
     return xsize > ysize;
@@ -1095,7 +1124,7 @@ bool Solver::reduceDBStructSize::operator () (
     if (xsize < ysize) return 0;
 
     //Second tie: glue
-    return x->stats.glue > y->stats.glue;
+    return clAllocator.getStats(*x).glue > clAllocator.getStats(*y).glue;
 }
 
 bool Solver::reduceDBStructPropConfl::operator() (
@@ -1112,14 +1141,14 @@ bool Solver::reduceDBStructPropConfl::operator() (
     //No clause should be less than 3-long: 2&3-long are not removed
     assert(xsize > 2 && ysize > 2);
 
-    const uint64_t x_useful = x->stats.numPropAndConfl(confl_multiplier);
-    const uint64_t y_useful = y->stats.numPropAndConfl(confl_multiplier);
+    const uint64_t x_useful = clAllocator.getStats(*x).numPropAndConfl(confl_multiplier);
+    const uint64_t y_useful = clAllocator.getStats(*y).numPropAndConfl(confl_multiplier);
     if (x_useful != y_useful)
         return x_useful < y_useful;
 
     //Second tie: UIP usage
-    if (x->stats.used_for_uip_creation != y->stats.used_for_uip_creation)
-        return x->stats.used_for_uip_creation < y->stats.used_for_uip_creation;
+    if (clAllocator.getStats(*x).used_for_uip_creation != clAllocator.getStats(*y).used_for_uip_creation)
+        return clAllocator.getStats(*x).used_for_uip_creation < clAllocator.getStats(*y).used_for_uip_creation;
 
     return x->size() > y->size();
 }
@@ -1138,22 +1167,22 @@ bool Solver::reduceDBStructConflDepth::operator() (
     //No clause should be less than 3-long: 2&3-long are not removed
     assert(xsize > 2 && ysize > 2);
 
-    if (x->stats.numPropAndConfl(1) == 0 && y->stats.numPropAndConfl(1) == 0)
+    if (clAllocator.getStats(*x).numPropAndConfl(1) == 0 && clAllocator.getStats(*y).numPropAndConfl(1) == 0)
         return false;
 
-    if (x->stats.numPropAndConfl(1) == 0)
+    if (clAllocator.getStats(*x).numPropAndConfl(1) == 0)
         return true;
-    if (y->stats.numPropAndConfl(1) == 0)
+    if (clAllocator.getStats(*y).numPropAndConfl(1) == 0)
         return false;
 
-    const double x_useful = x->stats.confl_usefulness();
-    const double y_useful = y->stats.confl_usefulness();
+    const double x_useful = clAllocator.getStats(*x).confl_usefulness();
+    const double y_useful = clAllocator.getStats(*y).confl_usefulness();
     if (x_useful != y_useful)
         return x_useful < y_useful;
 
     //Second tie: UIP usage
-    if (x->stats.used_for_uip_creation != y->stats.used_for_uip_creation)
-        return x->stats.used_for_uip_creation < y->stats.used_for_uip_creation;
+    if (clAllocator.getStats(*x).used_for_uip_creation != clAllocator.getStats(*y).used_for_uip_creation)
+        return clAllocator.getStats(*x).used_for_uip_creation < clAllocator.getStats(*y).used_for_uip_creation;
 
     return x->size() > y->size();
 }
@@ -1169,22 +1198,23 @@ void Solver::pre_clean_clause_db(
             ClOffset offset = longRedCls[i];
             Clause* cl = clAllocator.getPointer(offset);
             assert(cl->size() > 3);
-            if (cl->stats.numPropAndConfl(conf.clean_confl_multiplier) < conf.preClauseCleanLimit
-                && !cl->stats.locked
-                && cl->stats.introduced_at_conflict + conf.preCleanMinConflTime
+            if (clAllocator.getStats(*cl).numPropAndConfl(conf.clean_confl_multiplier) < conf.preClauseCleanLimit
+                && !clAllocator.getStats(*cl).locked
+                && clAllocator.getStats(*cl).tier == RedTier::local
+                && clAllocator.getStats(*cl).introduced_at_conflict + conf.preCleanMinConflTime
                     < sumStats.conflStats.numConflicts
             ) {
                 //Stat update
-                tmpStats.preRemove.incorporate(cl);
-                tmpStats.preRemove.age += sumConfl - cl->stats.introduced_at_conflict;
+                tmpStats.preRemove.incorporate(cl, clAllocator.getStats(*cl));
+                tmpStats.preRemove.age += sumConfl - clAllocator.getStats(*cl).introduced_at_conflict;
 
                 //Check
-                assert(cl->stats.introduced_at_conflict <= sumConfl);
+                assert(clAllocator.getStats(*cl).introduced_at_conflict <= sumConfl);
 
-                if (cl->stats.glue > cl->size() + 1000) {
+                if (clAllocator.getStats(*cl).glue > cl->size() + 1000) {
                     cout
                     << "c DEBUG strangely large glue: " << *cl
-                    << " glue: " << cl->stats.glue
+                    << " glue: " << clAllocator.getStats(*cl).glue
                     << " size: " << cl->size()
                     << endl;
                 }
@@ -1201,34 +1231,87 @@ void Solver::pre_clean_clause_db(
     }
 }
 
+/**
+@brief Demotes mid tier clauses unused since the last check, and counts the tiers
+
+Only done every conf.midTierCleanEvery cleanings, so a mid tier clause gets at
+least that many cleaning rounds to be used in conflict analysis again. Under
+memory pressure it is done at every cleaning.
+*/
+void Solver::update_red_tiers(CleaningStats& tmpStats)
+{
+    const bool check_mid = memBudget->under_pressure()
+        || (conf.midTierCleanEvery > 0
+            && solveStats.nbReduceDB % conf.midTierCleanEvery == 0);
+
+    for(const ClOffset offset: longRedCls) {
+        ClauseStats& stats = clAllocator.getStats(*clAllocator.getPointer(offset));
+        if (check_mid
+            && stats.tier == RedTier::mid
+            && stats.last_touched < lastMidTierCheck
+        ) {
+            stats.tier = RedTier::local;
+            tmpStats.midDemoted++;
+        }
+
+        switch(stats.tier) {
+            case RedTier::core:
+                tmpStats.numCore++;
+                break;
+            case RedTier::mid:
+                tmpStats.numMid++;
+                break;
+            case RedTier::local:
+                tmpStats.numLocal++;
+                break;
+        }
+    }
+
+    if (check_mid) {
+        lastMidTierCheck = sumConflicts();
+    }
+}
+
+/**
+@brief Moves the clauses that may be removed to the front of longRedCls
+
+These are the local tier clauses that are not locked and have been in the
+database long enough.
+
+@returns the number of such clauses
+*/
+size_t Solver::move_cleanable_red_cls_to_front()
+{
+    const uint64_t sumConfl = sumConflicts();
+    const uint64_t minTimeInDB = memBudget->min_time_in_db(
+        conf.min_time_in_db_before_eligible_for_cleaning);
+    auto it = std::partition(longRedCls.begin(), longRedCls.end()
+        , [&] (const ClOffset offset) -> bool {
+            const ClauseStats& stats = clAllocator.getStats(*clAllocator.getPointer(offset));
+            return stats.tier == RedTier::local
+                && !stats.locked
+                && stats.introduced_at_conflict + minTimeInDB < sumConfl;
+        }
+    );
+
+    return it - longRedCls.begin();
+}
+
 void Solver::real_clean_clause_db(
     CleaningStats& tmpStats
     , uint64_t sumConfl
     , uint64_t removeNum
 ) {
-    size_t i, j;
-    for (i = j = 0
-        ; i < longRedCls.size() && tmpStats.removed.num < removeNum
-        ; i++
-    ) {
+    //The clauses to remove are at the front
+    for (size_t i = 0; i < removeNum; i++) {
         ClOffset offset = longRedCls[i];
         Clause* cl = clAllocator.getPointer(offset);
         assert(cl->size() > 3);
-
-        //Don't delete if not aged long enough or locked
-        if (cl->stats.introduced_at_conflict + conf.min_time_in_db_before_eligible_for_cleaning
-                >= Searcher::sumConflicts()
-             || cl->stats.locked
-        ) {
-            longRedCls[j++] = offset;
-            tmpStats.remain.incorporate(cl);
-            tmpStats.remain.age += sumConfl - cl->stats.introduced_at_conflict;
-            continue;
-        }
+        assert(!clAllocator.getStats(*cl).locked);
 
         //Stats Update
-        tmpStats.removed.incorporate(cl);
-        tmpStats.removed.age += sumConfl - cl->stats.introduced_at_conflict;
+        tmpStats.removed.incorporate(cl, clAllocator.getStats(*cl));
+        tmpStats.removed.age += sumConfl - clAllocator.getStats(*cl).introduced_at_conflict;
 
         //free clause
         *drup << del << *cl << fin;
@@ -1236,34 +1319,37 @@ void Solver::real_clean_clause_db(
     }
 
     //Count what is left
-    for (; i < longRedCls.size(); i++) {
+    size_t j = 0;
+    for (size_t i = removeNum; i < longRedCls.size(); i++) {
         ClOffset offset = longRedCls[i];
         Clause* cl = clAllocator.getPointer(offset);
 
         //Stats Update
-        tmpStats.remain.incorporate(cl);
-        tmpStats.remain.age += sumConfl - cl->stats.introduced_at_conflict;
+        tmpStats.remain.incorporate(cl, clAllocator.getStats(*cl));
+        tmpStats.remain.age += sumConfl - clAllocator.getStats(*cl).introduced_at_conflict;
 
-        if (cl->stats.introduced_at_conflict > sumConfl) {
+        if (clAllocator.getStats(*cl).introduced_at_conflict > sumConfl) {
             cout
             << "c DEBUG: conflict introduction numbers are wrong."
-            << " according to CL, introduction: " << cl->stats.introduced_at_conflict
+            << " according to CL, introduction: " << clAllocator.getStats(*cl).introduced_at_conflict
             << " but we think max confl: "  << sumConfl
             << endl;
         }
-        assert(cl->stats.introduced_at_conflict <= sumConfl);
+        assert(clAllocator.getStats(*cl).introduced_at_conflict <= sumConfl);
 
         longRedCls[j++] = offset;
     }
 
     //Resize long redundant clause array
-    longRedCls.resize(longRedCls.size() - (i - j));
+    longRedCls.resize(j);
 }
 
-uint64_t Solver::calc_how_many_to_remove()
-{
-    //Calculate how many to remove
-    uint64_t origRemoveNum = (double)longRedCls.size() *conf.ratioRemoveClauses;
+uint64_t Solver::calc_how_many_to_remove(
+    const size_t numLocal
+    , const size_t numCleanable
+) {
+    //Calculate how many to remove, only the local tier is ever cleaned
+    uint64_t origRemoveNum = (double)numLocal * memBudget->remove_ratio(conf.ratioRemoveClauses);
 
     //If there is a ratio limit, and we are over it
     //then increase the removeNum accordingly
@@ -1292,63 +1378,81 @@ uint64_t Solver::calc_how_many_to_remove()
         }
     }
 
-    return removeNum;
+    return std::min<uint64_t>(removeNum, numCleanable);
 }
 
-void Solver::sort_red_cls_as_required(CleaningStats& tmpStats)
-{
+/**
+@brief Puts the worst 'removeNum' cleanable clauses to the front
+
+Only a partial selection is done. The rest of the cleanable clauses is only
+sorted when locking or printing the best of them needs the order.
+*/
+template<class Comp>
+void Solver::select_red_cls_with(
+    Comp comp
+    , const size_t numCleanable
+    , const uint64_t removeNum
+) {
+    const auto begin = longRedCls.begin();
+    const auto end = longRedCls.begin() + numCleanable;
+    if (removeNum > 0 && removeNum < numCleanable) {
+        std::nth_element(begin, begin + removeNum, end, comp);
+    }
+
+    if (conf.lock_topclean_per_dbclean > 0
+        || conf.doPrintBestRedClauses > 0
+    ) {
+        std::sort(begin + removeNum, end, comp);
+    }
+}
+
+void Solver::select_red_cls_to_remove(
+    CleaningStats& tmpStats
+    , const size_t numCleanable
+    , const uint64_t removeNum
+) {
     switch (conf.clauseCleaningType) {
     case clean_glue_based :
-        //Sort for glue-based removal
-        std::sort(longRedCls.begin(), longRedCls.end()
-            , reduceDBStructGlue(clAllocator));
+        select_red_cls_with(reduceDBStructGlue(clAllocator), numCleanable, removeNum);
         tmpStats.glueBasedClean = 1;
         break;
 
     case clean_size_based :
-        //Sort for glue-based removal
-        std::sort(longRedCls.begin(), longRedCls.end()
-            , reduceDBStructSize(clAllocator));
+        select_red_cls_with(reduceDBStructSize(clAllocator), numCleanable, removeNum);
         tmpStats.sizeBasedClean = 1;
         break;
 
     case clean_sum_activity_based :
-        //Sort for glue-based removal
-        std::sort(longRedCls.begin(), longRedCls.end()
-            , reduceDBStructActivity(clAllocator));
+        select_red_cls_with(reduceDBStructActivity(clAllocator), numCleanable, removeNum);
         tmpStats.actBasedClean = 1;
         break;
 
     case clean_sum_prop_confl_based : {
         uint64_t multiplier = conf.clean_confl_multiplier;
-
-        //Sort for glue-based removal
-        std::sort(longRedCls.begin(), longRedCls.end()
-            , reduceDBStructPropConfl(clAllocator, multiplier));
+        select_red_cls_with(reduceDBStructPropConfl(clAllocator, multiplier), numCleanable, removeNum);
         tmpStats.propConflBasedClean = 1;
         break;
     }
 
     case clean_sum_confl_depth_based :
-        //Sort for glue-based removal
-        std::sort(longRedCls.begin(), longRedCls.end()
-            , reduceDBStructConflDepth(clAllocator));
+        select_red_cls_with(reduceDBStructConflDepth(clAllocator), numCleanable, removeNum);
         tmpStats.propConflBasedClean = 1;
         break;
     }
 }
 
-void Solver::print_best_irred_clauses_if_required() const
+///Prints the best of the surviving cleanable clauses, which end at 'end'
+void Solver::print_best_irred_clauses_if_required(const size_t end) const
 {
-    if (longRedCls.empty()
+    if (end == 0
         || conf.doPrintBestRedClauses == 0
     ) {
         return;
     }
 
     size_t at = 0;
-    for(long i = ((long)longRedCls.size())-1
-        ; i > ((long)longRedCls.size())-1-conf.doPrintBestRedClauses && i >= 0
+    for(long i = ((long)end)-1
+        ; i > ((long)end)-1-conf.doPrintBestRedClauses && i >= 0
         ; i--
     ) {
         ClOffset offset = longRedCls[i];
@@ -1374,7 +1478,6 @@ CleaningStats Solver::reduceDB(bool lock_clauses_in)
     CleaningStats tmpStats;
     tmpStats.origNumClauses = longRedCls.size();
     tmpStats.origNumLits = litStats.redLits;
-    uint64_t removeNum = calc_how_many_to_remove();
 
     //Subsume
     uint64_t sumConfl = sumConflicts();
@@ -1394,13 +1497,17 @@ CleaningStats Solver::reduceDB(bool lock_clauses_in)
         lock_most_UIP_used_clauses();
 
     pre_clean_clause_db(tmpStats, sumConfl);
+    update_red_tiers(tmpStats);
+    const size_t numCleanable = move_cleanable_red_cls_to_front();
+    const uint64_t removeNum = calc_how_many_to_remove(tmpStats.numLocal, numCleanable);
     tmpStats.clauseCleaningType = conf.clauseCleaningType;
-    sort_red_cls_as_required(tmpStats);
-    print_best_irred_clauses_if_required();
+    select_red_cls_to_remove(tmpStats, numCleanable, removeNum);
+    print_best_irred_clauses_if_required(numCleanable);
     real_clean_clause_db(tmpStats, sumConfl, removeNum);
+    tmpStats.numLocal -= removeNum;
 
     if (lock_clauses_in)
-        lock_in_top_N_uncleaned();
+        lock_in_top_N_uncleaned(numCleanable - removeNum);
 
     //Reattach what's left
     detachReattach.reattachLongs();
@@ -1418,20 +1525,21 @@ CleaningStats Solver::reduceDB(bool lock_clauses_in)
     return tmpStats;
 }
 
-void Solver::lock_in_top_N_uncleaned()
+///Locks the best of the surviving cleanable clauses, which end at 'end'
+void Solver::lock_in_top_N_uncleaned(const size_t end)
 {
     size_t locked = 0;
     size_t skipped = 0;
 
-    long cutoff = (long)longRedCls.size() - (long)conf.lock_topclean_per_dbclean;
-    for(long i = (long)longRedCls.size()-1
+    long cutoff = (long)end - (long)conf.lock_topclean_per_dbclean;
+    for(long i = (long)end-1
         ; i >= 0 && i >= cutoff
         ; i--
     ) {
         const ClOffset offs = longRedCls[i];
         Clause& cl = *clAllocator.getPointer(offs);
-        if (!cl.stats.locked) {
-            cl.stats.locked = true;
+        if (!clAllocator.getStats(cl).locked) {
+            clAllocator.getStats(cl).locked = true;
             locked++;
         } else {
             skipped++;
@@ -1454,22 +1562,38 @@ void Solver::lock_most_UIP_used_clauses()
             const Clause& a_cl = *clAllocator.getPointer(a);
             const Clause& b_cl = *clAllocator.getPointer(b);
 
-            return a_cl.stats.used_for_uip_creation > b_cl.stats.used_for_uip_creation;
+            return clAllocator.getStats(a_cl).used_for_uip_creation > clAllocator.getStats(b_cl).used_for_uip_creation;
     };
-    std::sort(longRedCls.begin(), longRedCls.end(), uipsort);
 
-    size_t locked = 0;
+    //Only the unlocked ones can be locked, select the most used among them
+    auto unlocked_end = std::partition(longRedCls.begin(), longRedCls.end()
+        , [&] (const ClOffset offs) -> bool {
+            return !clAllocator.getStats(*clAllocator.getPointer(offs)).locked;
+        }
+    );
+    const size_t locked = std::min<size_t>(
+        conf.lock_uip_per_dbclean
+        , unlocked_end - longRedCls.begin()
+    );
+    if (locked < (size_t)(unlocked_end - longRedCls.begin())) {
+        std::nth_element(longRedCls.begin(), longRedCls.begin() + locked, unlocked_end, uipsort);
+    }
+
+    uint32_t least_used = std::numeric_limits<uint32_t>::max();
+    for(size_t i = 0; i < locked; i++) {
+        Clause& cl = *clAllocator.getPointer(longRedCls[i]);
+        clAllocator.getStats(cl).locked = true;
+        least_used = std::min<uint32_t>(least_used, clAllocator.getStats(cl).used_for_uip_creation);
+    }
+
+    //Already locked clauses that rank above the ones just locked. If the
+    //unlocked ones ran out, all of them would have been passed over
     size_t skipped = 0;
-    for(size_t i = 0
-        ; i < longRedCls.size() && locked < conf.lock_uip_per_dbclean
-        ; i++
-    ) {
-        const ClOffset offs = longRedCls[i];
-        Clause& cl = *clAllocator.getPointer(offs);
-        if (!cl.stats.locked) {
-            cl.stats.locked = true;
-            locked++;
-        } else {
+    for(auto it = unlocked_end; it != longRedCls.end(); ++it) {
+        const Clause& cl = *clAllocator.getPointer(*it);
+        if (locked < conf.lock_uip_per_dbclean
+            || clAllocator.getStats(cl).used_for_uip_creation > least_used
+        ) {
             skipped++;
         }
     }
@@ -1652,6 +1776,7 @@ lbool Solver::solve()
     release_assert(!(conf.doLHBR && !conf.propBinFirst)
         && "You must NOT set both LHBR and any-order propagation. LHBR needs binary clauses propagated first."
     );
+    select_propagate_func();
 
     release_assert(conf.shortTermHistorySize > 0
         && "You MUST give a short term history size (\"--gluehist\")  greater than 0!"
@@ -1719,6 +1844,7 @@ lbool Solver::solve()
 
         //This is crucial, since we need to attach() clauses to threads
         clauseCleaner->removeAndCleanAll();
+        memBudget->enforce();
 
         //Solve using threads
         const size_t origTrailSize = trail.size();
@@ -1833,6 +1959,8 @@ lbool Solver::simplifyProblem()
     }
 
     if (conf.doCompHandler
+        //The components do not know about the native XORs
+        && numNativeXors == 0
         && getNumFreeVars() < conf.compVarLimit
         && solveStats.numSimplify >= conf.handlerFromSimpNum
         //Only every 2nd, since it can be costly to find parts
@@ -2041,27 +2169,27 @@ ClauseUsageStats Solver::sumClauseData(
         if (cl.size() == 3)
             continue;
 
-        stats.addStat(cl);
+        stats.addStat(clAllocator.getStats(cl));
 
         //Update size statistics
         if (perSizeStats.size() < cl.size() + 1U)
             perSizeStats.resize(cl.size()+1);
 
-        perSizeStats[clause_size].addStat(cl);
+        perSizeStats[clause_size].addStat(clAllocator.getStats(cl));
 
         //If redundant, sum up GLUE-based stats
         if (red) {
-            const size_t glue = cl.stats.glue;
+            const size_t glue = clAllocator.getStats(cl).glue;
             assert(glue != std::numeric_limits<uint32_t>::max());
             if (perSizeStats.size() < glue + 1) {
                 perSizeStats.resize(glue + 1);
             }
 
-            perSizeStats[glue].addStat(cl);
+            perSizeStats[glue].addStat(clAllocator.getStats(cl));
         }
 
         if (conf.verbosity >= 4)
-            cl.print_extra_stats();
+            cl.print_extra_stats(clAllocator.getStats(cl));
     }
 
     //Print more stats
@@ -2131,11 +2259,11 @@ void Solver::clearClauseStats(vector<ClOffset>& clauseset)
         ; it++
     ) {
         Clause* cl = clAllocator.getPointer(*it);
-        cl->stats.clearAfterReduceDB(conf.multiplier_perf_values_after_cl_clean);
+        clAllocator.getStats(*cl).clearAfterReduceDB(conf.multiplier_perf_values_after_cl_clean);
     }
 }
 
-void Solver::reduce_db_and_update_reset_stats(bool lock_clauses_in)
+void Solver::reduce_db_and_update_reset_stats(bool lock_clauses_in, bool update_limit)
 {
     ClauseUsageStats irred_cl_usage_stats = sumClauseData(longIrredCls, false);
     ClauseUsageStats red_cl_usage_stats = sumClauseData(longRedCls, true);
@@ -2153,6 +2281,7 @@ void Solver::reduce_db_and_update_reset_stats(bool lock_clauses_in)
         sum_cl_usage_stats.print();
     }
 
+    memBudget->update_pressure(!update_limit);
     CleaningStats iterCleanStat = reduceDB(lock_clauses_in);
     consolidateMem();
 
@@ -2165,13 +2294,17 @@ void Solver::reduce_db_and_update_reset_stats(bool lock_clauses_in)
         clearClauseStats(longRedCls);
     }
 
-    nextCleanLimit += nextCleanLimitInc;
-    nextCleanLimitInc *= conf.increaseClean;
+    //Out-of-schedule cleanings due to memory don't push the schedule
+    if (update_limit) {
+        nextCleanLimit += nextCleanLimitInc;
+        nextCleanLimitInc *= conf.increaseClean;
+    }
 }
 
 void Solver::consolidateMem()
 {
-    clAllocator.consolidate(this, true);
+    //Called after clause cleaning: the redundant arena is worth compacting
+    clAllocator.consolidate(this, false, true);
 }
 
 void Solver::printStats() const
@@ -2227,6 +2360,15 @@ void Solver::printMinStats() const
 
         prober->getStats().printShort();
     }
+
+    //Local search stats
+    if (conf.doLocalSearch) {
+        printStatsLine("c local search time"
+            , localSearch->getStats().cpu_time
+            , stats_line_percent(localSearch->getStats().cpu_time, cpu_time)
+            , "% time"
+        );
+    }
     //Simplifier stats
     if (conf.perform_occur_based_simp) {
         printStatsLine("c Simplifier time"
@@ -2329,6 +2471,28 @@ void Solver::printFullStats() const
         prober->getStats().print(nVars());
     }
 
+    //Local search stats
+    if (conf.doLocalSearch) {
+        printStatsLine("c local search time"
+            , localSearch->getStats().cpu_time
+            , stats_line_percent(localSearch->getStats().cpu_time, cpu_time)
+            , "% time"
+        );
+
+        localSearch->getStats().print();
+    }
+
+    //Gauss-Jordan stats
+    if (gaussStats.numMatrixes > 0) {
+        printStatsLine("c gauss init time"
+            , gaussStats.initTime
+            , stats_line_percent(gaussStats.initTime, cpu_time)
+            , "% time"
+        );
+
+        gaussStats.print();
+    }
+
     //Simplifier stats
     if (conf.perform_occur_based_simp) {
         printStatsLine("c Simplifier time"
@@ -2393,6 +2557,10 @@ void Solver::printFullStats() const
         implCache.printStats(this);
     }
 
+    if (memBudget->limited()) {
+        memBudget->getStats().print();
+    }
+
     //Other stats
     printStatsLine("c Conflicts in UIP"
         , sumStats.conflStats.numConflicts
@@ -2431,6 +2599,16 @@ void Solver::printMemStats() const
         , totalMem/(1024UL*1024UL)
         , "MB"
     );
+    printStatsLine("c Peak mem used"
+        , memUsedPeak()/(1024UL*1024UL)
+        , "MB"
+    );
+    if (memBudget->limited()) {
+        printStatsLine("c Mem budget"
+            , conf.maxMemMB
+            , "MB"
+        );
+    }
     uint64_t account = 0;
 
     account += print_mem_used_longclauses(totalMem);
@@ -2438,6 +2616,8 @@ void Solver::printMemStats() const
 
     size_t mem = 0;
     mem += assigns.capacity()*sizeof(lbool);
+    mem += varLevel.capacity()*sizeof(uint32_t);
+    mem += varReason.capacity()*sizeof(PropBy);
     mem += varData.capacity()*sizeof(VarData);
     #ifdef STATS_NEEDED_EXTRA
     mem += varDataLT.capacity()*sizeof(VarData::Stats);
@@ -2694,6 +2874,21 @@ void Solver::dumpEquivalentLits(std::ostream* os) const
     varReplacer->print_equivalent_literals(os);
 }
 
+Lit Solver::map_assumption_to_conflict(const Lit lit) const
+{
+    //get_final_conflict() is in the outer numbering, after var replacement
+    return ~varReplacer->getLitReplacedWithOuter(map_to_with_bva(lit));
+}
+
+vector<vector<Lit> > Solver::generate_cubes(
+    const vector<Lit>* assumptions
+    , const unsigned depth
+    , bool& usedAssumptions
+) {
+    CubeGenerator cubeGenerator(this);
+    return cubeGenerator.generate(assumptions, depth, usedAssumptions);
+}
+
 vector<Lit> Solver::get_zero_assigned_lits() const
 {
     vector<Lit> lits;
@@ -3088,6 +3283,13 @@ void Solver::setNeedToInterrupt()
     needToInterrupt = true;
 }
 
+void Solver::unsetNeedToInterrupt()
+{
+    Searcher::unsetNeedToInterrupt();
+
+    needToInterrupt = false;
+}
+
 lbool Solver::modelValue (const Lit p) const
 {
     return model[p.var()] ^ p.sign();
@@ -3664,12 +3866,12 @@ void Solver::calcReachability()
         for (uint32_t sig1 = 0; sig1 < 2; sig1++)  {
             const Lit lit = Lit(var, sig1);
 
-            const vector<LitExtra>& cache = implCache[lit.toInt()].lits;
+            const TransCache& cache = implCache[lit.toInt()];
             uint32_t cacheSize = cache.size();
-            for (vector<LitExtra>::const_iterator
+            for (TransCache::const_iterator
                 it = cache.begin(), end = cache.end()
                 ; it != end
-                ; it++
+                ; ++it
             ) {
                 /*if (solver.value(it->var()) != l_Undef
                 || solver.subsumer->getVarElimed()[it->var()]
@@ -3749,6 +3951,13 @@ void Solver::new_external_var()
     new_var(false);
 }
 
+void Solver::new_external_vars(const size_t n)
+{
+    for(size_t i = 0; i < n; i++) {
+        new_var(false);
+    }
+}
+
 void Solver::add_in_partial_solving_stats()
 {
     Searcher::add_in_partial_solving_stats();
@@ -3767,6 +3976,173 @@ unsigned long Solver::get_sql_id() const
     return sqlStats->get_runID();
 }
 
+///Whether long XORs may be kept out of the CNF, propagated by Searcher::xor_propagate()
+bool Solver::native_xors_allowed() const
+{
+    return conf.doNativeXor
+        //The proof would be missing the XORs
+        && !drup->enabled()
+        //Native XORs imply at the current level, not the level of their lits
+        && !conf.doChronoBT;
+}
+
+/**
+@brief Cleans an XOR given in OUTER numbering against the current state
+
+Replaced variables are updated, values at level 0 are moved into the
+right-hand side, and variables that occur twice cancel out.
+
+@param out the variables of the XOR, in INTER numbering
+@returns FALSE if the XOR has an eliminated or decomposed variable
+*/
+bool Solver::clean_xor(
+    const Var* vars
+    , const uint32_t size
+    , bool& rhs
+    , vector<Var>& out
+) const {
+    assert(decisionLevel() == 0);
+    out.clear();
+    for(uint32_t i = 0; i < size; i++) {
+        Lit lit = varReplacer->getLitReplacedWithOuter(Lit(vars[i], false));
+        lit = map_outer_to_inter(lit);
+        rhs ^= lit.sign();
+
+        //Set variables may be renumbered beyond nVars()
+        if (value(lit.var()) != l_Undef) {
+            rhs ^= value(lit.var()) == l_True;
+            continue;
+        }
+
+        if (lit.var() >= nVars()
+            || varData[lit.var()].removed != Removed::none
+        ) {
+            return false;
+        }
+        out.push_back(lit.var());
+    }
+
+    //The same variable twice cancels out
+    std::sort(out.begin(), out.end());
+    size_t j = 0;
+    for(size_t i = 0; i < out.size(); i++) {
+        if (j > 0 && out[j-1] == out[i]) {
+            j--;
+        } else {
+            out[j++] = out[i];
+        }
+    }
+    out.resize(j);
+
+    return true;
+}
+
+/**
+@brief Returns the XORs in INTER numbering, cleaned against the current state
+
+XORs that contain eliminated variables are skipped.
+
+@returns FALSE if an XOR turned out to be empty with a right-hand side of 1
+*/
+bool Solver::get_xors_for_gauss(vector<Xor>& xors) const
+{
+    xors.clear();
+
+    vector<Var> vars;
+    for(uint32_t at = xorclauses.begin()
+        ; at != xorclauses.end()
+        ; at = xorclauses.next(at)
+    ) {
+        bool rhs = xorclauses.rhs(at);
+        if (!clean_xor(xorclauses.vars(at), xorclauses.size(at), rhs, vars))
+            continue;
+
+        if (vars.empty()) {
+            if (rhs)
+                return false;
+
+            continue;
+        }
+        xors.push_back(Xor(vars, rhs));
+    }
+
+    for(const Xor& x: foundXors) {
+        bool rhs = x.rhs;
+        if (!clean_xor(x.vars.data(), x.vars.size(), rhs, vars))
+            continue;
+
+        if (vars.empty()) {
+            if (rhs)
+                return false;
+
+            continue;
+        }
+        xors.push_back(Xor(vars, rhs));
+    }
+
+    return true;
+}
+
+/**
+@brief Returns the XORs that are not in the CNF, cleaned, in INTER numbering
+
+Their variables can be neither eliminated nor decomposed, see
+get_native_xor_vars()
+
+@returns FALSE if an XOR turned out to be empty with a right-hand side of 1
+*/
+bool Solver::get_native_xors(XorArena& xors) const
+{
+    xors.clear();
+
+    vector<Var> vars;
+    for(uint32_t at = xorclauses.begin()
+        ; at != xorclauses.end()
+        ; at = xorclauses.next(at)
+    ) {
+        if (!xorclauses.native(at))
+            continue;
+
+        bool rhs = xorclauses.rhs(at);
+        const bool cleaned = clean_xor(xorclauses.vars(at), xorclauses.size(at), rhs, vars);
+        assert(cleaned);
+        (void)cleaned;
+
+        if (vars.empty()) {
+            if (rhs)
+                return false;
+
+            continue;
+        }
+        xors.add(vars, rhs, true);
+    }
+
+    return true;
+}
+
+///Marks the variables of the XORs that are not in the CNF, in INTER numbering
+void Solver::get_native_xor_vars(vector<char>& inXor) const
+{
+    inXor.clear();
+    inXor.resize(nVars(), 0);
+    for(uint32_t at = xorclauses.begin()
+        ; at != xorclauses.end()
+        ; at = xorclauses.next(at)
+    ) {
+        if (!xorclauses.native(at))
+            continue;
+
+        const Var* vars = xorclauses.vars(at);
+        for(uint32_t i = 0; i < xorclauses.size(at); i++) {
+            Lit lit = varReplacer->getLitReplacedWithOuter(Lit(vars[i], false));
+            lit = map_outer_to_inter(lit);
+            if (lit.var() < nVars()) {
+                inXor[lit.var()] = 1;
+            }
+        }
+    }
+}
+
 bool Solver::add_clause_outer(const vector<Lit>& lits)
 {
     check_too_large_variable_number(lits);
@@ -3774,6 +4150,31 @@ bool Solver::add_clause_outer(const vector<Lit>& lits)
     return addClause(lits2);
 }
 
+/**
+@brief Adds many clauses, separated by lit_Undef, in one go
+
+Stops at the first one that makes the system UNSAT.
+*/
+bool Solver::add_clauses_outer(const vector<Lit>& lits)
+{
+    vector<Lit> cl;
+    for(size_t at = 0; at < lits.size(); at++) {
+        cl.clear();
+        for(; lits[at] != lit_Undef; at++) {
+            cl.push_back(lits[at]);
+        }
+        check_too_large_variable_number(cl);
+        for(Lit& lit: cl) {
+            lit = map_to_with_bva(lit);
+        }
+
+        if (!addClause(cl))
+            return false;
+    }
+
+    return okay();
+}
+
 bool Solver::add_xor_clause_outer(const vector<Var>& vars, bool rhs)
 {
     vector<Lit> lits(vars.size());
@@ -3783,7 +4184,12 @@ bool Solver::add_xor_clause_outer(const vector<Var>& vars, bool rhs)
     check_too_large_variable_number(lits);
 
     vector<Lit> lits2 = back_number_from_caller(lits);
-    add_xor_clause_inter(lits, rhs, true);
+
+    //Outer var number -> updated, internal var number
+    if (!addClauseHelper(lits2))
+        return false;
+
+    add_xor_clause_inter(lits2, rhs, true, true);
 
     return ok;
 }
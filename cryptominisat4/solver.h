@@ -30,6 +30,7 @@
 #include "implcache.h"
 #include "propengine.h"
 #include "searcher.h"
+#include "xor.h"
 #include "GitSHA1.h"
 #include <fstream>
 
@@ -54,6 +55,8 @@ class CompFinder;
 class CompHandler;
 class SubsumeStrengthen;
 class SubsumeImplicit;
+class MemBudget;
+class LocalSearch;
 
 class LitReachData {
     public:
@@ -75,14 +78,23 @@ class Solver : public Searcher
         void add_sql_tag(const string& tagname, const string& tag);
         const vector<std::pair<string, string> >& get_sql_tags() const;
         void new_external_var();
+        void new_external_vars(size_t n);
         bool add_clause_outer(const vector<Lit>& lits);
+        bool add_clauses_outer(const vector<Lit>& lits);
         bool add_xor_clause_outer(const vector<Var>& vars, bool rhs);
 
         lbool solve_with_assumptions(const vector<Lit>* _assumptions = NULL);
         void  setNeedToInterrupt();
+        void  unsetNeedToInterrupt();
         lbool modelValue (const Lit p) const;  ///<Found model value for lit
         const vector<lbool>& get_model() const;
         const vector<Lit>& get_final_conflict() const;
+        Lit map_assumption_to_conflict(const Lit lit) const;
+        vector<vector<Lit> > generate_cubes(
+            const vector<Lit>* assumptions
+            , unsigned depth
+            , bool& usedAssumptions
+        );
 
         struct SolveStats
         {
@@ -116,6 +128,7 @@ class Solver : public Searcher
         size_t getNewToReplaceVars() const;
         const Stats& getStats() const;
         uint64_t getNextCleanLimit() const;
+        bool must_interrupt_asap() const;
 
         ///////////////////////////////////
         // State Dumping
@@ -324,6 +337,7 @@ class Solver : public Searcher
             const vector< Lit >& lits
             , bool rhs
             , const bool attach
+            , const bool store = false
         );
 
         lbool simplifyProblem();
@@ -356,6 +370,10 @@ class Solver : public Searcher
         friend class CompHandler;
         friend class TransCache;
         friend class SubsumeImplicit;
+        friend class MemBudget;
+        friend class CubeGenerator;
+        friend class LocalSearch;
+        friend class Gaussian;
         Prober              *prober;
         Simplifier          *simplifier;
         SCCFinder           *sCCFinder;
@@ -365,8 +383,21 @@ class Solver : public Searcher
         VarReplacer         *varReplacer;
         CompHandler         *compHandler;
         SubsumeImplicit     *subsumeImplicit;
+        MemBudget           *memBudget;
+        LocalSearch         *localSearch;
         MTRand              mtrand;           ///< random number generator
 
+        /////////////////////////////
+        //XORs for the search, in OUTER numbering
+        XorArena xorclauses; ///<Added through add_xor_clause()
+        vector<Xor> foundXors; ///<Found in the CNF by XorFinder
+        size_t numNativeXors = 0; ///<XORs in xorclauses that are not in the CNF
+        bool native_xors_allowed() const;
+        bool clean_xor(const Var* vars, uint32_t size, bool& rhs, vector<Var>& out) const;
+        bool get_xors_for_gauss(vector<Xor>& xors) const;
+        bool get_native_xors(XorArena& xors) const;
+        void get_native_xor_vars(vector<char>& inXor) const;
+
         /////////////////////////////
         // Temporary datastructs -- must be cleared before use
         mutable std::vector<Lit> tmpCl;
@@ -394,11 +425,10 @@ class Solver : public Searcher
 
         ///////////////////////////
         // Clause cleaning
-        void reduce_db_and_update_reset_stats(bool lock_clauses_in = true);
+        void reduce_db_and_update_reset_stats(bool lock_clauses_in = true, bool update_limit = true);
         void clearClauseStats(vector<ClOffset>& clauseset);
         CleaningStats reduceDB(bool lock_clauses_in);
         void lock_most_UIP_used_clauses();
-        void lock_in_top_N_uncleaned();
         struct reduceDBStructGlue
         {
             reduceDBStructGlue(ClauseAllocator& _clAllocator) :
@@ -450,19 +480,32 @@ class Solver : public Searcher
             bool operator () (const ClOffset x, const ClOffset y);
         };
         void pre_clean_clause_db(CleaningStats& tmpStats, uint64_t sumConfl);
+        void update_red_tiers(CleaningStats& tmpStats);
+        size_t move_cleanable_red_cls_to_front();
         void real_clean_clause_db(
             CleaningStats& tmpStats
             , uint64_t sumConflicts
             , uint64_t removeNum
         );
-        uint64_t calc_how_many_to_remove();
-        void sort_red_cls_as_required(CleaningStats& tmpStats);
-        void print_best_irred_clauses_if_required() const;
+        uint64_t calc_how_many_to_remove(size_t numLocal, size_t numCleanable);
+        void select_red_cls_to_remove(
+            CleaningStats& tmpStats
+            , size_t numCleanable
+            , uint64_t removeNum
+        );
+        template<class Comp> void select_red_cls_with(
+            Comp comp
+            , size_t numCleanable
+            , uint64_t removeNum
+        );
+        void print_best_irred_clauses_if_required(size_t end) const;
+        void lock_in_top_N_uncleaned(size_t end);
+        uint64_t lastMidTierCheck = 0; ///<sumConflicts() at the last mid tier demotion
 
 
         /////////////////////
         // Data
-        bool                 needToInterrupt;
+        std::atomic<bool>    needToInterrupt;
         uint64_t             nextCleanLimit;
         uint64_t             nextCleanLimitInc;
         void setDecisionVar(const uint32_t var);
@@ -542,6 +585,11 @@ inline uint64_t Solver::getNextCleanLimit() const
     return nextCleanLimit;
 }
 
+inline bool Solver::must_interrupt_asap() const
+{
+    return needToInterrupt;
+}
+
 inline const Solver::SolveStats& Solver::getSolveStats() const
 {
     return solveStats;
@@ -639,7 +687,7 @@ inline bool Solver::find_with_stamp_a_or_b(Lit a, const Lit b) const
 
 inline bool Solver::find_with_cache_a_or_b(Lit a, Lit b, int64_t* limit) const
 {
-    const vector<LitExtra>& cache = solver->implCache[a.toInt()].lits;
+    const TransCache& cache = solver->implCache[a.toInt()];
     *limit -= cache.size();
     for (LitExtra cacheLit: cache) {
         if (cacheLit.getOnlyIrredBin()
@@ -651,7 +699,7 @@ inline bool Solver::find_with_cache_a_or_b(Lit a, Lit b, int64_t* limit) const
 
     std::swap(a,b);
 
-    const vector<LitExtra>& cache2 = solver->implCache[a.toInt()].lits;
+    const TransCache& cache2 = solver->implCache[a.toInt()];
     *limit -= cache2.size();
     for (LitExtra cacheLit: cache) {
         if (cacheLit.getOnlyIrredBin()
@@ -33,6 +33,7 @@ SolverConf::SolverConf() :
         , random_var_freq_increase_for(0)
         , random_var_freq_for_top_N(0)
         , random_picks_from_top_T(20)
+        , branchStrategy(branch_vsids)
         , polarity_mode(polarmode_automatic)
         , do_calc_polarity_first_time(true)
         , do_calc_polarity_every_time(true)
@@ -53,6 +54,10 @@ SolverConf::SolverConf() :
         , min_time_in_db_before_eligible_for_cleaning(10ULL*1000ULL)
         , lock_uip_per_dbclean(500)
         , lock_topclean_per_dbclean(0)
+        , coreTierGlue(2)
+        , midTierGlue(6)
+        , midTierCleanEvery(2)
+        , clauseOrder(clorder_alloc)
         , multiplier_perf_values_after_cl_clean(0)
 
         //Restarting
@@ -63,6 +68,12 @@ SolverConf::SolverConf() :
         , do_blocking_restart(1)
         , blocking_restart_trail_hist_length(5000)
         , blocking_restart_multip(1.4)
+        , doReuseTrail(true)
+
+        //Local search
+        , doLocalSearch(false)
+        , localSearchEvery(50)
+        , localSearchTimeLimitM(50)
 
         //Clause minimisation
         , doRecursiveMinim (true)
@@ -146,6 +157,12 @@ SolverConf::SolverConf() :
         , useCacheWhenFindingXors(false)
         , doEchelonizeXOR  (true)
         , maxXORMatrix     (10LL*1000LL*1000LL)
+        , doGauss          (false)
+        , gaussMinMatrixRows(2)
+        , gaussMaxMatrixRows(3000)
+        , gaussMaxMatrixes (10)
+        , doNativeXor      (false)
+        , nativeXorMinSize (5)
 
         //Var-replacer
         , doFindAndReplaceEqLits(true)
@@ -155,6 +172,9 @@ SolverConf::SolverConf() :
         //Propagation & search
         , doLHBR           (false)
         , propBinFirst     (false)
+        , doSIMDWatchSearch(true)
+        , doChronoBT       (false)
+        , chronoBTJump     (100)
         , dominPickFreq    (400)
         , polarity_flip_min_depth(50)
         , polarity_flip_frequency_multiplier(0)
@@ -176,6 +196,8 @@ SolverConf::SolverConf() :
         //Memory savings
         , doRenumberVars   (true)
         , doSaveMem        (true)
+        , maxMemMB         (0)
+        , memBudgetHighWater(0.9)
 
         //Component finding
         , doFindComps     (false)
@@ -183,6 +205,19 @@ SolverConf::SolverConf() :
         , handlerFromSimpNum (0)
         , compVarLimit      (1ULL*1000ULL*1000ULL)
         , compFindLimitMega (500)
+        , compNumThreads    (0)
+
+        //Clause sharing
+        , doShareClauses   (true)
+        , shareMaxSize     (3)
+        , shareMaxGlue     (2)
+        , shareRingSize    (1U << 20)
+
+        //Cube and conquer
+        , doCubeAndConquer (false)
+        , cubeDepth        (0)
+        , cubeCandidates   (100)
+        , cubeTimeLimitM   (200)
 
         //Misc optimisations
         , doExtBinSubs     (true)
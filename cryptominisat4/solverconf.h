@@ -85,6 +85,60 @@ inline std::string getNameOfElimStrategy(ElimStrategy strategy)
     }
 }
 
+enum ClauseOrder {
+    clorder_alloc   ///<Keep the allocation order
+    , clorder_watch ///<Clauses watched by the same literal next to each other
+    , clorder_prop  ///<Clauses that propagate the most first
+};
+
+inline std::string getNameOfClauseOrder(ClauseOrder order)
+{
+    switch(order)
+    {
+        case clorder_alloc:
+            return "alloc";
+
+        case clorder_watch:
+            return "watch";
+
+        case clorder_prop:
+            return "prop";
+
+        default:
+            std::exit(-1);
+            //assert(false);
+
+        return "";
+    }
+}
+
+enum BranchStrategy {
+    branch_vsids        ///<Activity heap
+    , branch_vmtf       ///<Variable-move-to-front queue
+    , branch_alternate  ///<Switch between the two at every search round
+};
+
+inline std::string getNameOfBranchStrategy(BranchStrategy strategy)
+{
+    switch(strategy)
+    {
+        case branch_vsids:
+            return "vsids";
+
+        case branch_vmtf:
+            return "vmtf";
+
+        case branch_alternate:
+            return "alternate";
+
+        default:
+            std::exit(-1);
+            //assert(false);
+
+        return "";
+    }
+}
+
 class SolverConf
 {
     public:
@@ -99,6 +153,7 @@ class SolverConf
         unsigned random_var_freq_increase_for;
         double random_var_freq_for_top_N;
         unsigned random_picks_from_top_T;
+        BranchStrategy branchStrategy;
         PolarityMode polarity_mode;
         int do_calc_polarity_first_time;
         int do_calc_polarity_every_time;
@@ -119,6 +174,10 @@ class SolverConf
         unsigned  min_time_in_db_before_eligible_for_cleaning;
         size_t   lock_uip_per_dbclean;
         size_t   lock_topclean_per_dbclean;
+        unsigned  coreTierGlue; ///<Redundant clauses with at most this glue are never cleaned
+        unsigned  midTierGlue; ///<Redundant clauses with at most this glue are kept while used
+        unsigned  midTierCleanEvery; ///<Demote unused mid tier clauses every this many reduceDB
+        ClauseOrder clauseOrder; ///<Order of the clauses in memory after consolidation
         double   multiplier_perf_values_after_cl_clean;
 
         //For restarting
@@ -129,6 +188,12 @@ class SolverConf
         int       do_blocking_restart;
         unsigned blocking_restart_trail_hist_length;
         double   blocking_restart_multip;
+        int      doReuseTrail; ///<On restart, keep the decision levels that would be rebuilt the same way
+
+        //Local search
+        int      doLocalSearch;
+        unsigned localSearchEvery; ///<Run local search before every this many restarts
+        uint64_t localSearchTimeLimitM; ///<Mems (in millions) per local search call
 
         //Clause minimisation
         int doRecursiveMinim;
@@ -212,6 +277,12 @@ class SolverConf
         int      useCacheWhenFindingXors;
         int      doEchelonizeXOR;
         unsigned long long  maxXORMatrix;
+        int      doGauss; ///<Propagate blocks of XORs with Gauss-Jordan elimination during search
+        unsigned gaussMinMatrixRows;
+        unsigned gaussMaxMatrixRows;
+        unsigned gaussMaxMatrixes;
+        int      doNativeXor; ///<Keep long XORs out of the CNF, and propagate them natively
+        unsigned nativeXorMinSize;
 
         //Var-replacement
         int doFindAndReplaceEqLits;
@@ -221,6 +292,9 @@ class SolverConf
         //Propagation & searching
         int      doLHBR; ///<Do lazy hyper-binary resolution
         int      propBinFirst;
+        int      doSIMDWatchSearch; ///<Use AVX2, if available, to find new watches in long clauses
+        int      doChronoBT; ///<Backtrack chronologically when the jump is long
+        unsigned chronoBTJump; ///<Only backtrack chronologically if the jump would be at least this long
         unsigned  dominPickFreq;
         unsigned  polarity_flip_min_depth;
         unsigned  polarity_flip_frequency_multiplier;
@@ -242,6 +316,8 @@ class SolverConf
         //Memory savings
         int       doRenumberVars;
         int       doSaveMem;
+        unsigned long long maxMemMB; ///<Memory budget in MB, 0 means no budget
+        double    memBudgetHighWater; ///<Start shedding memory above this fraction of the budget
 
         //Component handling
         int       doFindComps;
@@ -249,7 +325,20 @@ class SolverConf
         unsigned  handlerFromSimpNum;
         size_t    compVarLimit;
         unsigned long long  compFindLimitMega;
+        unsigned  compNumThreads; ///<Solve this many components in parallel. 0 means one per core
+
+
+        //Clause sharing between threads
+        int       doShareClauses; ///<Exchange learnt clauses between the threads of a portfolio
+        unsigned  shareMaxSize; ///<Share learnt clauses of at most this size...
+        unsigned  shareMaxGlue; ///<...or of at most this glue
+        unsigned  shareRingSize; ///<Size (in literals) of each thread's outgoing clause ring
 
+        //Cube and conquer
+        int       doCubeAndConquer; ///<Split the problem into cubes that threads solve, instead of a portfolio
+        unsigned  cubeDepth; ///<Generate at most 2^cubeDepth cubes. 0 means decide based on number of threads
+        unsigned  cubeCandidates; ///<Number of variables to look ahead on at every split
+        unsigned long long cubeTimeLimitM; ///<Bogo-props (in millions) to spend on cube generation
 
         //Misc Optimisations
         int      doExtBinSubs;
@@ -20,54 +20,112 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #ifndef STREAMBUFFER_H
 #define STREAMBUFFER_H
 
-#define CHUNK_LIMIT 1048576
-
-#ifdef USE_ZLIB
-#include <zlib.h>
-#endif
 #include <stdio.h>
+#include <stddef.h>
+#include "inputreader.h"
 
-class StreamBuffer
+#ifdef USE_MMAP_INPUT
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+@brief Read-only mapping of a whole input file
+
+open() fails for anything that cannot be mapped (pipes, empty files). The
+caller then reads the input through an InputReader.
+*/
+class MappedFile
 {
-    #ifdef USE_ZLIB
-    gzFile  in;
-    void assureLookahead() {
-        if (pos >= size) {
-            pos  = 0;
-            #ifdef VERBOSE_DEBUG
-            printf("buf = %08X\n", buf);
-            printf("sizeof(buf) = %u\n", sizeof(buf));
-            #endif //VERBOSE_DEBUG
-            size = gzread(in, buf, sizeof(buf));
+public:
+    MappedFile() {}
+    ~MappedFile() {
+        close();
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const char* fname) {
+        const int fd = ::open(fname, O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+            ::close(fd);
+            return false;
+        }
+
+        void* m = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (m == MAP_FAILED)
+            return false;
+
+        #ifdef MADV_SEQUENTIAL
+        madvise(m, st.st_size, MADV_SEQUENTIAL);
+        #endif
+        mem = (const char*)m;
+        len = st.st_size;
+        return true;
+    }
+
+    void close() {
+        if (mem != NULL) {
+            munmap((void*)mem, len);
         }
+        mem = NULL;
+        len = 0;
+    }
+
+    const char* data() const {
+        return mem;
     }
-    #else
-    FILE *  in;
+
+    size_t size() const {
+        return len;
+    }
+
+private:
+    const char* mem = NULL;
+    size_t len = 0;
+};
+#endif //USE_MMAP_INPUT
+
+class StreamBuffer
+{
+    InputReader* in;
     void assureLookahead() {
-        if (pos >= size) {
+        if (pos >= size && in != NULL) {
             pos  = 0;
-            #ifdef VERBOSE_DEBUG
-            printf("buf = %08X\n", buf);
-            printf("sizeof(buf) = %u\n", sizeof(buf));
-            #endif //VERBOSE_DEBUG
-            size = fread(buf, 1, sizeof(buf), in);
+            size = in->next(buf);
         }
     }
-    #endif
-    char    buf[CHUNK_LIMIT];
-    int     pos;
-    int     size;
+    const char* buf;
+    size_t      pos;
+    size_t      size;
 
 public:
-    #ifdef USE_ZLIB
-    StreamBuffer(gzFile i) : in(i), pos(0), size(0) {
-        assureLookahead();
-    }
-    #else
-    StreamBuffer(FILE * i) : in(i), pos(0), size(0) {
+    //Pieces are handed over by the reader, nothing is copied
+    StreamBuffer(InputReader* i) :
+        in(i)
+        , buf(NULL)
+        , pos(0)
+        , size(0)
+    {
         assureLookahead();
     }
-    #endif
+
+    //Zero-copy: the data is one buffer, nothing is ever refilled
+    StreamBuffer(const char* data, const size_t len) :
+        in(NULL)
+        , buf(data)
+        , pos(0)
+        , size(len)
+    {}
+
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
 
     int  operator *  () {
         return (pos >= size) ? EOF : buf[pos];
@@ -76,6 +134,19 @@ public:
         pos++;
         assureLookahead();
     }
+
+    //Contiguous view of what is buffered. Callers may parse straight from
+    //it and then skip what they have used with advance()
+    const char* cur() const {
+        return buf + pos;
+    }
+    size_t avail() const {
+        return (pos >= size) ? 0 : size - pos;
+    }
+    void advance(const size_t n) {
+        pos += n;
+        assureLookahead();
+    }
 };
 
 #endif //STREAMBUFFER_H
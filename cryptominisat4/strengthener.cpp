@@ -203,8 +203,8 @@ bool Strengthener::str_and_sub_clause_with_cache(const Lit lit)
     if (solver->conf.doCache
         && seen[lit.toInt()] //We haven't yet removed this literal from the clause
      ) {
-        timeAvailable -= 2*(long)solver->implCache[lit.toInt()].lits.size();
-        for (const LitExtra elit: solver->implCache[lit.toInt()].lits) {
+        timeAvailable -= 2*(long)solver->implCache[lit.toInt()].size();
+        for (const LitExtra elit: solver->implCache[lit.toInt()]) {
              if (seen[(~(elit.getLit())).toInt()]) {
                 seen[(~(elit.getLit())).toInt()] = 0;
                 thisRemLitCache++;
@@ -369,7 +369,7 @@ bool Strengthener::shorten_clause_with_cache_watch_stamp(
     cache_based_data.remLitBinTri += thisRemLitBinTri;
     tmpStats.shrinked++;
     timeAvailable -= (long)lits.size()*2 + 50;
-    Clause* c2 = solver->addClauseInt(lits, cl.red(), cl.stats);
+    Clause* c2 = solver->addClauseInt(lits, cl.red(), solver->clAllocator.getStats(cl));
     if (c2 != NULL) {
         solver->detachClause(offset);
         solver->clAllocator.clauseFree(offset);
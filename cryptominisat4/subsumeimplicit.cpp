@@ -103,12 +103,12 @@ void SubsumeImplicit::try_subsume_tri(
         && solver->conf.otfHyperbin
     ) {
         for(size_t i = 0; i < tmplits.size() && !remove; i++) {
-            timeAvailable -= solver->implCache[lit.toInt()].lits.size();
-            for (vector<LitExtra>::const_iterator
-                it2 = solver->implCache[tmplits[i].toInt()].lits.begin()
-                , end2 = solver->implCache[tmplits[i].toInt()].lits.end()
+            timeAvailable -= solver->implCache[lit.toInt()].size();
+            for (TransCache::const_iterator
+                it2 = solver->implCache[tmplits[i].toInt()].begin()
+                , end2 = solver->implCache[tmplits[i].toInt()].end()
                 ; it2 != end2
-                ; it2++
+                ; ++it2
             ) {
                 if ((   it2->getLit() == tmplits[0]
                         || it2->getLit() == tmplits[1]
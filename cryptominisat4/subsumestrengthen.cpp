@@ -49,7 +49,8 @@ uint32_t SubsumeStrengthen::subsume0(ClOffset offset)
     }
 
     //Combine stats
-    cl.combineStats(ret.stats);
+    ClauseStats& stats = solver->clAllocator.getStats(cl);
+    stats = ClauseStats::combineStats(stats, ret.stats);
 
     return ret.numSubsumed;
 }
@@ -87,7 +88,7 @@ SubsumeStrengthen::Sub0Ret SubsumeStrengthen::subsume0AndUnlink(
         #endif
 
         //Combine stats
-        ret.stats = ClauseStats::combineStats(tmp->stats, ret.stats);
+        ret.stats = ClauseStats::combineStats(solver->clAllocator.getStats(*tmp), ret.stats);
 
         //At least one is irred. Indicate this to caller.
         if (!tmp->red())
@@ -157,7 +158,8 @@ SubsumeStrengthen::Sub1Ret SubsumeStrengthen::subsume1(const ClOffset offset)
             }
 
             //Update stats
-            cl.combineStats(cl2.stats);
+            ClauseStats& stats = solver->clAllocator.getStats(cl);
+            stats = ClauseStats::combineStats(stats, solver->clAllocator.getStats(cl2));
 
             simplifier->unlinkClause(offset2);
             ret.sub++;
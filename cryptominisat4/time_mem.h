@@ -78,9 +78,16 @@ static inline int memReadStat(int field)
     fclose(in);
     return value;
 }
+///Resident memory: reserved but unused ranges, such as the clause arenas, don't count
 static inline uint64_t memUsedTotal()
 {
-    return (uint64_t)memReadStat(0) * (uint64_t)getpagesize();
+    return (uint64_t)memReadStat(1) * (uint64_t)getpagesize();
+}
+static inline uint64_t memUsedPeak()
+{
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return (uint64_t)ru.ru_maxrss*1024ULL;
 }
 #elif defined(__FreeBSD__)
 #include <sys/types.h>
@@ -90,11 +97,19 @@ inline uint64_t memUsedTotal(void)
     getrusage(RUSAGE_SELF, &ru);
     return ru.ru_maxrss*1024;
 }
+inline uint64_t memUsedPeak(void)
+{
+    return memUsedTotal();
+}
 #else //Windows
 static inline size_t memUsedTotal()
 {
     return 0;
 }
+static inline size_t memUsedPeak()
+{
+    return 0;
+}
 #endif
 
 #endif //TIME_MEM_H
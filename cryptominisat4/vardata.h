@@ -8,6 +8,13 @@ namespace CMSat
 {
 using namespace CMSat;
 
+/**
+@brief Per-variable data not needed by propagation and conflict analysis
+
+The level and reason of a variable, which conflict analysis reads for every
+literal it looks at, are kept in the dense CNF::varLevel and CNF::varReason
+arrays instead, so that they don't drag the rest of this into the CPU cache.
+*/
 struct VarData
 {
     #ifdef STATS_NEEDED_EXTRA
@@ -52,23 +59,15 @@ struct VarData
     #endif
 
     VarData() :
-        level(std::numeric_limits< uint32_t >::max())
-        , reason(PropBy())
-        , removed(Removed::none)
+        removed(Removed::none)
         , polarity(false)
         , is_decision(true)
         , is_bva(false)
     {}
 
-    ///contains the decision level at which the assignment was made.
-    uint32_t level;
-
     //Used during hyper-bin and trans-reduction for speed
     uint32_t depth;
 
-    //Reason this got propagated. NULL means decision/toplevel
-    PropBy reason;
-
     ///Whether var has been eliminated (var-elim, different component, etc.)
     Removed removed;
 
@@ -683,7 +683,7 @@ void VarReplacer::set_sub_var_during_solution_extension(Var var, const Var sub_v
             || solver->varData[sub_var_inter].removed == Removed::replaced
         );
         assert(solver->model[sub_var] == l_Undef
-            || solver->varData[sub_var_inter].level == 0
+            || solver->varLevel[sub_var_inter] == 0
             || solver->varData[sub_var_inter].removed == Removed::queued_replacer
         );
         assert(solver->model[sub_var] == to_set);
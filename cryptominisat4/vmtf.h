@@ -0,0 +1,197 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.0 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+#ifndef VMTF_H
+#define VMTF_H
+
+#include <vector>
+#include <cstdint>
+#include <cassert>
+#include "solvertypesmini.h"
+
+namespace CMSat {
+
+/**
+@brief Variable-move-to-front decision queue
+
+All variables are in a doubly linked list, ordered by when they were last
+bumped: the most recently bumped one is the last. Bumping a variable just
+moves it to the end, so it costs the same no matter how many variables there
+are, unlike percolating it up in a heap.
+
+Every variable remembers when it was bumped, so the queue can tell which of
+two variables comes first without walking it. The search starts from 'searchFrom',
+and every variable after it is assigned. Unassigning a variable that was
+bumped later than 'searchFrom' moves 'searchFrom' to it.
+*/
+class VMTF
+{
+public:
+    ///Puts the variables into the queue in the given order, the last one first to pick
+    void build(const std::vector<Var>& order)
+    {
+        links.assign(order.size(), Link());
+        btab.assign(order.size(), 0);
+        first = last = searchFrom = var_Undef;
+        stamp = 0;
+        for(const Var var: order) {
+            enqueue(var);
+        }
+        searchFrom = last;
+    }
+
+    void clear()
+    {
+        std::vector<Link>().swap(links);
+        std::vector<uint64_t>().swap(btab);
+        first = last = searchFrom = var_Undef;
+        stamp = 0;
+    }
+
+    bool empty() const
+    {
+        return links.empty();
+    }
+
+    ///A new variable is put at the end, as if it had just been bumped
+    void new_var(const Var var)
+    {
+        assert(var == links.size());
+        links.push_back(Link());
+        btab.push_back(0);
+        enqueue(var);
+        searchFrom = var;
+    }
+
+    ///Moves the variable to the end of the queue
+    void bump(const Var var, const bool unassigned)
+    {
+        if (var != last) {
+            dequeue(var);
+            enqueue(var);
+        } else {
+            btab[var] = ++stamp;
+        }
+
+        if (unassigned || searchFrom == var_Undef)
+            searchFrom = var;
+    }
+
+    ///Must be called when the variable gets unassigned
+    void unassigned(const Var var)
+    {
+        if (var < btab.size()
+            && (searchFrom == var_Undef || btab[var] > btab[searchFrom])
+        ) {
+            searchFrom = var;
+        }
+    }
+
+    ///The last variable for which 'skip' is false, starting from searchFrom
+    template<class F>
+    Var next(const F& skip)
+    {
+        Var var = searchFrom;
+        while(var != var_Undef && skip(var)) {
+            var = links[var].prev;
+        }
+
+        //Everything after it is skipped, so searching can start here next time
+        if (var != var_Undef)
+            searchFrom = var;
+
+        return var;
+    }
+
+    ///The variable 'num' places before searchFrom, or var_Undef if there is none
+    Var before_next(uint32_t num) const
+    {
+        Var var = searchFrom;
+        while(var != var_Undef && num > 0) {
+            var = links[var].prev;
+            num--;
+        }
+
+        return var;
+    }
+
+    uint64_t bumped(const Var var) const
+    {
+        return btab[var];
+    }
+
+    size_t memUsed() const
+    {
+        return links.capacity()*sizeof(Link)
+            + btab.capacity()*sizeof(uint64_t);
+    }
+
+private:
+    struct Link
+    {
+        Var prev = var_Undef;
+        Var next = var_Undef;
+    };
+
+    void dequeue(const Var var)
+    {
+        Link& l = links[var];
+        if (searchFrom == var)
+            searchFrom = (l.prev != var_Undef) ? l.prev : l.next;
+
+        if (l.prev != var_Undef)
+            links[l.prev].next = l.next;
+        else
+            first = l.next;
+
+        if (l.next != var_Undef)
+            links[l.next].prev = l.prev;
+        else
+            last = l.prev;
+
+        l.prev = l.next = var_Undef;
+    }
+
+    void enqueue(const Var var)
+    {
+        Link& l = links[var];
+        l.prev = last;
+        l.next = var_Undef;
+        if (last != var_Undef)
+            links[last].next = var;
+        else
+            first = var;
+
+        last = var;
+        btab[var] = ++stamp;
+    }
+
+    std::vector<Link> links;
+    std::vector<uint64_t> btab; ///<When the variable was last bumped
+    Var first = var_Undef;
+    Var last = var_Undef;
+    Var searchFrom = var_Undef;
+    uint64_t stamp = 0;
+};
+
+} //end namespace
+
+#endif //VMTF_H
@@ -1,6 +1,10 @@
 #ifndef __WATCHARRAY_H__
 #define __WATCHARRAY_H__
 
+#ifdef USE_WATCH_ARENA
+#include "watcharray_handrolled.h"
+#else
+
 #include "watched.h"
 #include <vector>
 
@@ -311,4 +315,6 @@ inline void swap(watch_subarray a, watch_subarray b)
 
 } //End of namespace
 
+#endif //USE_WATCH_ARENA
+
 #endif //__WATCHARRAY_H__
@@ -1,67 +1,77 @@
 #include "watcharray.h"
 #include <algorithm>
+#include <iomanip>
 using namespace CMSat;
 
+/**
+@brief Copies all watchlists into a single new chunk, in literal order
+
+Every list gets a slot of the next power of two above its size, so it can
+grow a little before it has to be moved again. Empty lists give up their
+slot. Must not be called while any pointer into the watchlists is held.
+*/
 void watch_array::consolidate()
 {
-    size_t total_needed = total_needed_during_consolidate();
+    const size_t total_needed = total_needed_during_consolidate();
 
     vector<Mem> newmems;
-    size_t at_watches = 0;
-    //size_t last_needed = 0;
-    while(total_needed > 0) {
+    if (total_needed > 0) {
         Mem newmem;
-        size_t needed = std::min<size_t>(total_needed, WATCH_MAX_SIZE_ONE_ALLOC);
-        assert(needed > 0);
-
-        //If last one was larger than this, let's take the last one
-        //needed = std::max<size_t>(needed, last_needed/2);
-        //last_needed = needed;
-        total_needed -= needed;
-
-        newmem.alloc = needed;
+        newmem.alloc = std::min<size_t>(
+            std::max<size_t>(total_needed*1.2, WATCH_MIN_SIZE_ONE_ALLOC_FIRST)
+            , WATCH_MAX_SIZE_ONE_ALLOC
+        );
         newmem.base_ptr = (Watched*)malloc(newmem.alloc*sizeof(Watched));
-        for(; at_watches < watches.size(); at_watches++) {
-            //Not used
-            if (watches[at_watches].size == 0) {
-                watches[at_watches] = Elem();
-                continue;
-            }
+        if (newmem.base_ptr == NULL) {
+            throw std::bad_alloc();
+        }
+        newmems.push_back(newmem);
+    }
 
-            Elem& ws = watches[at_watches];
+    for(Elem& ws: watches) {
+        //Not used
+        if (ws.size == 0) {
+            ws = Elem();
+            continue;
+        }
 
-            //Allow for some space to breathe
-            size_t toalloc = extra_space_during_consolidate(ws.size);
+        //Allow for some space to breathe
+        const size_t toalloc = extra_space_during_consolidate(ws.size);
 
-            //Does not fit into this 'newmem'
-            if (newmem.next_space_offset + toalloc > newmem.alloc) {
-                break;
+        //Does not fit into the current chunk, only happens for huge instances
+        assert(toalloc <= WATCH_MAX_SIZE_ONE_ALLOC);
+        if (newmems.back().next_space_offset + toalloc > newmems.back().alloc) {
+            Mem newmem;
+            newmem.alloc = WATCH_MAX_SIZE_ONE_ALLOC;
+            newmem.base_ptr = (Watched*)malloc(newmem.alloc*sizeof(Watched));
+            if (newmem.base_ptr == NULL) {
+                throw std::bad_alloc();
             }
-
-            ws.alloc = toalloc;
-            Watched* orig_ptr = mems[ws.num].base_ptr + ws.offset;
-            Watched* new_ptr = newmem.base_ptr + newmem.next_space_offset;
-            memmove(new_ptr, orig_ptr, ws.size * sizeof(Watched));
-            ws.num = newmems.size();
-            ws.offset = newmem.next_space_offset;
-            //ws.accessed = 0;
-            newmem.next_space_offset += ws.alloc;
+            newmems.push_back(newmem);
         }
-        newmems.push_back(newmem);
+        Mem& newmem = newmems.back();
+
+        Watched* orig_ptr = mems[ws.num].base_ptr + ws.offset;
+        Watched* new_ptr = newmem.base_ptr + newmem.next_space_offset;
+        memcpy(new_ptr, orig_ptr, ws.size * sizeof(Watched));
+        ws.alloc = toalloc;
+        ws.num = newmems.size()-1;
+        ws.offset = newmem.next_space_offset;
+        newmem.next_space_offset += ws.alloc;
     }
-    assert(at_watches == watches.size());
-    assert(total_needed == 0);
 
     for(size_t i = 0; i < mems.size(); i++) {
         free(mems[i].base_ptr);
     }
 
-    mems = newmems;
+    mems.swap(newmems);
     for(auto& mem: free_mem) {
         mem.clear();
+        mem.shrink_to_fit();
     }
     free_mem_used = 0;
     free_mem_not_used = 0;
+    grown_in_place = 0;
 }
 
 void watch_array::print_stat(bool detailed) const
@@ -74,27 +84,23 @@ void watch_array::print_stat(bool detailed) const
     << std::fixed << std::setprecision(2)
     << stats_line_percent(free_mem_used, free_mem_not_used+free_mem_used)
     << "%)"
+    << " grown in place: " << grown_in_place
     << endl;
 
     if (detailed) {
         for(size_t i = 0; i < mems.size(); i++) {
             const Mem& mem = mems[i];
             cout
-            << " c [watch] mem " << i
+            << "c [watch] mem " << i
             << " alloc: " << mem.alloc
             << " next_space_offset: " << mem.next_space_offset
             << " base_ptr: " << mem.base_ptr
             << endl;
         }
 
-            cout << "c [watch] free stats:" << endl;
-            for(size_t i = 0; i < free_mem.size(); i++)
-            {
-                cout << "c [watch] ->free_mem[" << i << "]: " << free_mem[i].size() << endl;
-            }
+        cout << "c [watch] free stats:" << endl;
+        for(size_t i = 0; i < free_mem.size(); i++) {
+            cout << "c [watch] ->free_mem[" << i << "]: " << free_mem[i].size() << endl;
         }
-
-    /*for(size_t i = 0; i < watches.size(); i++) {
-        cout << "ws[" << i << "] accessed: " << watches[i].accessed << " size: " << watches[i].size << endl;
-    }*/
-}
\ No newline at end of file
+    }
+}
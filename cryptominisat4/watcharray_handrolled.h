@@ -1,7 +1,8 @@
-#ifndef __WATCHARRAY_H__
-#define __WATCHARRAY_H__
+#ifndef __WATCHARRAY_HANDROLLED_H__
+#define __WATCHARRAY_HANDROLLED_H__
 
 #include <stdlib.h>
+#include <string.h>
 #include "watched.h"
 #include <vector>
 
@@ -9,6 +10,18 @@ namespace CMSat {
 using namespace CMSat;
 using std::vector;
 
+/**
+@brief Watchlists stored in a few large chunks of memory instead of one heap
+vector per literal
+
+Chunks are never moved or freed while searching, because the propagation
+holds pointers into the watchlist it is iterating while it pushes to other
+watchlists. Instead, every watchlist has a power-of-two sized slot. When
+the slot is full, it is grown in place if it is at the end of its chunk,
+and otherwise it is moved to a fresh slot and the old one is put on a
+per-size free list. consolidate() copies everything into one new chunk,
+in literal order, and releases the old chunks.
+*/
 struct watch_array;
 
 struct Elem
@@ -22,7 +35,6 @@ struct Elem
     uint32_t offset:24;
     uint32_t size = 0;
     uint32_t alloc = 0;
-    //uint32_t accessed = 0;
 
     void print_stat() const
     {
@@ -69,6 +81,7 @@ struct watch_subarray
     {}
 
     Watched& operator[](const uint32_t at);
+    Watched& at(const uint32_t at);
     void clear();
     uint32_t size() const;
     bool empty() const;
@@ -101,6 +114,7 @@ struct watch_subarray_const
 
     void print_stat() const;
     const Watched& operator[](const uint32_t at) const;
+    const Watched& at(const uint32_t at) const;
     uint32_t size() const;
     bool empty() const;
     const Watched* begin() const;
@@ -110,27 +124,22 @@ struct watch_subarray_const
 
 struct watch_array
 {
-    const static size_t WATCH_MIN_SIZE_ONE_ALLOC_FIRST = 1ULL*1000ULL*1000ULL;
-    const static size_t WATCH_MIN_SIZE_ONE_ALLOC_LATER = 50ULL*1000ULL*1000ULL;
+    const static size_t WATCH_MIN_SIZE_ONE_ALLOC_FIRST = 1ULL<<16;
+    const static size_t WATCH_MIN_SIZE_ONE_ALLOC_LATER = 1ULL<<20;
     const static size_t WATCH_MAX_SIZE_ONE_ALLOC = (1ULL<<24)-1;
+    const static size_t WATCH_MAX_NUM_MEMS = 255;
 
     vector<Elem> watches;
     vector<Mem> mems;
     size_t free_mem_used = 0;
     size_t free_mem_not_used = 0;
+    size_t grown_in_place = 0;
 
-    //at least 2**N elements in there
+    //free_mem[N] holds slots of exactly 2**(N+1) elements
     vector<vector<OffsAndNum> > free_mem;
 
     watch_array()
     {
-        //We need at least 1
-        Mem new_mem;
-        size_t elems = WATCH_MIN_SIZE_ONE_ALLOC_FIRST;
-        new_mem.base_ptr = (Watched*)malloc(elems*sizeof(Watched));
-        new_mem.alloc = elems;
-        mems.push_back(new_mem);
-
         free_mem.resize(20);
     }
 
@@ -141,25 +150,38 @@ struct watch_array
         }
     }
 
+    watch_array(const watch_array&) = delete;
+    watch_array& operator=(const watch_array&) = delete;
+
     uint32_t get_suitable_base(uint32_t elems)
     {
-        //print_stat();
-
-        assert(mems.size() > 0);
-        size_t last_alloc = mems[0].alloc;
-        for(size_t i = 0; i < mems.size(); i++) {
-            if (mems[i].next_space_offset + elems < mems[i].alloc) {
-                return i;
-            }
-            last_alloc = mems[i].alloc;
+        //Only the last chunk can have space left at its end, the others
+        //were abandoned when the next one was allocated
+        if (!mems.empty()
+            && (size_t)mems.back().next_space_offset + elems <= mems.back().alloc
+        ) {
+            return mems.size()-1;
+        }
+        if (mems.size() >= WATCH_MAX_NUM_MEMS) {
+            std::cerr
+            << "ERROR: Watchlist arena ran out of chunks."
+            << " Consolidate more often or use the vector backend"
+            << endl;
+            std::exit(-1);
         }
-        assert(mems.size() < 255);
 
         Mem new_mem;
-        new_mem.alloc = std::max<size_t>(3*last_alloc, WATCH_MIN_SIZE_ONE_ALLOC_LATER);
-        new_mem.alloc = std::min<size_t>(3*last_alloc, WATCH_MAX_SIZE_ONE_ALLOC);
+        size_t alloc = WATCH_MIN_SIZE_ONE_ALLOC_FIRST;
+        if (!mems.empty()) {
+            alloc = std::max<size_t>(3ULL*mems.back().alloc, WATCH_MIN_SIZE_ONE_ALLOC_LATER);
+        }
+        alloc = std::min<size_t>(alloc, WATCH_MAX_SIZE_ONE_ALLOC);
+        assert(elems <= alloc);
+        new_mem.alloc = alloc;
         new_mem.base_ptr = (Watched*)malloc(new_mem.alloc*sizeof(Watched));
-        assert(new_mem.base_ptr != NULL);
+        if (new_mem.base_ptr == NULL) {
+            throw std::bad_alloc();
+        }
         mems.push_back(new_mem);
         return mems.size()-1;
     }
@@ -188,7 +210,7 @@ struct watch_array
 
         uint32_t num = get_suitable_base(elems);
         Mem& mem = mems[num];
-        assert(mem.next_space_offset + elems < mem.alloc);
+        assert((size_t)mem.next_space_offset + elems <= mem.alloc);
 
         uint32_t off_to_ret = mem.next_space_offset;
         mem.next_space_offset += elems;
@@ -197,9 +219,28 @@ struct watch_array
         return toret;
     }
 
+    ///Grows the slot without moving it if it is the last one in its chunk
+    bool grow_in_place(Elem& elem, uint32_t new_alloc)
+    {
+        if (elem.alloc == 0)
+            return false;
+
+        Mem& mem = mems[elem.num];
+        if (elem.offset + elem.alloc != mem.next_space_offset
+            || (size_t)elem.offset + new_alloc > mem.alloc
+        ) {
+            return false;
+        }
+
+        mem.next_space_offset = elem.offset + new_alloc;
+        elem.alloc = new_alloc;
+        grown_in_place++;
+        return true;
+    }
+
     size_t extra_space_during_consolidate(size_t orig_size)
     {
-        if (orig_size == 1)
+        if (orig_size <= 2)
             return 2;
 
         unsigned bucket = get_bucket(orig_size);
@@ -217,8 +258,6 @@ struct watch_array
                 total_needed += extra_space_during_consolidate(watches[i].size);
             }
         }
-        total_needed *= 1.2;
-        total_needed = std::max<size_t>(total_needed, WATCH_MIN_SIZE_ONE_ALLOC_FIRST);
 
         return total_needed;
     }
@@ -228,16 +267,15 @@ struct watch_array
 
     unsigned get_bucket(unsigned size)
     {
-        //assert(size >= 2);
+        assert(size >= 2);
         int at = ((int)((sizeof(unsigned)*8))-__builtin_clz(size))-2;
-        //assert(at >= 0);
         return at;
     }
 
     void delete_offset(uint32_t num, uint32_t offs, uint32_t size)
     {
         size_t bucket = get_bucket(size);
-        //assert(size == 2U<<bucket);
+        assert(size == 2U<<bucket);
 
         if (bucket >= free_mem.size()) {
             return;
@@ -260,23 +298,55 @@ struct watch_array
         size_t total = 0;
         total += watches.capacity() * sizeof(Elem);
         total += mems.capacity() * sizeof(Mem);
+        for(const auto& bucket: free_mem) {
+            total += bucket.capacity() * sizeof(OffsAndNum);
+        }
         return total;
     }
 
+    size_t memUsed() const
+    {
+        return mem_used_alloc() + mem_used_array();
+    }
+
     watch_subarray operator[](size_t at)
     {
         assert(watches.size() > at);
         return watch_subarray(watches.begin() + at, this);
     }
 
+    watch_subarray at(size_t pos)
+    {
+        return watch_subarray(watches.begin() + check_at(pos), this);
+    }
+
     watch_subarray_const operator[](size_t at) const
     {
         assert(watches.size() > at);
         return watch_subarray_const(watches.begin() + at, this);
     }
 
+    watch_subarray_const at(size_t pos) const
+    {
+        return watch_subarray_const(watches.begin() + check_at(pos), this);
+    }
+
+    size_t check_at(size_t pos) const
+    {
+        if (pos >= watches.size()) {
+            throw std::out_of_range("watch_array::at");
+        }
+        return pos;
+    }
+
     void resize(const size_t new_size)
     {
+        //Release the slots of the lists that are cut off
+        for(size_t i = new_size; i < watches.size(); i++) {
+            if (watches[i].alloc != 0) {
+                delete_offset(watches[i].num, watches[i].offset, watches[i].alloc);
+            }
+        }
         watches.resize(new_size);
     }
 
@@ -292,7 +362,9 @@ struct watch_array
 
     void prefetch(const size_t at) const
     {
-        __builtin_prefetch(mems[watches[at].num].base_ptr + watches[at].offset);
+        if (watches[at].alloc != 0) {
+            __builtin_prefetch(mems[watches[at].num].base_ptr + watches[at].offset);
+        }
     }
 
     struct iterator
@@ -385,11 +457,6 @@ struct watch_array
     {
         return const_iterator(watches.end(), this);
     }
-
-    void fitToSize()
-    {
-        //TODO shirnk
-    }
 };
 
 inline size_t operator-(const watch_array::iterator& lhs, const watch_array::iterator& rhs)
@@ -404,10 +471,17 @@ inline size_t operator-(const watch_array::const_iterator& lhs, const watch_arra
 
 inline Watched& watch_subarray::operator[](const uint32_t at)
 {
-    //base_at->accessed++;
     return *(begin() + at);
 }
 
+inline Watched& watch_subarray::at(const uint32_t at)
+{
+    if (at >= size()) {
+        throw std::out_of_range("watch_subarray::at");
+    }
+    return operator[](at);
+}
+
 inline void watch_subarray::clear()
 {
     base_at->size = 0;
@@ -425,6 +499,9 @@ inline bool watch_subarray::empty() const
 
 inline Watched* watch_subarray::begin()
 {
+    if (base_at->alloc == 0)
+        return NULL;
+
     return base->mems[base_at->num].base_ptr + base_at->offset;
 }
 
@@ -435,6 +512,9 @@ inline Watched* watch_subarray::end()
 
 inline const Watched* watch_subarray::begin() const
 {
+    if (base_at->alloc == 0)
+        return NULL;
+
     return base->mems[base_at->num].base_ptr + base_at->offset;
 }
 
@@ -456,13 +536,18 @@ inline void watch_subarray::shrink_(const uint32_t num)
 inline void watch_subarray::get_space_for_push()
 {
     uint32_t new_alloc = std::max<uint32_t>(base_at->alloc*2, 2U);
+    if (base->grow_in_place(*base_at, new_alloc))
+        return;
+
     OffsAndNum off_and_num = base->get_space(new_alloc);
 
     //Copy
     if (base_at->size > 0) {
         Watched* newptr = base->mems[off_and_num.num].base_ptr + off_and_num.offset;
         Watched* oldptr = begin();
-        memmove(newptr, oldptr, size() * sizeof(Watched));
+        memcpy(newptr, oldptr, size() * sizeof(Watched));
+    }
+    if (base_at->alloc > 0) {
         base->delete_offset(base_at->num, base_at->offset, base_at->alloc);
     }
 
@@ -478,12 +563,10 @@ inline void watch_subarray::push(const Watched& watched)
     if (base_at->alloc <= base_at->size) {
         get_space_for_push();
     }
-
-    //There is enough space
-    //assert(base_at->alloc > base_at->size);
+    assert(base_at->alloc > base_at->size);
 
     //Append to the end
-    operator[](size()) = watched;
+    *(begin() + size()) = watched;
     base_at->size++;
 }
 
@@ -491,6 +574,15 @@ inline const Watched& watch_subarray_const::operator[](const uint32_t at) const
 {
     return *(begin() + at);
 }
+
+inline const Watched& watch_subarray_const::at(const uint32_t at) const
+{
+    if (at >= size()) {
+        throw std::out_of_range("watch_subarray_const::at");
+    }
+    return operator[](at);
+}
+
 inline uint32_t watch_subarray_const::size() const
 {
     return base_at->size;
@@ -500,8 +592,12 @@ inline bool watch_subarray_const::empty() const
 {
     return size() == 0;
 }
+
 inline const Watched* watch_subarray_const::begin() const
 {
+    if (base_at->alloc == 0)
+        return NULL;
+
     return base->mems[base_at->num].base_ptr + base_at->offset;
 }
 
@@ -527,4 +623,4 @@ inline void swap(watch_subarray a, watch_subarray b)
 
 } //End of namespace
 
-#endif //__WATCHARRAY_H__
+#endif //__WATCHARRAY_HANDROLLED_H__
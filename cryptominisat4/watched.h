@@ -56,9 +56,8 @@ class Watched {
         */
         Watched(const ClOffset offset, Lit blockedLit) :
             data1(blockedLit.toInt())
-            , type(watch_clause_t)
-            , data2(offset)
         {
+            setNormOffset(offset);
         }
 
         /**
@@ -66,9 +65,8 @@ class Watched {
         */
         Watched(const ClOffset offset, CL_ABST_TYPE abst) :
             data1(abst)
-            , type(watch_clause_t)
-            , data2(offset)
         {
+            setNormOffset(offset);
         }
 
         Watched() :
@@ -96,12 +94,16 @@ class Watched {
         {
         }
 
+        /**
+        @brief Sets the offset of a >3-long clause, and marks the watch as one
+
+        data2 only has 30 bits, so the top bit of the offset (which picks the
+        ClauseAllocator arena) is kept in the otherwise unused type value
+        */
         void setNormOffset(const ClOffset offset)
         {
-            #ifdef DEBUG_WATCHED
-            assert(type == watch_clause_t);
-            #endif
-            data2 = offset;
+            type = (offset >> 30) ? watch_clause_high_t : (uint32_t)watch_clause_t;
+            data2 = offset & ((1U << 30)-1);
         }
 
         /**
@@ -110,7 +112,7 @@ class Watched {
         void setBlockedLit(const Lit blockedLit)
         {
             #ifdef DEBUG_WATCHED
-            assert(type == watch_clause_t);
+            assert(isClause());
             #endif
             data1 = blockedLit.toInt();
         }
@@ -132,7 +134,7 @@ class Watched {
 
         bool isClause() const
         {
-            return (type == watch_clause_t);
+            return (type == watch_clause_t || type == watch_clause_high_t);
         }
 
         bool isTri() const
@@ -230,7 +232,7 @@ class Watched {
             #ifdef DEBUG_WATCHED
             assert(isClause());
             #endif
-            return data2;
+            return data2 | ((ClOffset)(type == watch_clause_high_t) << 30);
         }
 
         bool operator==(const Watched& other) const
@@ -297,6 +299,9 @@ class Watched {
         }
 
     private:
+        //Type of a >3-long clause whose offset has its top bit set
+        static const uint32_t watch_clause_high_t = 3;
+
         uint32_t data1;
         //binary, tertiary or long, as per WatchType
         uint32_t type:2;
@@ -0,0 +1,164 @@
+/*
+ * CryptoMiniSat
+ *
+ * Copyright (c) 2009-2013, Mate Soos. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.0 of the License.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+*/
+
+#ifndef __XOR_H__
+#define __XOR_H__
+
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include "solvertypes.h"
+
+namespace CMSat {
+
+using std::vector;
+
+class Xor
+{
+    public:
+        Xor(const vector<Lit>& cl, const bool _rhs) :
+            rhs(_rhs)
+        {
+            for (uint32_t i = 0; i < cl.size(); i++) {
+                vars.push_back(cl[i].var());
+            }
+            std::sort(vars.begin(), vars.end());
+        }
+
+        Xor(const vector<Var>& _vars, const bool _rhs) :
+            vars(_vars)
+            , rhs(_rhs)
+        {
+            std::sort(vars.begin(), vars.end());
+        }
+
+        bool operator==(const Xor& other) const
+        {
+            return (rhs == other.rhs && vars == other.vars);
+        }
+
+        vector<Var> vars;
+        bool rhs;
+};
+
+inline std::ostream& operator<<(std::ostream& os, const Xor& thisXor)
+{
+    for (uint32_t i = 0; i < thisXor.vars.size(); i++) {
+        os << Lit(thisXor.vars[i], false);
+
+        if (i+1 < thisXor.vars.size())
+            os << " + ";
+    }
+    os << " =  " << std::boolalpha << thisXor.rhs << std::noboolalpha;
+
+    return os;
+}
+
+/**
+@brief Flat storage for many XORs, without an allocation for each of them
+
+Every XOR is a header word followed by its variables. The header holds the
+size, whether the XOR is only stored here and not also as CNF, and the
+right-hand side. XORs are referred to by the offset of their header.
+*/
+class XorArena
+{
+    public:
+        uint32_t add(const vector<Var>& vars, const bool rhs, const bool native)
+        {
+            const uint32_t offset = data.size();
+            data.push_back((uint32_t)vars.size() << 2 | (uint32_t)native << 1 | (uint32_t)rhs);
+            data.insert(data.end(), vars.begin(), vars.end());
+            num++;
+
+            return offset;
+        }
+
+        uint32_t size(const uint32_t offset) const
+        {
+            return data[offset] >> 2;
+        }
+
+        bool native(const uint32_t offset) const
+        {
+            return data[offset] & 2U;
+        }
+
+        bool rhs(const uint32_t offset) const
+        {
+            return data[offset] & 1U;
+        }
+
+        Var* vars(const uint32_t offset)
+        {
+            return data.data() + offset + 1;
+        }
+
+        const Var* vars(const uint32_t offset) const
+        {
+            return data.data() + offset + 1;
+        }
+
+        //Go through with: for(at = begin(); at != end(); at = next(at))
+        uint32_t begin() const
+        {
+            return 0;
+        }
+
+        uint32_t end() const
+        {
+            return data.size();
+        }
+
+        uint32_t next(const uint32_t offset) const
+        {
+            return offset + 1 + size(offset);
+        }
+
+        size_t num_xors() const
+        {
+            return num;
+        }
+
+        bool empty() const
+        {
+            return num == 0;
+        }
+
+        void clear()
+        {
+            data.clear();
+            num = 0;
+        }
+
+        size_t memUsed() const
+        {
+            return data.capacity()*sizeof(uint32_t);
+        }
+
+    private:
+        vector<uint32_t> data;
+        size_t num = 0;
+};
+
+} //end namespace
+
+#endif //__XOR_H__
@@ -133,6 +133,19 @@ bool XorFinder::findXors()
         }
     }
 
+    //Keep them for Gauss-Jordan elimination during search
+    if (solver->conf.doGauss) {
+        solver->foundXors.clear();
+        vector<Var> outerVars;
+        for(const Xor& x: xors) {
+            outerVars.clear();
+            for(const Var var: x.vars) {
+                outerVars.push_back(solver->map_inter_to_outer(var));
+            }
+            solver->foundXors.push_back(Xor(outerVars, x.rhs));
+        }
+    }
+
     if (solver->conf.doEchelonizeXOR && xors.size() > 0) {
         extractInfo();
     }
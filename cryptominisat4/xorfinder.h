@@ -30,6 +30,7 @@
 #include "cset.h"
 #include "xorfinderabst.h"
 #include "watcharray.h"
+#include "xor.h"
 
 namespace CMSat {
 
@@ -41,40 +42,6 @@ using std::set;
 class Solver;
 class Simplifier;
 
-class Xor
-{
-    public:
-        Xor(const vector<Lit>& cl, const bool _rhs) :
-            rhs(_rhs)
-        {
-            for (uint32_t i = 0; i < cl.size(); i++) {
-                vars.push_back(cl[i].var());
-            }
-            std::sort(vars.begin(), vars.end());
-        }
-
-        bool operator==(const Xor& other) const
-        {
-            return (rhs == other.rhs && vars == other.vars);
-        }
-
-        vector<Var> vars;
-        bool rhs;
-};
-
-inline std::ostream& operator<<(std::ostream& os, const Xor& thisXor)
-{
-    for (uint32_t i = 0; i < thisXor.vars.size(); i++) {
-        os << Lit(thisXor.vars[i], false);
-
-        if (i+1 < thisXor.vars.size())
-            os << " + ";
-    }
-    os << " =  " << std::boolalpha << thisXor.rhs << std::noboolalpha;
-
-    return os;
-}
-
 class FoundXors
 {
     public:
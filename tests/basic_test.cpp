@@ -4,6 +4,10 @@
 #include "cryptominisat4/cryptominisat.h"
 using namespace CMSat;
 #include <vector>
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <string>
 using std::vector;
 
 BOOST_AUTO_TEST_SUITE( normal_interface )
@@ -47,6 +51,45 @@ BOOST_AUTO_TEST_CASE(multi_solve_unsat)
         BOOST_CHECK_EQUAL( ret, l_False);
     }
 }
+
+BOOST_AUTO_TEST_CASE(add_clauses_batch)
+{
+    SATSolver s;
+    s.new_var();
+    s.new_var();
+    s.new_var();
+    s.add_clauses(vector<Lit>{
+        Lit(0, false), Lit(1, false), lit_Undef
+        , Lit(0, true), lit_Undef
+        , Lit(1, true), Lit(2, false), lit_Undef
+    });
+    lbool ret = s.solve();
+    BOOST_CHECK_EQUAL( ret, l_True);
+    BOOST_CHECK_EQUAL( s.get_model()[0], l_False);
+    BOOST_CHECK_EQUAL( s.get_model()[1], l_True);
+    BOOST_CHECK_EQUAL( s.get_model()[2], l_True);
+
+    s.add_clauses(vector<Lit>{Lit(2, true), lit_Undef});
+    ret = s.solve();
+    BOOST_CHECK_EQUAL( ret, l_False);
+}
+
+BOOST_AUTO_TEST_CASE(new_vars_bulk)
+{
+    SATSolver s;
+    s.new_vars(1000);
+    BOOST_CHECK_EQUAL( s.nVars(), 1000u);
+    s.new_var();
+    BOOST_CHECK_EQUAL( s.nVars(), 1001u);
+    s.add_clauses(vector<Lit>{
+        Lit(999, false), lit_Undef
+        , Lit(999, true), Lit(1000, true), lit_Undef
+    });
+    lbool ret = s.solve();
+    BOOST_CHECK_EQUAL( ret, l_True);
+    BOOST_CHECK_EQUAL( s.get_model()[999], l_True);
+    BOOST_CHECK_EQUAL( s.get_model()[1000], l_False);
+}
 BOOST_AUTO_TEST_SUITE_END()
 
 
@@ -301,6 +344,522 @@ BOOST_AUTO_TEST_CASE(xor_very_long2)
 
 BOOST_AUTO_TEST_SUITE_END()
 
+BOOST_AUTO_TEST_SUITE( gauss_interface )
+
+BOOST_AUTO_TEST_CASE(gauss_random_sat)
+{
+    SolverConf conf;
+    conf.doGauss = true;
+    SATSolver s(conf);
+    const unsigned num = 60;
+    for(unsigned i = 0; i < num; i++) {
+        s.new_var();
+    }
+
+    //Random XORs that are satisfied by a planted assignment
+    vector<vector<Var> > xors;
+    vector<bool> rhses;
+    uint32_t seed = 1;
+    for(unsigned i = 0; i < num-5; i++) {
+        vector<Var> vars;
+        bool rhs = false;
+        while(vars.size() < 3) {
+            seed = seed*1103515245U + 12345U;
+            const Var var = (seed >> 8) % num;
+            if (std::find(vars.begin(), vars.end(), var) == vars.end()) {
+                vars.push_back(var);
+                rhs ^= var % 3 == 0;
+            }
+        }
+        s.add_xor_clause(vars, rhs);
+        xors.push_back(vars);
+        rhses.push_back(rhs);
+    }
+
+    lbool ret = s.solve();
+    BOOST_CHECK_EQUAL( ret, l_True);
+    for(size_t i = 0; i < xors.size(); i++) {
+        bool val = false;
+        for(const Var var: xors[i]) {
+            val ^= s.get_model()[var] == l_True;
+        }
+        BOOST_CHECK_EQUAL( val, rhses[i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(gauss_unsat)
+{
+    SolverConf conf;
+    conf.doGauss = true;
+    SATSolver s(conf);
+    for(unsigned i = 0; i < 4; i++) {
+        s.new_var();
+    }
+    s.add_xor_clause(vector<Var>{0U, 1U, 2U}, true);
+    s.add_xor_clause(vector<Var>{1U, 2U, 3U}, true);
+    s.add_xor_clause(vector<Var>{0U, 3U}, true);
+    lbool ret = s.solve();
+    BOOST_CHECK_EQUAL( ret, l_False);
+}
+
+BOOST_AUTO_TEST_CASE(gauss_assumps)
+{
+    SolverConf conf;
+    conf.doGauss = true;
+    SATSolver s(conf);
+    for(unsigned i = 0; i < 10; i++) {
+        s.new_var();
+    }
+    for(unsigned i = 0; i < 8; i++) {
+        s.add_xor_clause(vector<Var>{i, i+1, i+2}, false);
+    }
+
+    //x0 and x1 fix all the others
+    vector<Lit> assumps{Lit(0, false), Lit(1, true)};
+    lbool ret = s.solve(&assumps);
+    BOOST_CHECK_EQUAL( ret, l_True);
+    BOOST_CHECK_EQUAL( s.get_model()[7], l_False);
+    BOOST_CHECK_EQUAL( s.get_model()[9], l_True);
+
+    assumps.push_back(Lit(9, true));
+    ret = s.solve(&assumps);
+    BOOST_CHECK_EQUAL( ret, l_False);
+
+    ret = s.solve();
+    BOOST_CHECK_EQUAL( ret, l_True);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( nativexor_interface )
+
+BOOST_AUTO_TEST_CASE(nativexor_long_sat)
+{
+    SolverConf conf;
+    conf.doNativeXor = true;
+    conf.doGauss = false;
+    SATSolver s(conf);
+    const unsigned num = 100;
+    for(unsigned i = 0; i < num; i++) {
+        s.new_var();
+    }
+
+    //Overlapping long XORs, and clauses that force the vars to be searched
+    vector<vector<Var> > xors;
+    vector<bool> rhses;
+    for(unsigned i = 0; i + 10 <= num; i += 5) {
+        vector<Var> vars;
+        for(unsigned k = i; k < i + 10; k++) {
+            vars.push_back(k);
+        }
+        s.add_xor_clause(vars, i % 3 == 0);
+        xors.push_back(vars);
+        rhses.push_back(i % 3 == 0);
+    }
+    for(unsigned i = 0; i + 1 < num; i += 2) {
+        s.add_clause(vector<Lit>{Lit(i, false), Lit(i+1, true)});
+    }
+
+    lbool ret = s.solve();
+    BOOST_CHECK_EQUAL( ret, l_True);
+    for(size_t i = 0; i < xors.size(); i++) {
+        bool val = false;
+        for(const Var var: xors[i]) {
+            val ^= s.get_model()[var] == l_True;
+        }
+        BOOST_CHECK_EQUAL( val, rhses[i]);
+    }
+    for(unsigned i = 0; i + 1 < num; i += 2) {
+        BOOST_CHECK( s.get_model()[i] == l_True || s.get_model()[i+1] == l_False);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(nativexor_unsat)
+{
+    SolverConf conf;
+    conf.doNativeXor = true;
+    conf.doGauss = false;
+    SATSolver s(conf);
+    for(unsigned i = 0; i < 12; i++) {
+        s.new_var();
+    }
+    s.add_xor_clause(vector<Var>{0U, 1U, 2U, 3U, 4U, 5U}, true);
+    s.add_xor_clause(vector<Var>{6U, 7U, 8U, 9U, 10U, 11U}, true);
+    s.add_xor_clause(vector<Var>{0U, 1U, 2U, 3U, 4U, 5U, 6U, 7U, 8U, 9U, 10U, 11U}, true);
+    lbool ret = s.solve();
+    BOOST_CHECK_EQUAL( ret, l_False);
+}
+
+BOOST_AUTO_TEST_CASE(nativexor_assumps)
+{
+    SolverConf conf;
+    conf.doNativeXor = true;
+    conf.doGauss = false;
+    SATSolver s(conf);
+    for(unsigned i = 0; i < 8; i++) {
+        s.new_var();
+    }
+    s.add_xor_clause(vector<Var>{0U, 1U, 2U, 3U, 4U, 5U, 6U, 7U}, false);
+
+    vector<Lit> assumps;
+    for(unsigned i = 0; i < 7; i++) {
+        assumps.push_back(Lit(i, i != 3));
+    }
+    lbool ret = s.solve(&assumps);
+    BOOST_CHECK_EQUAL( ret, l_True);
+    BOOST_CHECK_EQUAL( s.get_model()[7], l_True);
+
+    assumps.push_back(Lit(7, true));
+    ret = s.solve(&assumps);
+    BOOST_CHECK_EQUAL( ret, l_False);
+
+    ret = s.solve();
+    BOOST_CHECK_EQUAL( ret, l_True);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+//If 'unless' is given, the pigeons may stay out of the holes when it is true
+static void add_pigeonhole(SATSolver& s, unsigned holes, const Lit unless = lit_Undef)
+{
+    const unsigned pigeons = holes+1;
+    for(unsigned i = 0; i < pigeons*holes; i++) {
+        s.new_var();
+    }
+    while(unless != lit_Undef && s.nVars() <= unless.var()) {
+        s.new_var();
+    }
+
+    //Every pigeon is in some hole
+    for(unsigned p = 0; p < pigeons; p++) {
+        vector<Lit> cl;
+        for(unsigned h = 0; h < holes; h++) {
+            cl.push_back(Lit(p*holes + h, false));
+        }
+        if (unless != lit_Undef) {
+            cl.push_back(unless);
+        }
+        s.add_clause(cl);
+    }
+
+    //No two pigeons share a hole
+    for(unsigned h = 0; h < holes; h++) {
+        for(unsigned p1 = 0; p1 < pigeons; p1++) {
+            for(unsigned p2 = p1+1; p2 < pigeons; p2++) {
+                s.add_clause(vector<Lit>{
+                    Lit(p1*holes + h, true)
+                    , Lit(p2*holes + h, true)
+                });
+            }
+        }
+    }
+}
+
+//The value on the "c <name> : <value>" line of print_stats(), -1 if missing
+static double get_stat(const SATSolver& s, const std::string& name)
+{
+    std::stringstream out;
+    std::streambuf* orig = std::cout.rdbuf(out.rdbuf());
+    s.print_stats();
+    std::cout.rdbuf(orig);
+
+    std::string line;
+    while(std::getline(out, line)) {
+        const size_t colon = line.find(':');
+        if (colon == std::string::npos)
+            continue;
+
+        std::string key = line.substr(0, colon);
+        key.erase(key.find_last_not_of(' ') + 1);
+        if (key == "c " + name)
+            return std::stod(line.substr(colon + 1));
+    }
+    return -1;
+}
+
+BOOST_AUTO_TEST_SUITE( threads_interface )
+
+BOOST_AUTO_TEST_CASE(threads_sat)
+{
+    SATSolver s;
+    s.set_num_threads(4);
+    s.new_var();
+    s.new_var();
+    s.add_clause(vector<Lit>{Lit(0, false), Lit(1, false)});
+    s.add_clause(vector<Lit>{Lit(0, true)});
+    lbool ret = s.solve();
+    BOOST_CHECK_EQUAL( ret, l_True);
+    BOOST_CHECK_EQUAL( s.get_model()[0], l_False);
+    BOOST_CHECK_EQUAL( s.get_model()[1], l_True);
+}
+
+BOOST_AUTO_TEST_CASE(threads_unsat)
+{
+    SATSolver s;
+    s.set_num_threads(4);
+    add_pigeonhole(s, 5);
+    lbool ret = s.solve();
+    BOOST_CHECK_EQUAL( ret, l_False);
+}
+
+BOOST_AUTO_TEST_CASE(threads_multi_solve_assumps)
+{
+    SATSolver s;
+    s.set_num_threads(3);
+    s.new_var();
+    s.new_var();
+    s.add_clause(vector<Lit>{Lit(0, false), Lit(1, false)});
+    for(size_t i = 0; i < 5; i++) {
+        vector<Lit> assumps{Lit(0, true)};
+        lbool ret = s.solve(&assumps);
+        BOOST_CHECK_EQUAL( ret, l_True);
+        BOOST_CHECK_EQUAL( s.get_model()[1], l_True);
+
+        assumps.push_back(Lit(1, true));
+        ret = s.solve(&assumps);
+        BOOST_CHECK_EQUAL( ret, l_False);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(threads_share_small_ring)
+{
+    SolverConf conf;
+    conf.shareMaxSize = 10;
+    conf.shareMaxGlue = 10;
+    conf.shareRingSize = 16;
+    SATSolver s(conf);
+    s.set_num_threads(4);
+    add_pigeonhole(s, 6);
+    lbool ret = s.solve();
+    BOOST_CHECK_EQUAL( ret, l_False);
+}
+
+BOOST_AUTO_TEST_CASE(threads_cube_unsat)
+{
+    SolverConf conf;
+    conf.doCubeAndConquer = true;
+    SATSolver s(conf);
+    s.set_num_threads(4);
+    add_pigeonhole(s, 6);
+    lbool ret = s.solve();
+    BOOST_CHECK_EQUAL( ret, l_False);
+}
+
+BOOST_AUTO_TEST_CASE(threads_cube_assumps)
+{
+    SolverConf conf;
+    conf.doCubeAndConquer = true;
+    conf.cubeDepth = 3;
+    SATSolver s(conf);
+    s.set_num_threads(3);
+    for(size_t i = 0; i < 10; i++) {
+        s.new_var();
+    }
+    for(unsigned i = 0; i < 9; i++) {
+        s.add_clause(vector<Lit>{Lit(i, true), Lit(i+1, false)});
+    }
+
+    vector<Lit> assumps{Lit(0, false)};
+    lbool ret = s.solve(&assumps);
+    BOOST_CHECK_EQUAL( ret, l_True);
+    BOOST_CHECK_EQUAL( s.get_model()[9], l_True);
+
+    assumps.push_back(Lit(9, true));
+    ret = s.solve(&assumps);
+    BOOST_CHECK_EQUAL( ret, l_False);
+    BOOST_CHECK( !s.get_conflict().empty() );
+
+    //The conflict alone must be enough to make it UNSAT
+    vector<Lit> from_conflict;
+    for(const Lit lit: s.get_conflict()) {
+        from_conflict.push_back(~lit);
+    }
+    ret = s.solve(&from_conflict);
+    BOOST_CHECK_EQUAL( ret, l_False);
+}
+
+BOOST_AUTO_TEST_CASE(threads_cube_assumps_failed_lit)
+{
+    SolverConf conf;
+    conf.doCubeAndConquer = true;
+    conf.cubeDepth = 3;
+    SATSolver s(conf);
+    s.set_num_threads(3);
+
+    //Only UNSAT under the assumption: it makes 'd' a failed literal during
+    //lookahead, and with 'd' false the pigeons must all find a hole
+    const unsigned holes = 4;
+    const Lit d = Lit(holes*(holes+1), false);
+    const Lit a = Lit(holes*(holes+1)+1, false);
+    const Lit e = Lit(holes*(holes+1)+2, false);
+    add_pigeonhole(s, holes, d);
+    s.new_var();
+    s.new_var();
+    s.add_clause(vector<Lit>{~a, ~d, e});
+    s.add_clause(vector<Lit>{~a, ~d, ~e});
+
+    vector<Lit> assumps{a};
+    lbool ret = s.solve(&assumps);
+    BOOST_CHECK_EQUAL( ret, l_False);
+    const vector<Lit>& conflict = s.get_conflict();
+    BOOST_CHECK( std::find(conflict.begin(), conflict.end(), ~a) != conflict.end() );
+
+    vector<Lit> from_conflict;
+    for(const Lit lit: s.get_conflict()) {
+        from_conflict.push_back(~lit);
+    }
+    ret = s.solve(&from_conflict);
+    BOOST_CHECK_EQUAL( ret, l_False);
+
+    ret = s.solve();
+    BOOST_CHECK_EQUAL( ret, l_True);
+}
+
+BOOST_AUTO_TEST_CASE(threads_set_late)
+{
+    SATSolver s;
+    s.new_var();
+    BOOST_CHECK_THROW(s.set_num_threads(2), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( chrono_interface )
+
+BOOST_AUTO_TEST_CASE(chrono_backtracks)
+{
+    SolverConf conf;
+    conf.doChronoBT = true;
+    conf.chronoBTJump = 1;
+    conf.verbStats = 1;
+    SATSolver s(conf);
+    add_pigeonhole(s, 6);
+    lbool ret = s.solve();
+    BOOST_CHECK_EQUAL( ret, l_False);
+    BOOST_CHECK_GT( get_stat(s, "chrono backtracks"), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( membudget_interface )
+
+BOOST_AUTO_TEST_CASE(membudget_tiny_sheds)
+{
+    SolverConf conf;
+    conf.maxMemMB = 1;
+    conf.verbStats = 1;
+    SATSolver s(conf);
+
+    //Enough variables for the caches alone to go over the budget
+    const unsigned num = 20000;
+    s.new_vars(num);
+    for(unsigned i = 0; i+2 < num; i++) {
+        s.add_clause(vector<Lit>{Lit(i, false), Lit(i+1, false), Lit(i+2, false)});
+    }
+    lbool ret = s.solve();
+    BOOST_CHECK_EQUAL( ret, l_True);
+    BOOST_CHECK_GT(
+        get_stat(s, "dropped cache") + get_stat(s, "harder cleans")
+        , 0
+    );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( branch_interface )
+
+BOOST_AUTO_TEST_CASE(branch_vmtf_decides)
+{
+    SolverConf conf;
+    conf.branchStrategy = branch_vmtf;
+    conf.verbStats = 1;
+    SATSolver s(conf);
+    add_pigeonhole(s, 5);
+    lbool ret = s.solve();
+    BOOST_CHECK_EQUAL( ret, l_False);
+    BOOST_CHECK_GT( get_stat(s, "decisions by VMTF"), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+static bool planted_value(const Var var)
+{
+    return ((var*2654435761U) >> 16) & 1;
+}
+
+//Random 3-long clauses, kept only if a planted assignment satisfies them
+static void add_planted_3sat(SATSolver& s, const unsigned num, const unsigned num_cls)
+{
+    for(unsigned i = 0; i < num; i++) {
+        s.new_var();
+    }
+
+    uint32_t seed = 1;
+    unsigned added = 0;
+    while(added < num_cls) {
+        vector<Lit> cl;
+        bool sat = false;
+        for(unsigned i = 0; i < 3; i++) {
+            seed = seed*1103515245U + 12345U;
+            const Var var = (seed >> 8) % num;
+            seed = seed*1103515245U + 12345U;
+            const bool sign = (seed >> 8) & 1;
+            sat |= planted_value(var) != sign;
+            cl.push_back(Lit(var, sign));
+        }
+        if (sat) {
+            s.add_clause(cl);
+            added++;
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE( localsearch_interface )
+
+BOOST_AUTO_TEST_CASE(sls_finds_planted)
+{
+    SolverConf conf;
+    conf.doLocalSearch = true;
+    conf.localSearchEvery = 1;
+    conf.verbStats = 1;
+    SATSolver s(conf);
+    add_planted_3sat(s, 200, 840);
+
+    lbool ret = s.solve();
+    BOOST_CHECK_EQUAL( ret, l_True);
+    BOOST_CHECK_GT( get_stat(s, "models found"), 0);
+}
+
+BOOST_AUTO_TEST_CASE(sls_assumps)
+{
+    SolverConf conf;
+    conf.doLocalSearch = true;
+    conf.localSearchEvery = 1;
+    conf.verbStats = 1;
+    //Burst search would solve it before local search gets to run
+    conf.burstSearchLen = 0;
+    SATSolver s(conf);
+    add_planted_3sat(s, 200, 840);
+
+    //Local search must keep the assumed values
+    vector<Lit> assumps;
+    for(unsigned var = 0; var < 10; var++) {
+        assumps.push_back(Lit(var, !planted_value(var)));
+    }
+    lbool ret = s.solve(&assumps);
+    BOOST_CHECK_EQUAL( ret, l_True);
+    BOOST_CHECK_GT( get_stat(s, "models found"), 0);
+    for(const Lit lit: assumps) {
+        BOOST_CHECK_EQUAL( s.get_model()[lit.var()], lit.sign() ? l_False : l_True);
+    }
+
+    assumps.push_back(~assumps[0]);
+    ret = s.solve(&assumps);
+    BOOST_CHECK_EQUAL( ret, l_False);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
 /*struct F {
     F() : i( 1 ) { BOOST_TEST_MESSAGE( "setup fixture" ); }
     ~F()         { BOOST_TEST_MESSAGE( "teardown fixture" ); }
@@ -317,5 +876,3 @@ BOOST_FIXTURE_TEST_CASE( test_fix2, F)
 {
     BOOST_CHECK_EQUAL( i, 1 );
 }*/
-
-
@@ -0,0 +1,113 @@
+/*
+ * Microbenchmark of the scalar and the vectorised search for a non-false
+ * literal in long clauses, i.e. the search for a new watch while propagating.
+ *
+ * Usage: findnonfalse_bench [numVars] [iterations]
+ */
+
+#include "cryptominisat4/findnonfalse.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <vector>
+
+using namespace CMSat;
+using std::cout;
+using std::endl;
+using std::vector;
+
+struct Instance
+{
+    vector<lbool, GatherPaddedAllocator<lbool> > assigns;
+    vector<vector<Lit> > clauses;
+};
+
+//Every clause has all of its literals false, except possibly one at a random
+//position, just like the clauses visited in a long propagation chain
+static Instance make_instance(
+    const size_t numVars
+    , const size_t numClauses
+    , const size_t size
+    , std::mt19937& rnd
+) {
+    Instance inst;
+    for(size_t i = 0; i < numVars; i++) {
+        inst.assigns.push_back((rnd() & 1) ? l_True : l_False);
+    }
+
+    std::uniform_int_distribution<uint32_t> var_dist(0, numVars-1);
+    std::uniform_int_distribution<size_t> pos_dist(0, size);
+    for(size_t i = 0; i < numClauses; i++) {
+        vector<Lit> cl;
+        const size_t nonFalseAt = pos_dist(rnd);
+        for(size_t at = 0; at < size; at++) {
+            const Var var = var_dist(rnd);
+            const bool isFalse = (at != nonFalseAt);
+            const bool sign = (inst.assigns[var] == l_True) == isFalse;
+            cl.push_back(Lit(var, sign));
+        }
+        inst.clauses.push_back(cl);
+    }
+
+    return inst;
+}
+
+static double time_it(
+    NonFalseFinder finder
+    , Instance& inst
+    , const size_t iters
+    , uint64_t& checksum
+) {
+    const auto start = std::chrono::steady_clock::now();
+    for(size_t it = 0; it < iters; it++) {
+        for(vector<Lit>& cl: inst.clauses) {
+            Lit* begin = cl.data();
+            checksum += finder(begin, begin + cl.size(), inst.assigns.data()) - begin;
+        }
+    }
+    const std::chrono::duration<double, std::nano> took = std::chrono::steady_clock::now() - start;
+
+    return took.count() / (double)(iters*inst.clauses.size());
+}
+
+int main(int argc, char** argv)
+{
+    const size_t numVars = argc > 1 ? std::atol(argv[1]) : 1000000;
+    const size_t iters = argc > 2 ? std::atol(argv[2]) : 20;
+    const size_t numClauses = 20000;
+
+    NonFalseFinder scalar = get_non_false_finder(false);
+    NonFalseFinder simd = get_non_false_finder(true);
+    if (scalar == simd) {
+        cout << "CPU has no AVX2, both runs use the scalar version" << endl;
+    }
+
+    std::mt19937 rnd(42);
+    cout << std::setw(6) << "size"
+    << std::setw(14) << "scalar ns/cl"
+    << std::setw(14) << "simd ns/cl"
+    << std::setw(10) << "speedup"
+    << endl;
+    for(const size_t size: {8, 16, 24, 32, 48, 64, 100}) {
+        Instance inst = make_instance(numVars, numClauses, size, rnd);
+        uint64_t checkScalar = 0;
+        uint64_t checkSIMD = 0;
+        const double tScalar = time_it(scalar, inst, iters, checkScalar);
+        const double tSIMD = time_it(simd, inst, iters, checkSIMD);
+        if (checkScalar != checkSIMD) {
+            cout << "ERROR: the two versions found different literals" << endl;
+            return -1;
+        }
+
+        cout << std::setw(6) << size
+        << std::fixed << std::setprecision(1)
+        << std::setw(14) << tScalar
+        << std::setw(14) << tSIMD
+        << std::setw(9) << std::setprecision(2) << tScalar/tSIMD << "x"
+        << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,130 @@
+#define BOOST_TEST_MODULE dimacs_parser
+#include <boost/test/unit_test.hpp>
+
+#include "cryptominisat4/cryptominisat.h"
+#include "cryptominisat4/dimacsparser.h"
+#include "cryptominisat4/inputreader.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+using namespace CMSat;
+
+//Normal clauses, XORs and comments. No newline at the end.
+static std::string fixture(
+    const bool endWithXor
+    , const unsigned numLines = 300
+    , const unsigned numVars = 60
+) {
+    std::stringstream out;
+    out << "c parser regression fixture\n";
+    out << "p cnf " << numVars << " " << numLines << "\n";
+    for(unsigned i = 0; i < numLines; i++) {
+        const int a = 1 + (i*7) % numVars;
+        const int b = 1 + (i*13 + 5) % numVars;
+        const int c = 1 + (i*29 + 11) % numVars;
+        if (i % 10 == 3) {
+            out << "x" << a << " " << -b << " " << c << " 0\n";
+        } else if (i % 50 == 17) {
+            out << "c comment in the middle\n";
+        } else {
+            out << (i & 1 ? -a : a) << " " << b << " " << (i & 2 ? -c : c) << " 0\n";
+        }
+    }
+    if (endWithXor) {
+        out << "x1 2 -3 0";
+    } else {
+        out << "-1 -2 3 0";
+    }
+    return out.str();
+}
+
+static std::string dump_irred(const SATSolver& s, const std::string& fname)
+{
+    s.open_file_and_dump_irred_clauses(fname);
+    std::ifstream in(fname.c_str());
+    std::stringstream contents;
+    contents << in.rdbuf();
+    in.close();
+    std::remove(fname.c_str());
+    return contents.str();
+}
+
+//Small pieces, so that lines (and the last, unterminated one) straddle them
+static void check_same_as_single(const std::string& data)
+{
+    SATSolver single;
+    DimacsParser singleParser(&single, false);
+    singleParser.parse_DIMACS_parallel(data.data(), data.size(), 1);
+
+    SATSolver chunked;
+    DimacsParser chunkedParser(&chunked, false);
+    chunkedParser.parse_DIMACS_parallel(data.data(), data.size(), 4, 64);
+
+    BOOST_CHECK_EQUAL(single.nVars(), chunked.nVars());
+    const std::string singleDump = dump_irred(single, "parser_test_single.cnf");
+    BOOST_CHECK_NE(singleDump, "p cnf 0 1\n0\n"); //Not found UNSAT while adding
+    BOOST_CHECK_EQUAL(singleDump, dump_irred(chunked, "parser_test_chunked.cnf"));
+    BOOST_CHECK_EQUAL(single.solve(), chunked.solve());
+}
+
+//Through the reader thread, a few of its buffers long
+static void check_reader_same_as_single(const std::string& data, const bool compress)
+{
+    const std::string fname = "parser_test_input.cnf";
+    if (compress) {
+        #ifdef USE_ZLIB
+        gzFile out = gzopen(fname.c_str(), "wb");
+        BOOST_REQUIRE(out != NULL);
+        BOOST_REQUIRE_EQUAL(gzwrite(out, data.data(), data.size()), (int)data.size());
+        gzclose(out);
+        #endif
+    } else {
+        std::ofstream out(fname.c_str(), std::ios::binary);
+        out << data;
+    }
+
+    SATSolver single;
+    DimacsParser singleParser(&single, false);
+    singleParser.parse_DIMACS_parallel(data.data(), data.size(), 1);
+
+    SATSolver streamed;
+    {
+        InputReader reader;
+        BOOST_REQUIRE(reader.open(fname));
+        DimacsParser streamedParser(&streamed, false);
+        streamedParser.parse_DIMACS(&reader);
+    }
+    std::remove(fname.c_str());
+
+    BOOST_CHECK_EQUAL(single.nVars(), streamed.nVars());
+    const std::string singleDump = dump_irred(single, "parser_test_single.cnf");
+    BOOST_CHECK_NE(singleDump, "p cnf 0 1\n0\n"); //Not found UNSAT while adding
+    BOOST_CHECK_EQUAL(singleDump, dump_irred(streamed, "parser_test_streamed.cnf"));
+}
+
+BOOST_AUTO_TEST_SUITE( parallel_parse )
+
+BOOST_AUTO_TEST_CASE(chunked_same_as_single_clause_last)
+{
+    check_same_as_single(fixture(false));
+}
+
+BOOST_AUTO_TEST_CASE(chunked_same_as_single_xor_last)
+{
+    check_same_as_single(fixture(true));
+}
+
+BOOST_AUTO_TEST_CASE(reader_same_as_single)
+{
+    check_reader_same_as_single(fixture(true, 400000, 5000), false);
+}
+
+#ifdef USE_ZLIB
+BOOST_AUTO_TEST_CASE(reader_gzip_same_as_single)
+{
+    check_reader_same_as_single(fixture(false, 400000, 5000), true);
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,160 @@
+/*
+ * Benchmark of propagation through long clauses, when the clauses take up far
+ * more memory than the last-level cache. Reports propagations per second and,
+ * where the kernel allows it, the hardware cache misses per propagation.
+ *
+ * Usage: propagate_bench [numVars] [numClauses] [conflicts]
+ */
+
+#include "cryptominisat4/cryptominisat.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace CMSat;
+using std::cout;
+using std::endl;
+using std::vector;
+
+//Counts last-level cache misses of this thread, if the kernel lets us
+class CacheMissCounter
+{
+public:
+    CacheMissCounter()
+    {
+        #ifdef __linux__
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+        #endif
+    }
+
+    ~CacheMissCounter()
+    {
+        #ifdef __linux__
+        if (fd >= 0)
+            close(fd);
+        #endif
+    }
+
+    bool available() const
+    {
+        return fd >= 0;
+    }
+
+    void start()
+    {
+        #ifdef __linux__
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+        #endif
+    }
+
+    uint64_t stop()
+    {
+        uint64_t count = 0;
+        #ifdef __linux__
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd, &count, sizeof(count)) != sizeof(count))
+                count = 0;
+        }
+        #endif
+        return count;
+    }
+
+private:
+    int fd = -1;
+};
+
+//The value on the "c <name> : <value>" line of print_stats(), -1 if missing
+static double get_stat(const SATSolver& s, const std::string& name)
+{
+    std::stringstream out;
+    std::streambuf* orig = cout.rdbuf(out.rdbuf());
+    s.print_stats();
+    cout.rdbuf(orig);
+
+    std::string line;
+    while(std::getline(out, line)) {
+        const size_t colon = line.find(':');
+        if (colon == std::string::npos)
+            continue;
+
+        std::string key = line.substr(0, colon);
+        key.erase(key.find_last_not_of(' ') + 1);
+        if (key == "c " + name)
+            return std::stod(line.substr(colon + 1));
+    }
+    return -1;
+}
+
+int main(int argc, char** argv)
+{
+    const size_t numVars = argc > 1 ? std::atol(argv[1]) : 200000;
+    const size_t numClauses = argc > 2 ? std::atol(argv[2]) : 2500000;
+    const long conflicts = argc > 3 ? std::atol(argv[3]) : 3000;
+
+    //Simplification would change the clauses, only search is measured
+    SolverConf conf;
+    conf.maxConfl = conflicts;
+    conf.simplify_at_startup = false;
+    conf.perform_occur_based_simp = false;
+    conf.doProbe = false;
+    conf.verbStats = 1;
+    SATSolver s(conf);
+    s.new_vars(numVars);
+
+    //Random 5-long clauses, none of them handled by the implicit watches
+    std::mt19937 rnd(42);
+    std::uniform_int_distribution<uint32_t> var_dist(0, numVars-1);
+    vector<Lit> cl;
+    for(size_t i = 0; i < numClauses; i++) {
+        cl.clear();
+        for(unsigned at = 0; at < 5; at++) {
+            cl.push_back(Lit(var_dist(rnd), rnd() & 1));
+        }
+        s.add_clause(cl);
+    }
+
+    CacheMissCounter misses;
+    const auto start = std::chrono::steady_clock::now();
+    misses.start();
+    s.solve();
+    const uint64_t numMisses = misses.stop();
+    const std::chrono::duration<double> took = std::chrono::steady_clock::now() - start;
+
+    const double props = get_stat(s, "Mprops")*1000.0*1000.0;
+    cout << std::fixed << std::setprecision(2)
+    << "time: " << took.count() << " s" << endl
+    << "props: " << props/(1000.0*1000.0) << " M" << endl
+    << "props/sec: " << props/took.count()/(1000.0*1000.0) << " M" << endl;
+    if (misses.available()) {
+        cout << "cache misses/prop: " << (double)numMisses/props << endl;
+    } else {
+        cout << "cache misses/prop: not available (perf_event_open refused)" << endl;
+    }
+
+    return 0;
+}